@@ -12,7 +12,6 @@
 
 // Function declarations
 void main(void);
-int max_float_integer(double a, int b);
 double square_and_double_float(double x);
 int square_and_double_integer(int x);
 double max_float_float(double a, double b);
@@ -53,22 +52,13 @@ void main(void) {
     echo_print_string("Auto inference in action:");
     int x = 100;
     int y = 200;
-    double combined = add_integer_integer(x, y);
-    double bigger = max_integer_integer(combined, 500);
+    int combined = add_integer_integer(x, y);
+    int bigger = max_integer_integer(combined, 500);
     echo_print_int(bigger);
     echo_print_string("");
     echo_print_string("Generics allow code reuse across types!");
 }
 
-int max_float_integer(double a, int b) {
-    if (a > b) {
-        return a;
-    }
-    else {
-        return b;
-    }
-}
-
 double square_and_double_float(double x) {
     double squared = x * x;
     double result = squared * 2;
@@ -57,7 +57,7 @@ void main(void) {
     echo_print_int(middle);
     echo_print_string("");
     echo_print_string("Polymorphic usage:");
-    double result1 = min3_integer_integer_integer(100, 200, 150);
+    int result1 = min3_integer_integer_integer(100, 200, 150);
     double result2 = max3_float_float_float(1.1, 2.2, 1.8);
     echo_print_int(result1);
     echo_print_string("Max float calculated");
@@ -12,7 +12,6 @@
 
 // Function declarations
 void main(void);
-double add_integer_float(int a, double b);
 int factorial_integer(int n);
 int power_integer_integer(int base, int exp);
 int percentage_integer_integer(int value, int percent);
@@ -70,15 +69,15 @@ void main(void) {
     echo_print_int(fact_5);
     echo_print_string("");
     echo_print_string("Complex calculations:");
-    int complex1 = add_integer_float(square_integer(5), multiply_integer_integer(3, 4));
+    int complex1 = add_integer_integer(square_integer(5), multiply_integer_integer(3, 4));
     int complex2 = subtract_integer_integer(power_integer_integer(3, 3), factorial_integer(3));
     echo_print_int(complex1);
     echo_print_int(complex2);
     echo_print_string("");
     echo_print_string("Generic type flexibility:");
     int int_add = add_integer_integer(10, 20);
-    int float_add = add_float_float(1.5, 2.5);
-    double mixed_calc = multiply_integer_integer(divide_integer_integer(100, 4), 2);
+    double float_add = add_float_float(1.5, 2.5);
+    int mixed_calc = multiply_integer_integer(divide_integer_integer(100, 4), 2);
     echo_print_int(int_add);
     echo_print_string("Float addition completed");
     echo_print_int(mixed_calc);
@@ -94,10 +93,6 @@ void main(void) {
     echo_print_string("Calculator demo completed successfully!");
 }
 
-double add_integer_float(int a, double b) {
-    return a + b;
-}
-
 int factorial_integer(int n) {
     if (n <= 1) {
         return 1;
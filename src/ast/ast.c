@@ -1,8 +1,10 @@
 #define _GNU_SOURCE
 #include "ast.h"
+#include "../utils/string_intern.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
 
 // AST node type names for debugging
 const char* ast_node_type_names[] = {
@@ -16,40 +18,153 @@ const char* ast_node_type_names[] = {
     "AUTO_TYPE", "GENERIC_FUNCTION", "TEMPLATE_INSTANTIATION", "TYPE_PARAMETER"
 };
 
+// Arena that owns AST memory (NULL = lazily created default arena)
+static Arena* ast_arena = NULL;
+static Arena* ast_default_arena = NULL;
+
+// Open-addressing map from node id to a pointer, allocated from the AST arena.
+// Keys are stored as id + 1 so that 0 marks an empty slot.
+// Lookups take no lock: a slot's value is stored before its key, and a grown
+// slot array is filled before it is published (the old one stays valid in
+// the arena), so a reader finds either no entry or a complete one.
+typedef struct {
+    uint32_t* keys;
+    void** values;
+    size_t capacity;           // Power of two
+} ASTSideSlots;
+
+typedef struct {
+    ASTSideSlots* slots;       // NULL until the first entry
+    size_t count;              // Entries (ast_lock held)
+} ASTSideTable;
+
+#define AST_SIDE_TABLE_INITIAL 16
+
+static ASTSideTable ast_type_table;      // id -> data_type
+static ASTSideTable ast_generic_table;   // id -> ASTGenericInfo*
+static uint32_t ast_next_id = 0;
+
+// Guards the arena, ids and side table updates: semantic analysis workers
+// annotate and create nodes concurrently
+static pthread_mutex_t ast_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Forget all side table entries (their memory belongs to the old arena)
+static void ast_reset_side_tables(void) {
+    memset(&ast_type_table, 0, sizeof(ast_type_table));
+    memset(&ast_generic_table, 0, sizeof(ast_generic_table));
+    ast_next_id = 0;
+}
+
+static size_t side_table_slot(uint32_t id, size_t capacity) {
+    return (size_t)(id * 2654435761u) & (capacity - 1);
+}
+
+// Find value stored for id (NULL if none); no lock needed
+static void* side_table_get(ASTSideTable* table, uint32_t id) {
+    const ASTSideSlots* slots = __atomic_load_n(&table->slots, __ATOMIC_ACQUIRE);
+    if (!slots) return NULL;
+    
+    size_t slot = side_table_slot(id, slots->capacity);
+    uint32_t key;
+    while ((key = __atomic_load_n(&slots->keys[slot], __ATOMIC_ACQUIRE)) != 0) {
+        if (key == id + 1) return __atomic_load_n(&slots->values[slot], __ATOMIC_ACQUIRE);
+        slot = (slot + 1) & (slots->capacity - 1);
+    }
+    return NULL;
+}
+
+// Store the value for id without growing; the slots must have a free one.
+// Returns true if id was not present yet.
+static bool side_slots_store(ASTSideSlots* slots, uint32_t id, void* value) {
+    size_t slot = side_table_slot(id, slots->capacity);
+    while (slots->keys[slot] && slots->keys[slot] != id + 1) {
+        slot = (slot + 1) & (slots->capacity - 1);
+    }
+    
+    __atomic_store_n(&slots->values[slot], value, __ATOMIC_RELEASE);
+    if (slots->keys[slot]) return false;
+    
+    __atomic_store_n(&slots->keys[slot], id + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Insert or replace the value for id, growing at 3/4 load (ast_lock held)
+static bool side_table_put(ASTSideTable* table, uint32_t id, void* value) {
+    ASTSideSlots* slots = table->slots;
+    if (!slots || (table->count + 1) * 4 > slots->capacity * 3) {
+        Arena* arena = ast_current_arena();
+        ASTSideSlots* grown = arena_alloc(arena, sizeof(ASTSideSlots));
+        if (!grown) return false;
+        
+        grown->capacity = slots ? slots->capacity * 2 : AST_SIDE_TABLE_INITIAL;
+        grown->keys = arena_calloc(arena, grown->capacity, sizeof(uint32_t));
+        grown->values = arena_alloc(arena, grown->capacity * sizeof(void*));
+        if (!grown->keys || !grown->values) return false;
+        
+        for (size_t i = 0; slots && i < slots->capacity; i++) {
+            if (slots->keys[i]) {
+                side_slots_store(grown, slots->keys[i] - 1, slots->values[i]);
+            }
+        }
+        __atomic_store_n(&table->slots, grown, __ATOMIC_RELEASE);
+        slots = grown;
+    }
+    
+    if (side_slots_store(slots, id, value)) table->count++;
+    return true;
+}
+
+// Memory reserved by a side table
+static size_t side_table_bytes(const ASTSideTable* table) {
+    return table->slots ? table->slots->capacity * (sizeof(uint32_t) + sizeof(void*)) : 0;
+}
+
+// Route subsequent AST allocations to arena
+void ast_use_arena(Arena* arena) {
+    if (arena != ast_arena) {
+        ast_reset_side_tables();
+    }
+    ast_arena = arena;
+}
+
+// Get the arena AST allocations currently go to
+Arena* ast_current_arena(void) {
+    if (ast_arena) return ast_arena;
+    
+    if (!ast_default_arena) {
+        ast_default_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    }
+    return ast_default_arena;
+}
+
 // Create a new AST node
 ASTNode* ast_create_node(ASTNodeType type, const char* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    const char* interned = intern_string(value);
+    
+    pthread_mutex_lock(&ast_lock);
+    ASTNode* node = arena_alloc(ast_current_arena(), sizeof(ASTNode));
+    uint32_t id = ast_next_id++;
+    pthread_mutex_unlock(&ast_lock);
     if (!node) return NULL;
     
-    node->type = type;
-    node->value = value ? strdup(value) : NULL;
+    node->value = interned;
     node->children = NULL;
     node->child_count = 0;
-    node->child_capacity = 0;
-    node->line = 0;
-    node->column = 0;
-    node->data_type = NULL;
-    node->is_pointer = false;
-    node->is_optional = false;
-    node->is_array = false;
-    
-    // Initialize generics fields
-    node->is_generic = false;
-    node->is_auto = false;
-    node->type_parameters = NULL;
-    node->inferred_types = NULL;
-    node->type_param_count = 0;
-    node->generic_template = NULL;
-    node->instantiation_key = NULL;
+    node->id = id;
+    node->location = 0;
+    node->type = (uint8_t)type;
+    node->flags = 0;
+    node->op = OP_NONE;
     
     return node;
 }
 
 // Create binary operation node
-ASTNode* ast_create_binary_op(const char* op, ASTNode* left, ASTNode* right) {
-    ASTNode* node = ast_create_node(AST_BINARY_OP, op);
+ASTNode* ast_create_binary_op(OperatorId op, ASTNode* left, ASTNode* right) {
+    ASTNode* node = ast_create_node(AST_BINARY_OP, NULL);
     if (!node) return NULL;
     
+    node->op = (uint8_t)op;
     ast_add_child(node, left);
     ast_add_child(node, right);
     
@@ -57,15 +172,28 @@ ASTNode* ast_create_binary_op(const char* op, ASTNode* left, ASTNode* right) {
 }
 
 // Create unary operation node
-ASTNode* ast_create_unary_op(const char* op, ASTNode* operand) {
-    ASTNode* node = ast_create_node(AST_UNARY_OP, op);
+ASTNode* ast_create_unary_op(OperatorId op, ASTNode* operand) {
+    ASTNode* node = ast_create_node(AST_UNARY_OP, NULL);
     if (!node) return NULL;
     
+    node->op = (uint8_t)op;
     ast_add_child(node, operand);
     
     return node;
 }
 
+// Create assignment node (also a field initializer, with OP_COLON)
+ASTNode* ast_create_assignment(OperatorId op, ASTNode* target, ASTNode* value) {
+    ASTNode* node = ast_create_node(AST_ASSIGNMENT, NULL);
+    if (!node) return NULL;
+    
+    node->op = (uint8_t)op;
+    ast_add_child(node, target);
+    ast_add_child(node, value);
+    
+    return node;
+}
+
 // Create function node
 ASTNode* ast_create_function(const char* name, ASTNode* params, ASTNode* return_type, ASTNode* body) {
     ASTNode* node = ast_create_node(AST_FUNCTION, name);
@@ -84,7 +212,7 @@ ASTNode* ast_create_literal(const char* value, const char* type) {
     if (!node) return NULL;
     
     if (type) {
-        node->data_type = strdup(type);
+        ast_set_data_type(node, type);
     }
     
     return node;
@@ -99,72 +227,89 @@ ASTNode* ast_create_identifier(const char* name) {
 void ast_add_child(ASTNode* parent, ASTNode* child) {
     if (!parent || !child) return;
     
-    // Resize children array if needed
-    if (parent->child_count >= parent->child_capacity) {
-        int new_capacity = parent->child_capacity == 0 ? 4 : parent->child_capacity * 2;
-        ASTNode** new_children = realloc(parent->children, new_capacity * sizeof(ASTNode*));
+    // Resize children array when it is full: capacity is 4, 8, 16, ...
+    int count = parent->child_count;
+    if (count == 0 || (count >= 4 && (count & (count - 1)) == 0)) {
+        int new_capacity = count == 0 ? 4 : count * 2;
+        pthread_mutex_lock(&ast_lock);
+        ASTNode** new_children = arena_realloc(ast_current_arena(), parent->children,
+                                               count * sizeof(ASTNode*),
+                                               new_capacity * sizeof(ASTNode*));
+        pthread_mutex_unlock(&ast_lock);
         if (!new_children) return;
         
         parent->children = new_children;
-        parent->child_capacity = new_capacity;
     }
     
     parent->children[parent->child_count++] = child;
 }
 
 // Set position information
-void ast_set_position(ASTNode* node, int line, int column) {
+void ast_set_location(ASTNode* node, uint32_t location) {
     if (!node) return;
-    node->line = line;
-    node->column = column;
+    
+    node->location = location;
 }
 
 // Set type information
 void ast_set_type_info(ASTNode* node, const char* type, bool is_pointer, bool is_optional) {
     if (!node) return;
     
-    if (node->data_type) {
-        free(node->data_type);
-    }
-    node->data_type = type ? strdup(type) : NULL;
-    node->is_pointer = is_pointer;
-    node->is_optional = is_optional;
+    ast_set_data_type(node, type);
+    ast_set_flag(node, AST_FLAG_POINTER, is_pointer);
+    ast_set_flag(node, AST_FLAG_OPTIONAL, is_optional);
 }
 
-// Destroy AST node and all children
-void ast_destroy(ASTNode* node) {
+// Get type annotation
+const char* ast_data_type(const ASTNode* node) {
+    if (!node) return NULL;
+    
+    return side_table_get(&ast_type_table, node->id);
+}
+
+// Set type annotation
+void ast_set_data_type(ASTNode* node, const char* type) {
     if (!node) return;
     
-    // Destroy all children
-    for (int i = 0; i < node->child_count; i++) {
-        ast_destroy(node->children[i]);
-    }
+    const char* interned = intern_string(type);
     
-    // Free generics memory
-    if (node->type_parameters) {
-        for (int i = 0; i < node->type_param_count; i++) {
-            free(node->type_parameters[i]);
-        }
-        free(node->type_parameters);
+    pthread_mutex_lock(&ast_lock);
+    if (interned || side_table_get(&ast_type_table, node->id)) {
+        side_table_put(&ast_type_table, node->id, (void*)interned);
     }
+    pthread_mutex_unlock(&ast_lock);
+}
+
+// Get generics data (NULL if the node has none)
+ASTGenericInfo* ast_generic_info(const ASTNode* node) {
+    if (!node) return NULL;
     
-    if (node->inferred_types) {
-        for (int i = 0; i < node->type_param_count; i++) {
-            free(node->inferred_types[i]);
-        }
-        free(node->inferred_types);
-    }
+    return side_table_get(&ast_generic_table, node->id);
+}
+
+// Get generics data, creating an empty record on first use
+ASTGenericInfo* ast_generic_info_create(ASTNode* node) {
+    if (!node) return NULL;
     
-    // Free memory
-    free(node->value);
-    free(node->data_type);
-    free(node->instantiation_key);
-    free(node->children);
-    free(node);
+    pthread_mutex_lock(&ast_lock);
+    ASTGenericInfo* info = side_table_get(&ast_generic_table, node->id);
+    if (!info) {
+        info = arena_calloc(ast_current_arena(), 1, sizeof(ASTGenericInfo));
+        if (info && !side_table_put(&ast_generic_table, node->id, info)) info = NULL;
+    }
+    pthread_mutex_unlock(&ast_lock);
+    return info;
 }
 
-// Print AST for debugging
-void ast_print(ASTNode* node, int indent) {
+// Destroy AST node and all children.
+// Nodes are arena-owned, so this releases nothing by itself; the memory is
+// reclaimed in bulk when the AST arena is destroyed.
+void ast_destroy(ASTNode* node) {
+    (void)node;
+}
+
+// Print AST for debugging (positions need the line index of the node's file)
+void ast_print(ASTNode* node, int indent, const LineIndex* lines) {
     if (!node) return;
     
     // Print indentation
@@ -174,24 +319,28 @@ void ast_print(ASTNode* node, int indent) {
     
     // Print node info
     printf("%s", ast_node_type_names[node->type]);
-    if (node->value) {
-        printf(" \"%s\"", node->value);
+    const char* value = node->op != OP_NONE ? operator_to_string((OperatorId)node->op) : node->value;
+    if (value) {
+        printf(" \"%s\"", value);
     }
-    if (node->data_type) {
-        printf(" (%s", node->data_type);
-        if (node->is_pointer) printf("*");
-        if (node->is_optional) printf("?");
-        if (node->is_array) printf("[]");
+    const char* data_type = ast_data_type(node);
+    if (data_type) {
+        printf(" (%s", data_type);
+        if (ast_has_flag(node, AST_FLAG_POINTER)) printf("*");
+        if (ast_has_flag(node, AST_FLAG_OPTIONAL)) printf("?");
+        if (ast_has_flag(node, AST_FLAG_ARRAY)) printf("[]");
         printf(")");
     }
-    if (node->line > 0) {
-        printf(" [%d:%d]", node->line, node->column);
+    if (lines && node->location != SOURCE_LOCATION_NONE) {
+        int line, column;
+        line_index_position(lines, node->location, &line, &column);
+        printf(" [%d:%d]", line, column);
     }
     printf("\n");
     
     // Print children
     for (int i = 0; i < node->child_count; i++) {
-        ast_print(node->children[i], indent + 1);
+        ast_print(node->children[i], indent + 1, lines);
     }
 }
 
@@ -201,10 +350,13 @@ ASTNode* ast_find_function(ASTNode* program, const char* name) {
         return NULL;
     }
     
+    // A name that was never interned cannot be a function name
+    const char* interned = intern_lookup(name);
+    if (!interned) return NULL;
+    
     for (int i = 0; i < program->child_count; i++) {
         ASTNode* child = program->children[i];
-        if (child->type == AST_FUNCTION && child->value && 
-            strcmp(child->value, name) == 0) {
+        if (child->type == AST_FUNCTION && child->value == interned) {
             return child;
         }
     }
@@ -225,13 +377,92 @@ ASTNode* ast_get_child(ASTNode* node, int index) {
     return node->children[index];
 }
 
+// ================== MEMORY STATISTICS ==================
+
+// Node layout before the type annotation and generics fields moved to side
+// tables; only used to report the difference in ast_print_memory_stats()
+typedef struct {
+    ASTNodeType type;
+    const char* value;
+    ASTNode** children;
+    int child_count;
+    int child_capacity;
+    int line;
+    int column;
+    const char* data_type;
+    bool is_pointer;
+    bool is_optional;
+    bool is_array;
+    bool is_generic;
+    bool is_auto;
+    const char** type_parameters;
+    const char** inferred_types;
+    int type_param_count;
+    ASTNode* generic_template;
+    const char* instantiation_key;
+} ASTLegacyNode;
+
+typedef struct {
+    size_t nodes;
+    size_t child_bytes;        // Children arrays (same in both layouts)
+    size_t generic_bytes;      // Generics arrays (same in both layouts)
+} ASTMemoryCounts;
+
+static void ast_count_memory(ASTNode* node, ASTMemoryCounts* counts) {
+    if (!node) return;
+    
+    counts->nodes++;
+    if (node->child_count > 0) {
+        size_t capacity = 4;
+        while (capacity < (size_t)node->child_count) capacity *= 2;
+        counts->child_bytes += capacity * sizeof(ASTNode*);
+    }
+    
+    ASTGenericInfo* info = ast_generic_info(node);
+    if (info) {
+        counts->generic_bytes += info->type_param_count * sizeof(const char*);
+    }
+    
+    for (int i = 0; i < node->child_count; i++) {
+        ast_count_memory(node->children[i], counts);
+    }
+}
+
+// Print bytes per node for the legacy and the compact layout
+void ast_print_memory_stats(ASTNode* root) {
+    ASTMemoryCounts counts = {0, 0, 0};
+    ast_count_memory(root, &counts);
+    if (counts.nodes == 0) {
+        printf("AST memory: empty tree\n");
+        return;
+    }
+    
+    size_t info_bytes = ast_generic_table.count * sizeof(ASTGenericInfo);
+    size_t side_bytes = side_table_bytes(&ast_type_table) + side_table_bytes(&ast_generic_table) + info_bytes;
+    size_t shared = counts.child_bytes + counts.generic_bytes;
+    size_t before = counts.nodes * sizeof(ASTLegacyNode) + shared;
+    size_t after = counts.nodes * sizeof(ASTNode) + side_bytes + shared;
+    
+    printf("AST memory statistics\n");
+    printf("  nodes:              %zu\n", counts.nodes);
+    printf("  node size:          %zu -> %zu bytes\n", sizeof(ASTLegacyNode), sizeof(ASTNode));
+    printf("  type annotations:   %zu (side table %zu bytes)\n",
+           ast_type_table.count, side_table_bytes(&ast_type_table));
+    printf("  generics records:   %zu (side table %zu bytes)\n",
+           ast_generic_table.count, side_table_bytes(&ast_generic_table) + info_bytes);
+    printf("  child arrays:       %zu bytes\n", counts.child_bytes);
+    printf("  bytes per node:     %.1f -> %.1f\n",
+           (double)before / counts.nodes, (double)after / counts.nodes);
+    printf("  arena used:         %zu bytes\n", arena_bytes_used(ast_current_arena()));
+}
+
 // ================== GENERICS SUPPORT FUNCTIONS ==================
 
 // Create auto type node
 ASTNode* ast_create_auto_type(void) {
     ASTNode* node = ast_create_node(AST_AUTO_TYPE, "auto");
     if (node) {
-        node->is_auto = true;
+        ast_set_flag(node, AST_FLAG_AUTO, true);
     }
     return node;
 }
@@ -242,7 +473,7 @@ ASTNode* ast_create_generic_function(const char* name, ASTNode* type_params, AST
     ASTNode* node = ast_create_node(AST_GENERIC_FUNCTION, name);
     if (!node) return NULL;
     
-    node->is_generic = true;
+    ast_set_flag(node, AST_FLAG_GENERIC, true);
     
     // Add type parameters, regular parameters, return type, and body as children
     if (type_params) ast_add_child(node, type_params);
@@ -260,31 +491,34 @@ ASTNode* ast_create_template_instantiation(ASTNode* generic_func, char** type_ar
     ASTNode* node = ast_create_node(AST_TEMPLATE_INSTANTIATION, generic_func->value);
     if (!node) return NULL;
     
-    node->generic_template = generic_func;
+    ASTGenericInfo* info = ast_generic_info_create(node);
+    if (!info) return node;
+    
+    info->generic_template = generic_func;
     
     // Copy type arguments as inferred types
     if (type_count > 0) {
-        node->inferred_types = malloc(type_count * sizeof(char*));
-        if (node->inferred_types) {
+        pthread_mutex_lock(&ast_lock);
+        info->inferred_types = arena_alloc(ast_current_arena(), type_count * sizeof(const char*));
+        pthread_mutex_unlock(&ast_lock);
+        if (info->inferred_types) {
             for (int i = 0; i < type_count; i++) {
-                node->inferred_types[i] = strdup(type_args[i]);
+                info->inferred_types[i] = intern_string(type_args[i]);
             }
-            node->type_param_count = type_count;
+            info->type_param_count = type_count;
         }
     }
     
     // Generate unique instantiation key
-    char* key = malloc(256);
-    if (key) {
-        strcpy(key, generic_func->value);
-        strcat(key, "<");
-        for (int i = 0; i < type_count; i++) {
-            if (i > 0) strcat(key, ",");
-            strcat(key, type_args[i]);
-        }
-        strcat(key, ">");
-        node->instantiation_key = key;
+    char key[256];
+    int length = snprintf(key, sizeof(key), "%s<", generic_func->value);
+    for (int i = 0; i < type_count && length < (int)sizeof(key); i++) {
+        length += snprintf(key + length, sizeof(key) - length, "%s%s", i > 0 ? "," : "", type_args[i]);
+    }
+    if (length < (int)sizeof(key)) {
+        snprintf(key + length, sizeof(key) - length, ">");
     }
+    info->instantiation_key = intern_string(key);
     
     return node;
 }
@@ -292,7 +526,7 @@ ASTNode* ast_create_template_instantiation(ASTNode* generic_func, char** type_ar
 // Mark node as generic
 void ast_mark_as_generic(ASTNode* node) {
     if (node) {
-        node->is_generic = true;
+        ast_set_flag(node, AST_FLAG_GENERIC, true);
     }
 }
 
@@ -300,34 +534,38 @@ void ast_mark_as_generic(ASTNode* node) {
 void ast_add_type_parameter(ASTNode* node, const char* type_name) {
     if (!node || !type_name) return;
     
+    ASTGenericInfo* info = ast_generic_info_create(node);
+    if (!info) return;
+    
     // Resize type parameters array if needed
-    int new_count = node->type_param_count + 1;
-    char** new_params = realloc(node->type_parameters, new_count * sizeof(char*));
+    int new_count = info->type_param_count + 1;
+    pthread_mutex_lock(&ast_lock);
+    const char** new_params = arena_realloc(ast_current_arena(), info->type_parameters,
+                                            info->type_param_count * sizeof(const char*),
+                                            new_count * sizeof(const char*));
+    pthread_mutex_unlock(&ast_lock);
     if (!new_params) return;
     
-    new_params[node->type_param_count] = strdup(type_name);
-    node->type_parameters = new_params;
-    node->type_param_count = new_count;
+    new_params[info->type_param_count] = intern_string(type_name);
+    info->type_parameters = new_params;
+    info->type_param_count = new_count;
 }
 
 // Set inferred types for instantiated template
 void ast_set_inferred_types(ASTNode* node, char** types, int count) {
     if (!node || !types) return;
     
-    // Free existing inferred types
-    if (node->inferred_types) {
-        for (int i = 0; i < node->type_param_count; i++) {
-            free(node->inferred_types[i]);
-        }
-        free(node->inferred_types);
-    }
+    ASTGenericInfo* info = ast_generic_info_create(node);
+    if (!info) return;
     
-    // Copy new types
-    node->inferred_types = malloc(count * sizeof(char*));
-    if (node->inferred_types) {
+    // Replace existing inferred types (the old array stays in the arena)
+    pthread_mutex_lock(&ast_lock);
+    info->inferred_types = arena_alloc(ast_current_arena(), count * sizeof(const char*));
+    pthread_mutex_unlock(&ast_lock);
+    if (info->inferred_types) {
         for (int i = 0; i < count; i++) {
-            node->inferred_types[i] = strdup(types[i]);
+            info->inferred_types[i] = intern_string(types[i]);
         }
-        node->type_param_count = count;
+        info->type_param_count = count;
     }
 } 
\ No newline at end of file
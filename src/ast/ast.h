@@ -2,6 +2,9 @@
 #define AST_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "../utils/arena.h"
+#include "../lexer/lexer.h"
 
 // AST node types
 typedef enum {
@@ -43,36 +46,55 @@ typedef enum {
 // Forward declaration
 typedef struct ASTNode ASTNode;
 
-// AST node structure
+// Node flags (packed into ASTNode.flags)
+#define AST_FLAG_POINTER  0x01
+#define AST_FLAG_OPTIONAL 0x02
+#define AST_FLAG_ARRAY    0x04
+#define AST_FLAG_GENERIC  0x08   // Generic function/type
+#define AST_FLAG_AUTO     0x10   // auto type
+
+// AST node structure (all strings are interned, see utils/string_intern.h).
+// Operator and assignment nodes carry an OperatorId instead of a value.
+// Only fields touched on every traversal live here; the type annotation and
+// the generics data are kept in side tables keyed by node id.
+// Children array capacity is implied by child_count (4, 8, 16, ...).
 struct ASTNode {
-    ASTNodeType type;
-    char* value;
+    const char* value;
     ASTNode** children;
     int child_count;
-    int child_capacity;
-    int line;
-    int column;
-    
-    // Type information
-    char* data_type;
-    bool is_pointer;
-    bool is_optional;
-    bool is_array;
-    
-    // Generics support
-    bool is_generic;              // Is this a generic function/type?
-    bool is_auto;                 // Is this an auto type?
-    char** type_parameters;       // List of type parameter names (for generic functions)
-    char** inferred_types;        // Resolved types (for instantiated templates)
+    uint32_t id;                  // Index into the side tables
+    uint32_t location;            // Source location, see lexer/line_index.h
+    uint8_t type;                 // ASTNodeType
+    uint8_t flags;                // AST_FLAG_*
+    uint8_t op;                   // OperatorId, OP_NONE for other nodes
+};
+
+// Rarely used generics data (side table)
+typedef struct ASTGenericInfo {
+    const char** type_parameters; // List of type parameter names (for generic functions)
+    const char** inferred_types;  // Resolved types (for instantiated templates)
     int type_param_count;         // Number of type parameters
     ASTNode* generic_template;    // Reference to original generic function (for instantiated functions)
-    char* instantiation_key;     // Unique key for this instantiation
-};
+    const char* instantiation_key; // Unique key for this instantiation
+} ASTGenericInfo;
+
+// AST memory: nodes, child arrays and generics arrays are allocated from the
+// current AST arena and released all at once with arena_destroy().
+// Without an explicit arena a process-wide default arena is used.
+// Switching arenas also starts fresh side tables, so nodes from the previous
+// arena lose their type annotations and generics data.
+// Node creation, ast_add_child and the side tables are thread-safe, so
+// analysis workers may create and annotate nodes concurrently (each node is
+// still modified by one thread at a time); side table reads take no lock.
+// Switching arenas is not thread-safe.
+void ast_use_arena(Arena* arena);
+Arena* ast_current_arena(void);
 
 // AST creation functions
 ASTNode* ast_create_node(ASTNodeType type, const char* value);
-ASTNode* ast_create_binary_op(const char* op, ASTNode* left, ASTNode* right);
-ASTNode* ast_create_unary_op(const char* op, ASTNode* operand);
+ASTNode* ast_create_binary_op(OperatorId op, ASTNode* left, ASTNode* right);
+ASTNode* ast_create_unary_op(OperatorId op, ASTNode* operand);
+ASTNode* ast_create_assignment(OperatorId op, ASTNode* target, ASTNode* value);
 ASTNode* ast_create_function(const char* name, ASTNode* params, ASTNode* return_type, ASTNode* body);
 ASTNode* ast_create_literal(const char* value, const char* type);
 ASTNode* ast_create_identifier(const char* name);
@@ -88,16 +110,31 @@ void ast_set_inferred_types(ASTNode* node, char** types, int count);
 
 // AST manipulation functions
 void ast_add_child(ASTNode* parent, ASTNode* child);
-void ast_set_position(ASTNode* node, int line, int column);
+void ast_set_location(ASTNode* node, uint32_t location);
 void ast_set_type_info(ASTNode* node, const char* type, bool is_pointer, bool is_optional);
 
+// Node accessors
+static inline bool ast_has_flag(const ASTNode* node, uint8_t flag) { return (node->flags & flag) != 0; }
+static inline void ast_set_flag(ASTNode* node, uint8_t flag, bool on) {
+    node->flags = on ? (uint8_t)(node->flags | flag) : (uint8_t)(node->flags & ~flag);
+}
+
+// Side tables
+const char* ast_data_type(const ASTNode* node);
+void ast_set_data_type(ASTNode* node, const char* type);
+ASTGenericInfo* ast_generic_info(const ASTNode* node);
+ASTGenericInfo* ast_generic_info_create(ASTNode* node);
+
 // AST utility functions
 void ast_destroy(ASTNode* node);
-void ast_print(ASTNode* node, int indent);
+void ast_print(ASTNode* node, int indent, const LineIndex* lines);
 ASTNode* ast_find_function(ASTNode* program, const char* name);
 int ast_get_child_count(ASTNode* node);
 ASTNode* ast_get_child(ASTNode* node, int index);
 
+// Memory layout statistics (--ast-stats)
+void ast_print_memory_stats(ASTNode* root);
+
 // AST node type names for debugging
 extern const char* ast_node_type_names[];
 
@@ -3,10 +3,24 @@
 #include "c_types.h"
 #include "runtime.h"
 #include "../semantic/type_inference.h"
+#include "../semantic/struct_layout.h"
+#include "../semantic/import_system.h"
+#include "../utils/string_intern.h"
+#include "../utils/log.h"
+#include "../utils/timing.h"
+#include "../utils/thread_pool.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
 
+// Buffered output is handed to the FILE once it grows past this size
+#define CODEGEN_FLUSH_THRESHOLD (64 * 1024)
+
+// Indentation for the common nesting depths, written with a single copy
+#define CODEGEN_INDENT_WIDTH 4
+static const char CODEGEN_INDENT[] =
+    "                                                                ";
+
 // Create code generator
 CodeGenerator* codegen_create(FILE* output, SymbolTable* symbol_table) {
     return codegen_create_with_inference(output, symbol_table, NULL);
@@ -15,12 +29,16 @@ CodeGenerator* codegen_create(FILE* output, SymbolTable* symbol_table) {
 // Create code generator with type inference context
 CodeGenerator* codegen_create_with_inference(FILE* output, SymbolTable* symbol_table, 
                                            struct TypeInferenceContext* type_inference) {
-    if (!output) return NULL;
-    
     CodeGenerator* gen = malloc(sizeof(CodeGenerator));
     if (!gen) return NULL;
     
     gen->output = output;
+    string_builder_init(&gen->buffer);
+    gen->output_failed = false;
+    gen->detached = false;
+    gen->jobs = 1;
+    gen->shared_header = NULL;
+    gen->module_path = NULL;
     gen->symbol_table = symbol_table;
     gen->type_inference = type_inference;
     gen->indent_level = 0;
@@ -35,21 +53,64 @@ CodeGenerator* codegen_create_with_inference(FILE* output, SymbolTable* symbol_t
     return gen;
 }
 
-// Destroy code generator
+// Destroy code generator (pending output is flushed first)
 void codegen_destroy(CodeGenerator* gen) {
     if (!gen) return;
     
+    codegen_flush(gen);
+    string_builder_free(&gen->buffer);
     free(gen->current_function_name);
     free(gen);
 }
 
+// Write buffered output to the file
+bool codegen_flush(CodeGenerator* gen) {
+    if (!gen || !gen->output) return false;
+    
+    if (gen->buffer.length > 0) {
+        if (fwrite(gen->buffer.data, 1, gen->buffer.length, gen->output) != gen->buffer.length) {
+            gen->output_failed = true;
+        }
+        string_builder_clear(&gen->buffer);
+    }
+    
+    return !gen->output_failed;
+}
+
+// Record allocation failures and stream the buffer once it is large
+static void codegen_after_write(CodeGenerator* gen, bool ok) {
+    if (!ok) gen->output_failed = true;
+    if (!gen->detached && gen->buffer.length >= CODEGEN_FLUSH_THRESHOLD) {
+        codegen_flush(gen);
+    }
+}
+
+// Append formatted text; formats without conversions and a lone "%s" skip printf
+static bool codegen_append_formatted(CodeGenerator* gen, const char* format, va_list args) {
+    if (format[0] == '%' && format[1] == 's' && format[2] == '\0') {
+        const char* text = va_arg(args, const char*);
+        return string_builder_append(&gen->buffer, text ? text : "(null)");
+    }
+    
+    if (!strchr(format, '%')) {
+        return string_builder_append(&gen->buffer, format);
+    }
+    
+    return string_builder_appendv(&gen->buffer, format, args);
+}
+
 // Write indentation
 void codegen_write_indent(CodeGenerator* gen) {
-    if (!gen || !gen->output) return;
+    if (!gen) return;
     
-    for (int i = 0; i < gen->indent_level; i++) {
-        fprintf(gen->output, "    ");
+    bool ok = true;
+    size_t width = (size_t)gen->indent_level * CODEGEN_INDENT_WIDTH;
+    while (ok && width > 0) {
+        size_t chunk = width < sizeof(CODEGEN_INDENT) - 1 ? width : sizeof(CODEGEN_INDENT) - 1;
+        ok = string_builder_append_n(&gen->buffer, CODEGEN_INDENT, chunk);
+        width -= chunk;
     }
+    codegen_after_write(gen, ok);
 }
 
 // Increase indentation
@@ -66,26 +127,41 @@ void codegen_decrease_indent(CodeGenerator* gen) {
 
 // Write formatted line with indentation
 void codegen_write_line(CodeGenerator* gen, const char* format, ...) {
-    if (!gen || !gen->output || !format) return;
+    if (!gen || !format) return;
     
     codegen_write_indent(gen);
     
     va_list args;
     va_start(args, format);
-    vfprintf(gen->output, format, args);
+    bool ok = codegen_append_formatted(gen, format, args);
     va_end(args);
     
-    fprintf(gen->output, "\n");
+    ok = string_builder_append_char(&gen->buffer, '\n') && ok;
+    codegen_after_write(gen, ok);
 }
 
 // Write formatted text without indentation
 void codegen_write(CodeGenerator* gen, const char* format, ...) {
-    if (!gen || !gen->output || !format) return;
+    if (!gen || !format) return;
     
     va_list args;
     va_start(args, format);
-    vfprintf(gen->output, format, args);
+    bool ok = codegen_append_formatted(gen, format, args);
     va_end(args);
+    
+    codegen_after_write(gen, ok);
+}
+
+// Write text verbatim
+void codegen_write_raw(CodeGenerator* gen, const char* text) {
+    if (!gen || !text) return;
+    codegen_after_write(gen, string_builder_append(&gen->buffer, text));
+}
+
+// Write a decimal integer
+void codegen_write_int(CodeGenerator* gen, long long value) {
+    if (!gen) return;
+    codegen_after_write(gen, string_builder_append_int(&gen->buffer, value));
 }
 
 // Generate temporary variable name
@@ -126,7 +202,7 @@ const char* codegen_result_to_string(CodegenResult result) {
 CodegenResult codegen_generate(CodeGenerator* gen, ASTNode* ast) {
     if (!gen || !ast) return CODEGEN_ERROR_INVALID_AST;
     
-    printf("Starting code generation...\n");
+    LOG_INFO(LOG_CAT_CODEGEN, "Starting code generation...\n");
     
     // Generate C code header
     CodegenResult result = codegen_generate_includes(gen);
@@ -138,12 +214,29 @@ CodegenResult codegen_generate(CodeGenerator* gen, ASTNode* ast) {
     
     // Generate the program
     result = codegen_generate_program(gen, ast);
+    
+    // Hand everything to the file, including partial output on failure
+    if (!codegen_flush(gen) && result == CODEGEN_SUCCESS) {
+        result = CODEGEN_ERROR_FILE_IO;
+    }
     if (result != CODEGEN_SUCCESS) return result;
     
-    printf("✓ Code generation completed successfully!\n");
+    LOG_INFO(LOG_CAT_CODEGEN, "✓ Code generation completed successfully!\n");
     return CODEGEN_SUCCESS;
 }
 
+// Standard and runtime includes
+static void codegen_write_standard_includes(CodeGenerator* gen) {
+    codegen_write_line(gen, "#include <stdio.h>");
+    codegen_write_line(gen, "#include <stdlib.h>");
+    codegen_write_line(gen, "#include <stdbool.h>");
+    codegen_write_line(gen, "#include <stdint.h>");
+    codegen_write_line(gen, "#include <string.h>");
+    
+    // Always include Echo runtime
+    codegen_write_line(gen, "#include \"echo_runtime.h\"");
+}
+
 // Generate includes
 CodegenResult codegen_generate_includes(CodeGenerator* gen) {
     if (!gen) return CODEGEN_ERROR_INVALID_AST;
@@ -152,21 +245,94 @@ CodegenResult codegen_generate_includes(CodeGenerator* gen) {
     codegen_write_line(gen, "// Do not edit this file manually");
     codegen_write_line(gen, "");
     
-    // Standard includes
-    codegen_write_line(gen, "#include <stdio.h>");
-    codegen_write_line(gen, "#include <stdlib.h>");
-    codegen_write_line(gen, "#include <stdbool.h>");
-    codegen_write_line(gen, "#include <stdint.h>");
-    codegen_write_line(gen, "#include <string.h>");
+    codegen_write_standard_includes(gen);
     
-    // Always include Echo runtime
-    codegen_write_line(gen, "#include \"echo_runtime.h\"");
+    // Declarations of the other modules
+    if (gen->shared_header) {
+        codegen_write_line(gen, "#include \"%s\"", gen->shared_header);
+    }
+    
+    codegen_write_line(gen, "");
+    
+    return CODEGEN_SUCCESS;
+}
+
+// Open the shared header of a multi-module build
+CodegenResult codegen_generate_header_begin(CodeGenerator* gen, const char* guard) {
+    if (!gen || !guard) return CODEGEN_ERROR_INVALID_AST;
+    
+    codegen_write_line(gen, "// Generated by Echo Language Compiler");
+    codegen_write_line(gen, "// Do not edit this file manually");
+    codegen_write_line(gen, "");
+    codegen_write_line(gen, "#ifndef %s", guard);
+    codegen_write_line(gen, "#define %s", guard);
+    codegen_write_line(gen, "");
+    
+    codegen_write_standard_includes(gen);
+    codegen_write_line(gen, "");
+    
+    return CODEGEN_SUCCESS;
+}
+
+// Structs and exported prototypes of one module; struct layouts come from
+// gen->symbol_table, which must be the module's own
+CodegenResult codegen_generate_module_interface(CodeGenerator* gen, ASTNode* program, const char* module_name) {
+    if (!gen || !program || program->type != AST_PROGRAM) return CODEGEN_ERROR_INVALID_AST;
+    
+    codegen_write_line(gen, "// Module %s", module_name ? module_name : "?");
+    
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        
+        if (child->type == AST_STRUCT) {
+            CodegenResult result = codegen_generate_struct(gen, child);
+            if (result != CODEGEN_SUCCESS) return result;
+            codegen_write_line(gen, "");
+        }
+    }
+    
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        
+        if (child->type == AST_FUNCTION && child->value && strcmp(child->value, "main") != 0) {
+            CodegenResult result = codegen_generate_function_signature(gen, child);
+            if (result != CODEGEN_SUCCESS) return result;
+            codegen_write(gen, ";\n");
+        }
+    }
     
     codegen_write_line(gen, "");
     
     return CODEGEN_SUCCESS;
 }
 
+// Close the shared header
+CodegenResult codegen_generate_header_end(CodeGenerator* gen, const char* guard) {
+    if (!gen || !guard) return CODEGEN_ERROR_INVALID_AST;
+    
+    codegen_write_line(gen, "#endif // %s", guard);
+    
+    return CODEGEN_SUCCESS;
+}
+
+// A module's section of the shared header as a string (caller frees)
+char* codegen_render_module_interface(SymbolTable* symbol_table, ASTNode* program, const char* module_name,
+                                      bool imported) {
+    CodeGenerator* gen = codegen_create(NULL, symbol_table);
+    if (!gen) return NULL;
+    gen->module_path = imported ? module_name : NULL;
+    
+    char* text = NULL;
+    if (codegen_generate_module_interface(gen, program, module_name) == CODEGEN_SUCCESS &&
+        !gen->output_failed) {
+        text = gen->buffer.data;
+        string_builder_init(&gen->buffer);
+    }
+    
+    codegen_destroy(gen);
+    return text;
+}
+
 // Generate type definitions
 CodegenResult codegen_generate_type_definitions(CodeGenerator* gen) {
     if (!gen) return CODEGEN_ERROR_INVALID_AST;
@@ -178,24 +344,159 @@ CodegenResult codegen_generate_type_definitions(CodeGenerator* gen) {
     return CODEGEN_SUCCESS;
 }
 
+// Function or instantiation rendered into its own buffer
+typedef struct CodegenPiece {
+    ASTNode* function;                  // AST_FUNCTION, or NULL for an instantiation
+    GenericInstantiation* instantiation;
+    StringBuilder text;                 // Rendered code, including the trailing blank line
+    bool output_failed;
+    CodegenResult result;
+} CodegenPiece;
+
+// Shared state of one parallel pass
+typedef struct CodegenParallel {
+    CodeGenerator* workers;             // One generator per thread
+    CodegenPiece* pieces;
+} CodegenParallel;
+
+// Render one piece exactly as the serial loop would
+static void codegen_render_piece(void* arg, int index, int worker) {
+    CodegenParallel* parallel = arg;
+    CodeGenerator* gen = &parallel->workers[worker];
+    CodegenPiece* piece = &parallel->pieces[index];
+    int indent_level = gen->indent_level;
+    
+    if (piece->function) {
+        piece->result = codegen_generate_function(gen, piece->function);
+    } else {
+        piece->result = codegen_generate_instantiated_function(gen, piece->instantiation);
+    }
+    if (piece->result == CODEGEN_SUCCESS) {
+        codegen_write_line(gen, "");
+    }
+    
+    // Hand the buffer to the piece and reset the per-function state
+    piece->text = gen->buffer;
+    piece->output_failed = gen->output_failed;
+    string_builder_init(&gen->buffer);
+    gen->output_failed = false;
+    gen->indent_level = indent_level;
+    gen->in_function = false;
+    free(gen->current_function_name);
+    gen->current_function_name = NULL;
+}
+
+// Render pieces on gen->jobs threads, then append them in order. The output
+// and the result are those of rendering the pieces one by one on gen.
+static CodegenResult codegen_generate_pieces(CodeGenerator* gen, CodegenPiece* pieces, int count) {
+    int workers = gen->jobs < count ? gen->jobs : count;
+    CodegenParallel parallel = { calloc(workers, sizeof(CodeGenerator)), pieces };
+    if (!parallel.workers) return CODEGEN_ERROR_MEMORY_ALLOCATION;
+    
+    // Workers read symbols through a layer, which never marks the shared table
+    CodegenResult result = CODEGEN_SUCCESS;
+    for (int i = 0; i < workers; i++) {
+        CodeGenerator* worker = &parallel.workers[i];
+        *worker = *gen;
+        string_builder_init(&worker->buffer);
+        worker->output_failed = false;
+        worker->detached = true;
+        worker->current_function_name = NULL;
+        worker->symbol_table = symbol_table_create_layer(gen->symbol_table);
+        if (!worker->symbol_table) result = CODEGEN_ERROR_MEMORY_ALLOCATION;
+    }
+    
+    if (result == CODEGEN_SUCCESS) {
+        thread_pool_run(workers, count, codegen_render_piece, &parallel);
+        
+        // Stop after the first failure, as the serial loop does
+        for (int i = 0; i < count; i++) {
+            if (pieces[i].output_failed) gen->output_failed = true;
+            codegen_after_write(gen, string_builder_append_n(&gen->buffer, pieces[i].text.data, pieces[i].text.length));
+            result = pieces[i].result;
+            if (result != CODEGEN_SUCCESS) break;
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        string_builder_free(&pieces[i].text);
+    }
+    for (int i = 0; i < workers; i++) {
+        symbol_table_destroy(parallel.workers[i].symbol_table);
+        string_builder_free(&parallel.workers[i].buffer);
+    }
+    free(parallel.workers);
+    return result;
+}
+
+// Generate function implementations on several threads
+static CodegenResult codegen_generate_functions_parallel(CodeGenerator* gen, ASTNode* program) {
+    int count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        if (program->children[i]->type == AST_FUNCTION) count++;
+    }
+    if (count == 0) return CODEGEN_SUCCESS;
+    
+    CodegenPiece* pieces = calloc(count, sizeof(CodegenPiece));
+    if (!pieces) return CODEGEN_ERROR_MEMORY_ALLOCATION;
+    
+    count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        if (program->children[i]->type == AST_FUNCTION) {
+            pieces[count++].function = program->children[i];
+        }
+    }
+    
+    CodegenResult result = codegen_generate_pieces(gen, pieces, count);
+    free(pieces);
+    return result;
+}
+
+// Generate instantiation implementations on several threads
+static CodegenResult codegen_generate_instantiations_parallel(CodeGenerator* gen) {
+    int count = 0;
+    for (GenericInstantiation* inst = gen->type_inference->instantiations; inst; inst = inst->next) {
+        count++;
+    }
+    if (count == 0) return CODEGEN_SUCCESS;
+    
+    CodegenPiece* pieces = calloc(count, sizeof(CodegenPiece));
+    if (!pieces) return CODEGEN_ERROR_MEMORY_ALLOCATION;
+    
+    count = 0;
+    for (GenericInstantiation* inst = gen->type_inference->instantiations; inst; inst = inst->next) {
+        pieces[count++].instantiation = inst;
+    }
+    
+    CodegenResult result = codegen_generate_pieces(gen, pieces, count);
+    free(pieces);
+    return result;
+}
+
 // Generate program
 CodegenResult codegen_generate_program(CodeGenerator* gen, ASTNode* program) {
     if (!gen || !program || program->type != AST_PROGRAM) {
         return CODEGEN_ERROR_INVALID_AST;
     }
     
-    // First pass: generate struct definitions
+    // First pass: generate struct definitions (in a multi-module build they
+    // are in the shared header)
+    // (phases left open by an early return are closed by the caller's timing_end)
+    int phase = timing_begin("structs");
     for (int i = 0; i < program->child_count; i++) {
         ASTNode* child = program->children[i];
         
-        if (child->type == AST_STRUCT) {
+        if (child->type == AST_STRUCT && !gen->shared_header) {
             CodegenResult result = codegen_generate_struct(gen, child);
             if (result != CODEGEN_SUCCESS) return result;
             codegen_write_line(gen, "");
         }
     }
     
+    timing_end(phase);
+    
     // Second pass: generate function declarations (including generic instantiations)
+    phase = timing_begin("declarations");
     CodegenResult result = codegen_generate_function_declarations(gen, program);
     if (result != CODEGEN_SUCCESS) return result;
     
@@ -204,25 +505,36 @@ CodegenResult codegen_generate_program(CodeGenerator* gen, ASTNode* program) {
         result = codegen_generate_generic_instantiations(gen);
         if (result != CODEGEN_SUCCESS) return result;
     }
+    timing_end(phase);
     
     codegen_write_line(gen, "");
     
     // Third pass: generate function implementations (non-generic only)
-    for (int i = 0; i < program->child_count; i++) {
-        ASTNode* child = program->children[i];
-        
-        if (child->type == AST_FUNCTION) {
-            result = codegen_generate_function(gen, child);
-            if (result != CODEGEN_SUCCESS) return result;
-            codegen_write_line(gen, "");
+    phase = timing_begin("functions");
+    if (gen->jobs > 1) {
+        result = codegen_generate_functions_parallel(gen, program);
+        if (result != CODEGEN_SUCCESS) return result;
+    } else {
+        for (int i = 0; i < program->child_count; i++) {
+            ASTNode* child = program->children[i];
+            
+            if (child->type == AST_FUNCTION) {
+                result = codegen_generate_function(gen, child);
+                if (result != CODEGEN_SUCCESS) return result;
+                codegen_write_line(gen, "");
+            }
         }
     }
     
+    timing_end(phase);
+    
     // Fourth pass: generate generic instantiations implementations
+    phase = timing_begin("generic instantiations");
     if (gen->type_inference) {
         result = codegen_generate_generic_instantiations_impl(gen);
         if (result != CODEGEN_SUCCESS) return result;
     }
+    timing_end(phase);
     
     return CODEGEN_SUCCESS;
 }
@@ -251,6 +563,15 @@ CodegenResult codegen_generate_function_declarations(CodeGenerator* gen, ASTNode
     return CODEGEN_SUCCESS;
 }
 
+// C name of a function of the program: prefixed in an imported module (see
+// import_module_c_name), where main is not exported and keeps its name
+static const char* codegen_function_c_name(CodeGenerator* gen, const char* name) {
+    if (!gen->module_path || !name || strcmp(name, "main") == 0) return name;
+    
+    const char* c_name = import_module_c_name(gen->module_path, name);
+    return c_name ? c_name : name;
+}
+
 // Generate function signature
 CodegenResult codegen_generate_function_signature(CodeGenerator* gen, ASTNode* function) {
     if (!gen || !function || function->type != AST_FUNCTION) {
@@ -273,7 +594,7 @@ CodegenResult codegen_generate_function_signature(CodeGenerator* gen, ASTNode* f
     }
     
     // Write function signature
-    codegen_write(gen, "%s %s(", return_type, function->value);
+    codegen_write(gen, "%s %s(", return_type, codegen_function_c_name(gen, function->value));
     
     // Find parameters
     ASTNode* params = NULL;
@@ -310,49 +631,28 @@ CodegenResult codegen_generate_function_signature(CodeGenerator* gen, ASTNode* f
     return CODEGEN_SUCCESS;
 }
 
-// Basic type conversion (will be expanded in c_types.c)
+// Echo type name to C type (the spelling is parsed once, see semantic/types.h)
 const char* codegen_echo_type_to_c_type(const char* echo_type) {
     if (!echo_type) return "void";
     
-    // Basic types
-    if (strcmp(echo_type, "i32") == 0) return "int32_t";
-    if (strcmp(echo_type, "i64") == 0) return "int64_t";
-    if (strcmp(echo_type, "f32") == 0) return "float";
-    if (strcmp(echo_type, "f64") == 0) return "double";
-    if (strcmp(echo_type, "bool") == 0) return "bool";
-    if (strcmp(echo_type, "string") == 0) return "char*";
-    if (strcmp(echo_type, "void") == 0) return "void";
-    
-    // Type inference types (as generated by inference system)
-    if (strcmp(echo_type, "integer") == 0) return "int";
-    if (strcmp(echo_type, "float") == 0) return "double";
-    
-    // Default fallback
-    return echo_type;
+    const Type* type = type_parse(echo_type);
+    return type ? type->c_name : echo_type;
 }
 
 // Check if type is optional
 bool codegen_is_optional_type(const char* echo_type) {
-    if (!echo_type) return false;
-    
-    size_t len = strlen(echo_type);
-    return len > 0 && echo_type[len - 1] == '?';
+    return type_is_kind(type_parse(echo_type), TYPE_OPTIONAL);
 }
 
 // Check if type is pointer
 bool codegen_is_pointer_type(const char* echo_type) {
-    if (!echo_type) return false;
-    
-    size_t len = strlen(echo_type);
-    return len > 0 && echo_type[len - 1] == '*';
+    return type_is_kind(type_parse(echo_type), TYPE_POINTER);
 }
 
 // Check if type is smart pointer
 bool codegen_is_smart_pointer_type(const char* echo_type) {
-    if (!echo_type) return false;
-    
-    return strstr(echo_type, "unique<") != NULL || 
-           strstr(echo_type, "shared<") != NULL;
+    const Type* type = type_parse(echo_type);
+    return type_is_kind(type, TYPE_UNIQUE_PTR) || type_is_kind(type, TYPE_SHARED_PTR);
 }
 
 // Placeholder implementations for remaining functions
@@ -461,18 +761,12 @@ CodegenResult codegen_generate_block(CodeGenerator* gen, ASTNode* block) {
 
 // ================== HELPER FUNCTIONS FOR GENERIC INSTANTIATIONS ==================
 
-// Normalize type names for instantiation matching
-static char* normalize_type_name(const char* type_name) {
-    if (!type_name) return strdup("integer");
+// Normalize type names for instantiation matching (i32 -> integer, f64 -> float)
+static const char* normalize_type_name(const char* type_name) {
+    if (!type_name) return intern_string("integer");
     
-    // Map C-style types to Echo types
-    if (strcmp(type_name, "i32") == 0) return strdup("integer");
-    if (strcmp(type_name, "f64") == 0) return strdup("float");
-    if (strcmp(type_name, "f32") == 0) return strdup("float");
-    if (strcmp(type_name, "i64") == 0) return strdup("integer");
-    
-    // Return as-is for other types
-    return strdup(type_name);
+    const Type* type = type_parse(type_name);
+    return type ? type->family->name : intern_string(type_name);
 }
 
 // Find parameter list in a function AST
@@ -488,7 +782,7 @@ static ASTNode* find_parameter_list(ASTNode* function) {
 }
 
 // Find parameter type by name in generic instantiation
-static char* find_parameter_type_in_instantiation(GenericInstantiation* inst, const char* param_name) {
+static const char* find_parameter_type_in_instantiation(GenericInstantiation* inst, const char* param_name) {
     if (!inst || !param_name) return NULL;
     
     ASTNode* params = find_parameter_list(inst->original_function);
@@ -497,26 +791,25 @@ static char* find_parameter_type_in_instantiation(GenericInstantiation* inst, co
     // Find which parameter matches the identifier
     for (int i = 0; i < params->child_count && i < inst->type_arg_count; i++) {
         ASTNode* param = params->children[i];
-        if (param->type == AST_PARAMETER && param->value &&
-            strcmp(param->value, param_name) == 0) {
+        if (param->type == AST_PARAMETER && param->value == param_name) {
             // Found matching parameter - return its concrete type
-            return strdup(inst->type_arguments[i]);
+            return inst->type_arguments[i];
         }
     }
     return NULL;
 }
 
 // Infer auto variable type in generic instantiation context
-static char* infer_auto_type_in_generic_context(GenericInstantiation* inst, ASTNode* init_expr, const char* var_name) {
+static const char* infer_auto_type_in_generic_context(GenericInstantiation* inst, ASTNode* init_expr, const char* var_name) {
     if (!inst || !init_expr) return NULL;
     
-    char* inferred_type = NULL;
+    const char* inferred_type = NULL;
     
     // Case 1: Direct parameter reference (auto x = param)
     if (init_expr->type == AST_IDENTIFIER) {
         inferred_type = find_parameter_type_in_instantiation(inst, init_expr->value);
         if (inferred_type) {
-            printf("✓ Using concrete type '%s' for auto variable '%s' in generic instantiation\n", 
+            LOG_DEBUG(LOG_CAT_CODEGEN, "✓ Using concrete type '%s' for auto variable '%s' in generic instantiation\n", 
                    inferred_type, var_name);
         }
     }
@@ -527,11 +820,11 @@ static char* infer_auto_type_in_generic_context(GenericInstantiation* inst, ASTN
         
         // If both operands are the same parameter, use that parameter's type
         if (left->type == AST_IDENTIFIER && right->type == AST_IDENTIFIER &&
-            left->value && right->value && strcmp(left->value, right->value) == 0) {
+            left->value && left->value == right->value) {
             
             inferred_type = find_parameter_type_in_instantiation(inst, left->value);
             if (inferred_type) {
-                printf("✓ Using concrete type '%s' for auto variable '%s' from binary op in generic instantiation\n", 
+                LOG_DEBUG(LOG_CAT_CODEGEN, "✓ Using concrete type '%s' for auto variable '%s' from binary op in generic instantiation\n", 
                        inferred_type, var_name);
             }
         }
@@ -539,13 +832,13 @@ static char* infer_auto_type_in_generic_context(GenericInstantiation* inst, ASTN
         else if (left->type == AST_IDENTIFIER) {
             inferred_type = find_parameter_type_in_instantiation(inst, left->value);
             if (inferred_type) {
-                printf("✓ Using concrete type '%s' for auto variable '%s' from left operand in generic instantiation\n", 
+                LOG_DEBUG(LOG_CAT_CODEGEN, "✓ Using concrete type '%s' for auto variable '%s' from left operand in generic instantiation\n", 
                        inferred_type, var_name);
             } else {
                 // If not a parameter, assume it's another auto variable with same type as first parameter
                 if (inst->type_arg_count > 0) {
-                    inferred_type = strdup(inst->type_arguments[0]);
-                    printf("✓ Using concrete type '%s' for auto variable '%s' from auto variable operand in generic instantiation\n", 
+                    inferred_type = inst->type_arguments[0];
+                    LOG_DEBUG(LOG_CAT_CODEGEN, "✓ Using concrete type '%s' for auto variable '%s' from auto variable operand in generic instantiation\n", 
                            inferred_type, var_name);
                 }
             }
@@ -570,7 +863,7 @@ CodegenResult codegen_generate_variable_decl(CodeGenerator* gen, ASTNode* var_de
         if (type_node->type == AST_AUTO_TYPE) {
             // For auto type, infer from initialization expression
             if (var_decl->child_count > 1 && gen->type_inference) {
-                char* inferred_type = NULL;
+                const char* inferred_type = NULL;
                 
                 // If we're in a generic instantiation context, use specialized logic
                 if (gen->current_generic_instantiation) {
@@ -587,7 +880,6 @@ CodegenResult codegen_generate_variable_decl(CodeGenerator* gen, ASTNode* var_de
                 
                 if (inferred_type) {
                     c_type = codegen_echo_type_to_c_type(inferred_type);
-                    free(inferred_type);
                 } else {
                     c_type = "int"; // Default fallback
                 }
@@ -912,7 +1204,7 @@ CodegenResult codegen_generate_binary_op(CodeGenerator* gen, ASTNode* binary_op)
     if (result != CODEGEN_SUCCESS) return result;
     
     // Generate operator
-    codegen_write(gen, " %s ", binary_op->value);
+    codegen_write(gen, " %s ", operator_to_string((OperatorId)binary_op->op));
     
     // Generate right operand
     result = codegen_generate_expression(gen, binary_op->children[1]);
@@ -931,12 +1223,26 @@ CodegenResult codegen_generate_unary_op(CodeGenerator* gen, ASTNode* unary_op) {
     }
     
     // Generate operator
-    codegen_write(gen, "%s", unary_op->value);
+    codegen_write(gen, "%s", operator_to_string((OperatorId)unary_op->op));
     
     // Generate operand
     return codegen_generate_expression(gen, unary_op->children[0]);
 }
 
+// Function name of a non-generic call: the program's own functions by
+// their C name, anything else as an expression
+static CodegenResult codegen_generate_callee(CodeGenerator* gen, ASTNode* callee) {
+    if (gen->module_path && callee->type == AST_IDENTIFIER && gen->symbol_table) {
+        Symbol* symbol = symbol_table_lookup(gen->symbol_table, callee->value);
+        if (symbol && symbol->type == SYMBOL_FUNCTION && !symbol->is_builtin &&
+            symbol->declaration && symbol->declaration->type == AST_FUNCTION) {
+            codegen_write(gen, "%s", codegen_function_c_name(gen, callee->value));
+            return CODEGEN_SUCCESS;
+        }
+    }
+    return codegen_generate_expression(gen, callee);
+}
+
 CodegenResult codegen_generate_call(CodeGenerator* gen, ASTNode* call) {
     if (!gen || !call || call->type != AST_CALL) {
         return CODEGEN_ERROR_INVALID_AST;
@@ -960,29 +1266,27 @@ CodegenResult codegen_generate_call(CodeGenerator* gen, ASTNode* call) {
                 symbol->ast_node == gen->current_generic_instantiation->original_function) {
                 // This is a recursive call - use the current instantiation's mangled name
                 codegen_write(gen, "%s", gen->current_generic_instantiation->mangled_name);
+            } else if (type_inference_call_target(call)) {
+                // Resolved during semantic analysis
+                codegen_write(gen, "%s", type_inference_call_target(call)->value);
             } else {
-                // Find the correct instantiation
+                // Not resolved by the semantic pass: find the instantiation by argument types
                 
                 // Collect argument types
                 int arg_count = call->child_count - 1;
-                char** arg_types = malloc(arg_count * sizeof(char*));
+                const char** arg_types = malloc(arg_count * sizeof(const char*));
                 if (!arg_types) return CODEGEN_ERROR_MEMORY_ALLOCATION;
                 
-                printf("🔍 Analyzing call to '%s' with %d arguments:\n", callee->value, arg_count);
+                LOG_DEBUG(LOG_CAT_CODEGEN, "🔍 Analyzing call to '%s' with %d arguments:\n", callee->value, arg_count);
                 for (int i = 0; i < arg_count; i++) {
                     ASTNode* arg = call->children[i + 1];
-                    char* raw_type = type_inference_infer_expression_type_with_symbols(gen->type_inference, arg, gen->symbol_table);
+                    const char* raw_type = type_inference_infer_expression_type_with_symbols(gen->type_inference, arg, gen->symbol_table);
                     if (!raw_type) {
-                        // Free allocated types
-                        for (int j = 0; j < i; j++) {
-                            free(arg_types[j]);
-                        }
                         free(arg_types);
                         return CODEGEN_ERROR_INVALID_AST;
                     }
                     arg_types[i] = normalize_type_name(raw_type);
-                    printf("  Arg %d: %s (raw: %s, normalized: %s)\n", i, arg->value ? arg->value : "?", raw_type, arg_types[i]);
-                    free(raw_type);
+                    LOG_TRACE(LOG_CAT_CODEGEN, "  Arg %d: %s (raw: %s, normalized: %s)\n", i, arg->value ? arg->value : "?", raw_type, arg_types[i]);
                 }
                 
                 // Find the instantiation
@@ -995,13 +1299,13 @@ CodegenResult codegen_generate_call(CodeGenerator* gen, ASTNode* call) {
                 } else {
                     // If we couldn't find instantiation by exact type match,
                     // try to find any instantiation for this function with same argument count
-                    printf("⚠️ Could not find exact instantiation, searching by function name and arg count...\n");
+                    LOG_DEBUG(LOG_CAT_CODEGEN, "⚠️ Could not find exact instantiation, searching by function name and arg count...\n");
                     
                     GenericInstantiation* fallback_inst = gen->type_inference->instantiations;
                     while (fallback_inst) {
                         if (fallback_inst->original_function == symbol->ast_node &&
                             fallback_inst->type_arg_count == arg_count) {
-                            printf("✓ Using fallback instantiation: %s\n", fallback_inst->mangled_name);
+                            LOG_DEBUG(LOG_CAT_CODEGEN, "✓ Using fallback instantiation: %s\n", fallback_inst->mangled_name);
                             codegen_write(gen, "%s", fallback_inst->mangled_name);
                             break;
                         }
@@ -1010,25 +1314,21 @@ CodegenResult codegen_generate_call(CodeGenerator* gen, ASTNode* call) {
                     
                     if (!fallback_inst) {
                         // Last resort: use original name
-                        printf("⚠️ No instantiation found, using original name: %s\n", callee->value);
+                        LOG_DEBUG(LOG_CAT_CODEGEN, "⚠️ No instantiation found, using original name: %s\n", callee->value);
                         codegen_write(gen, "%s", callee->value);
                     }
                 }
                 
-                // Free argument types
-                for (int i = 0; i < arg_count; i++) {
-                    free(arg_types[i]);
-                }
                 free(arg_types);
             }
         } else {
             // Regular function call
-            CodegenResult result = codegen_generate_expression(gen, callee);
+            CodegenResult result = codegen_generate_callee(gen, callee);
             if (result != CODEGEN_SUCCESS) return result;
         }
     } else {
         // Generate function name (handles scope resolution and regular identifiers)
-        CodegenResult result = codegen_generate_expression(gen, callee);
+        CodegenResult result = codegen_generate_callee(gen, callee);
         if (result != CODEGEN_SUCCESS) return result;
     }
     
@@ -1081,10 +1381,11 @@ CodegenResult codegen_generate_literal(CodeGenerator* gen, ASTNode* literal) {
     }
     
     // Generate literal based on its type
-    if (literal->data_type) {
-        if (strcmp(literal->data_type, "string") == 0) {
+    const Type* data_type = type_parse(ast_data_type(literal));
+    if (data_type) {
+        if (type_has_trait(data_type, TYPE_TRAIT_STRING)) {
             codegen_write(gen, "\"%s\"", literal->value);
-        } else if (strcmp(literal->data_type, "char") == 0) {
+        } else if (type_has_trait(data_type, TYPE_TRAIT_CHAR)) {
             codegen_write(gen, "'%s'", literal->value);
         } else {
             // Integer, float, boolean literals
@@ -1211,7 +1512,21 @@ CodegenResult codegen_generate_struct(CodeGenerator* gen, ASTNode* struct_node)
     codegen_write_line(gen, "typedef struct {");
     codegen_increase_indent(gen);
     
-    // Generate fields
+    // Generate fields from the index built by semantic analysis
+    Symbol* symbol = symbol_table_lookup(gen->symbol_table, struct_node->value);
+    if (symbol && symbol->type == SYMBOL_STRUCT && symbol->layout) {
+        for (int i = 0; i < symbol->layout->field_count; i++) {
+            const StructField* field = &symbol->layout->fields[i];
+            if (field->type && field->type_node->type == AST_TYPE) {
+                codegen_write_line(gen, "%s %s;", field->type->c_name, field->name);
+            }
+        }
+        
+        codegen_decrease_indent(gen);
+        codegen_write_line(gen, "} %s;", struct_node->value);
+        return CODEGEN_SUCCESS;
+    }
+    
     for (int i = 0; i < struct_node->child_count; i++) {
         ASTNode* field = struct_node->children[i];
         
@@ -1223,7 +1538,7 @@ CodegenResult codegen_generate_struct(CodeGenerator* gen, ASTNode* struct_node)
                 const char* field_name = field->value;
                 
                 // Handle pointer types
-                if (field_type->is_pointer) {
+                if (ast_has_flag(field_type, AST_FLAG_POINTER)) {
                     codegen_write_line(gen, "%s* %s;", c_type, field_name);
                 } else {
                     codegen_write_line(gen, "%s %s;", c_type, field_name);
@@ -1280,12 +1595,12 @@ CodegenResult codegen_generate_struct_literal(CodeGenerator* gen, ASTNode* struc
 CodegenResult codegen_generate_generic_instantiations(CodeGenerator* gen) {
     if (!gen || !gen->type_inference) return CODEGEN_SUCCESS;
     
-    printf("Generating generic instantiation declarations...\n");
+    LOG_DEBUG(LOG_CAT_CODEGEN, "Generating generic instantiation declarations...\n");
     
     GenericInstantiation* inst = gen->type_inference->instantiations;
     while (inst) {
         // Generate function signature for this instantiation
-        printf("  Declaring instantiation: %s\n", inst->mangled_name);
+        LOG_DEBUG(LOG_CAT_CODEGEN, "  Declaring instantiation: %s\n", inst->mangled_name);
         
         // Get return type from original function
         ASTNode* return_type_node = NULL;
@@ -1349,11 +1664,15 @@ CodegenResult codegen_generate_generic_instantiations(CodeGenerator* gen) {
 CodegenResult codegen_generate_generic_instantiations_impl(CodeGenerator* gen) {
     if (!gen || !gen->type_inference) return CODEGEN_SUCCESS;
     
-    printf("Generating generic instantiation implementations...\n");
+    LOG_DEBUG(LOG_CAT_CODEGEN, "Generating generic instantiation implementations...\n");
+    
+    if (gen->jobs > 1) {
+        return codegen_generate_instantiations_parallel(gen);
+    }
     
     GenericInstantiation* inst = gen->type_inference->instantiations;
     while (inst) {
-        printf("  Generating implementation: %s\n", inst->mangled_name);
+        LOG_DEBUG(LOG_CAT_CODEGEN, "  Generating implementation: %s\n", inst->mangled_name);
         
         CodegenResult result = codegen_generate_instantiated_function(gen, inst);
         if (result != CODEGEN_SUCCESS) return result;
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "../ast/ast.h"
 #include "../semantic/semantic.h"
+#include "../utils/string_builder.h"
 
 // Forward declarations
 typedef struct CodeGenerator CodeGenerator;
@@ -13,7 +14,13 @@ struct GenericInstantiation;
 
 // Code generator structure
 struct CodeGenerator {
-    FILE* output;                    // Output C file
+    FILE* output;                    // Output C file (NULL: output stays in the buffer)
+    StringBuilder buffer;            // Pending output, written to the file in large chunks
+    bool output_failed;              // Buffer allocation or file write failed
+    bool detached;                   // Worker generator: output stays in the buffer
+    int jobs;                        // Threads rendering function bodies (1 = serial)
+    const char* shared_header;       // Header of a multi-module build, which has the structs (or NULL)
+    const char* module_path;         // Path of an imported module, whose functions take prefixed C names (or NULL)
     SymbolTable* symbol_table;       // Symbol information from semantic analysis
     struct TypeInferenceContext* type_inference; // Type inference context for generics
     int indent_level;                // Current indentation level
@@ -87,6 +94,9 @@ void codegen_increase_indent(CodeGenerator* gen);
 void codegen_decrease_indent(CodeGenerator* gen);
 void codegen_write_line(CodeGenerator* gen, const char* format, ...);
 void codegen_write(CodeGenerator* gen, const char* format, ...);
+void codegen_write_raw(CodeGenerator* gen, const char* text);
+void codegen_write_int(CodeGenerator* gen, long long value);
+bool codegen_flush(CodeGenerator* gen);
 char* codegen_generate_temp_var(CodeGenerator* gen);
 char* codegen_generate_label(CodeGenerator* gen);
 
@@ -95,6 +105,19 @@ CodegenResult codegen_generate_includes(CodeGenerator* gen);
 CodegenResult codegen_generate_type_definitions(CodeGenerator* gen);
 CodegenResult codegen_generate_function_declarations(CodeGenerator* gen, ASTNode* program);
 
+// Shared header of a multi-module build: the structs and the prototypes of
+// exported functions (non-generic, except main) of each module, in
+// dependency order between begin and end. The functions of an imported
+// module are declared under gen->module_path's C names.
+CodegenResult codegen_generate_header_begin(CodeGenerator* gen, const char* guard);
+CodegenResult codegen_generate_module_interface(CodeGenerator* gen, ASTNode* program, const char* module_name);
+CodegenResult codegen_generate_header_end(CodeGenerator* gen, const char* guard);
+
+// A module's section of the shared header as a string (caller frees; NULL
+// on failure); an imported module's functions take prefixed C names
+char* codegen_render_module_interface(SymbolTable* symbol_table, ASTNode* program, const char* module_name,
+                                      bool imported);
+
 // Runtime support
 CodegenResult codegen_generate_runtime_support(CodeGenerator* gen);
 bool codegen_needs_optional_support(ASTNode* ast);
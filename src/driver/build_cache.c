@@ -0,0 +1,283 @@
+#define _GNU_SOURCE
+#include "build_cache.h"
+#include "../utils/string_builder.h"
+#include <inttypes.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#define BUILD_CACHE_MAGIC "echo-cache 1"
+
+// Open a cache directory, creating it if needed, or an in-memory cache
+BuildCache* build_cache_open(const char* directory) {
+    if (directory && mkdir(directory, 0777) != 0 && errno != EEXIST) return NULL;
+    
+    BuildCache* cache = calloc(1, sizeof(BuildCache));
+    if (!cache) return NULL;
+    
+    cache->directory = directory ? strdup(directory) : NULL;
+    if (directory && !cache->directory) {
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void build_cache_close(BuildCache* cache) {
+    if (!cache) return;
+    
+    for (size_t i = 0; i < cache->capacity; i++) {
+        free(cache->paths[i]);
+        cache_entry_destroy(cache->entries[i]);
+    }
+    free(cache->paths);
+    free(cache->entries);
+    free(cache->directory);
+    free(cache);
+}
+
+uint64_t build_cache_hash(uint64_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t build_cache_hash_string(uint64_t hash, const char* text) {
+    // The terminator keeps ("ab", "c") apart from ("a", "bc")
+    return text ? build_cache_hash(hash, text, strlen(text) + 1) : hash;
+}
+
+// Hash of a file's contents; false if it cannot be read
+bool build_cache_hash_file(const char* path, uint64_t* hash) {
+    FILE* file = path ? fopen(path, "rb") : NULL;
+    if (!file) return false;
+    
+    char buffer[8192];
+    uint64_t result = BUILD_CACHE_SEED;
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        result = build_cache_hash(result, buffer, length);
+    }
+    
+    bool ok = !ferror(file);
+    fclose(file);
+    if (ok) *hash = result;
+    return ok;
+}
+
+// Entry file of a source file: <directory>/<hash of its path>.entry
+static char* build_cache_entry_path(BuildCache* cache, const char* source_path, const char* suffix) {
+    char name[64];
+    snprintf(name, sizeof(name), "/%016" PRIx64 ".entry%s",
+             build_cache_hash_string(BUILD_CACHE_SEED, source_path), suffix);
+    
+    StringBuilder path;
+    string_builder_init(&path);
+    string_builder_append(&path, cache->directory);
+    string_builder_append(&path, name);
+    return path.data;
+}
+
+void cache_entry_destroy(CacheEntry* entry) {
+    if (!entry) return;
+    
+    for (int i = 0; i < entry->import_count; i++) {
+        free(entry->imports[i]);
+    }
+    free(entry->imports);
+    free(entry->interface);
+    free(entry);
+}
+
+// Read one line, without its newline, and compare it with text
+static bool build_cache_read_line(FILE* file, const char* text) {
+    char line[PATH_MAX + 16];
+    if (!fgets(line, sizeof(line), file)) return false;
+    line[strcspn(line, "\n")] = '\0';
+    return strcmp(line, text) == 0;
+}
+
+// Read one "<field> <hex>" line
+static bool build_cache_read_hash(FILE* file, const char* field, uint64_t* value) {
+    char name[16];
+    return fscanf(file, "%15s %" SCNx64 "\n", name, value) == 2 && strcmp(name, field) == 0;
+}
+
+// Deep copy of an entry (NULL on allocation failure)
+static CacheEntry* cache_entry_copy(const CacheEntry* entry) {
+    CacheEntry* copy = calloc(1, sizeof(CacheEntry));
+    if (!copy) return NULL;
+    
+    copy->source_hash = entry->source_hash;
+    copy->key = entry->key;
+    copy->output_hash = entry->output_hash;
+    copy->imports = calloc(entry->import_count + 1, sizeof(char*));
+    copy->interface = strdup(entry->interface ? entry->interface : "");
+    bool ok = copy->imports && copy->interface;
+    
+    for (int i = 0; ok && i < entry->import_count; i++) {
+        copy->imports[i] = strdup(entry->imports[i]);
+        ok = copy->imports[i] != NULL;
+        copy->import_count++;
+    }
+    
+    if (!ok) {
+        cache_entry_destroy(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+// Slot of a source path in the in-memory table (an empty one if absent)
+static size_t build_cache_slot(const BuildCache* cache, const char* source_path) {
+    size_t mask = cache->capacity - 1;
+    size_t slot = build_cache_hash_string(BUILD_CACHE_SEED, source_path) & mask;
+    while (cache->paths[slot] && strcmp(cache->paths[slot], source_path) != 0) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Keep the in-memory table at most half full
+static bool build_cache_reserve(BuildCache* cache) {
+    if ((cache->count + 1) * 2 <= cache->capacity) return true;
+    
+    BuildCache grown = *cache;
+    grown.capacity = cache->capacity ? cache->capacity * 2 : 64;
+    grown.paths = calloc(grown.capacity, sizeof(char*));
+    grown.entries = calloc(grown.capacity, sizeof(CacheEntry*));
+    if (!grown.paths || !grown.entries) {
+        free(grown.paths);
+        free(grown.entries);
+        return false;
+    }
+    
+    for (size_t i = 0; i < cache->capacity; i++) {
+        if (!cache->paths[i]) continue;
+        size_t slot = build_cache_slot(&grown, cache->paths[i]);
+        grown.paths[slot] = cache->paths[i];
+        grown.entries[slot] = cache->entries[i];
+    }
+    
+    free(cache->paths);
+    free(cache->entries);
+    *cache = grown;
+    return true;
+}
+
+// Entry of a source file, by canonical path (NULL if none can be read)
+CacheEntry* build_cache_load(BuildCache* cache, const char* source_path) {
+    if (!cache || !source_path) return NULL;
+    
+    if (!cache->directory) {
+        if (cache->count == 0) return NULL;
+        CacheEntry* entry = cache->entries[build_cache_slot(cache, source_path)];
+        return entry ? cache_entry_copy(entry) : NULL;
+    }
+    
+    char* path = build_cache_entry_path(cache, source_path, "");
+    FILE* file = path ? fopen(path, "rb") : NULL;
+    free(path);
+    if (!file) return NULL;
+    
+    CacheEntry* entry = calloc(1, sizeof(CacheEntry));
+    char line[1024];
+    int count = 0;
+    size_t length = 0;
+    
+    // Entries name their source, which tells hash collisions apart
+    bool ok = entry && build_cache_read_line(file, BUILD_CACHE_MAGIC) &&
+              build_cache_read_line(file, source_path) &&
+              build_cache_read_hash(file, "source", &entry->source_hash) &&
+              build_cache_read_hash(file, "key", &entry->key) &&
+              build_cache_read_hash(file, "output", &entry->output_hash) &&
+              fscanf(file, "imports %d\n", &count) == 1 && count >= 0;
+    
+    if (ok && count > 0) {
+        entry->imports = calloc(count, sizeof(char*));
+        ok = entry->imports != NULL;
+    }
+    for (int i = 0; ok && i < count; i++) {
+        ok = fgets(line, sizeof(line), file) != NULL;
+        if (ok) {
+            line[strcspn(line, "\n")] = '\0';
+            entry->imports[i] = strdup(line);
+            ok = entry->imports[i] != NULL;
+            entry->import_count++;
+        }
+    }
+    
+    // Exactly one newline precedes the text, which may start with blanks
+    ok = ok && fscanf(file, "interface %zu", &length) == 1 && fgetc(file) == '\n';
+    if (ok) {
+        entry->interface = malloc(length + 1);
+        ok = entry->interface && fread(entry->interface, 1, length, file) == length;
+        if (ok) entry->interface[length] = '\0';
+    }
+    
+    fclose(file);
+    if (!ok) {
+        cache_entry_destroy(entry);
+        return NULL;
+    }
+    return entry;
+}
+
+// Store the entry of a source file, replacing the previous one atomically
+bool build_cache_store(BuildCache* cache, const char* source_path, const CacheEntry* entry) {
+    if (!cache || !source_path || !entry) return false;
+    
+    if (!cache->directory) {
+        CacheEntry* copy = cache_entry_copy(entry);
+        if (!copy || !build_cache_reserve(cache)) {
+            cache_entry_destroy(copy);
+            return false;
+        }
+        
+        size_t slot = build_cache_slot(cache, source_path);
+        if (!cache->paths[slot]) {
+            cache->paths[slot] = strdup(source_path);
+            if (!cache->paths[slot]) {
+                cache_entry_destroy(copy);
+                return false;
+            }
+            cache->count++;
+        }
+        cache_entry_destroy(cache->entries[slot]);
+        cache->entries[slot] = copy;
+        return true;
+    }
+    
+    char* path = build_cache_entry_path(cache, source_path, "");
+    char* temporary = build_cache_entry_path(cache, source_path, ".tmp");
+    FILE* file = path && temporary ? fopen(temporary, "wb") : NULL;
+    bool ok = file != NULL;
+    
+    if (ok) {
+        const char* interface = entry->interface ? entry->interface : "";
+        fprintf(file, BUILD_CACHE_MAGIC "\n%s\n", source_path);
+        fprintf(file, "source %016" PRIx64 "\n", entry->source_hash);
+        fprintf(file, "key %016" PRIx64 "\n", entry->key);
+        fprintf(file, "output %016" PRIx64 "\n", entry->output_hash);
+        fprintf(file, "imports %d\n", entry->import_count);
+        for (int i = 0; i < entry->import_count; i++) {
+            fprintf(file, "%s\n", entry->imports[i]);
+        }
+        fprintf(file, "interface %zu\n%s", strlen(interface), interface);
+        
+        ok = !ferror(file);
+        ok = fclose(file) == 0 && ok;
+        ok = ok && rename(temporary, path) == 0;
+        if (!ok) remove(temporary);
+    }
+    
+    free(path);
+    free(temporary);
+    return ok;
+}
@@ -0,0 +1,54 @@
+#ifndef BUILD_CACHE_H
+#define BUILD_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// On-disk cache of compiled modules (--cache-dir).
+// Each source file has an entry describing its last successful compilation:
+// the hash of the source, the user modules it imports, its key (a hash of
+// the source, the compiler build, the build mode and the interfaces of its
+// imports), the hash of the C file it produced and its interface (its
+// section of the shared header). A module whose key matches and whose C file
+// is intact is neither analyzed nor generated again; while its source is
+// unchanged its imports come from the entry, so it is not even parsed.
+
+#define BUILD_CACHE_SEED 0xcbf29ce484222325ULL  // FNV-1a offset basis
+
+typedef struct CacheEntry {
+    uint64_t source_hash;
+    uint64_t key;
+    uint64_t output_hash;
+    char** imports;            // Module paths of the imported user modules
+    int import_count;
+    char* interface;           // Section of the shared header ("" without one)
+} CacheEntry;
+
+typedef struct BuildCache {
+    char* directory;           // NULL: entries are kept in memory
+    char** paths;              // In memory: open addressing by source path
+    CacheEntry** entries;
+    size_t capacity;           // Power of two
+    size_t count;
+} BuildCache;
+
+// Open a cache directory, creating it if needed; without a directory the
+// cache lives in memory, as in the compile server (NULL on failure)
+BuildCache* build_cache_open(const char* directory);
+void build_cache_close(BuildCache* cache);
+
+// Entry of a source file, by canonical path (NULL if none can be read).
+// Storing replaces the entry atomically.
+CacheEntry* build_cache_load(BuildCache* cache, const char* source_path);
+bool build_cache_store(BuildCache* cache, const char* source_path, const CacheEntry* entry);
+void cache_entry_destroy(CacheEntry* entry);
+
+// FNV-1a over data, continuing from hash (start with BUILD_CACHE_SEED)
+uint64_t build_cache_hash(uint64_t hash, const void* data, size_t length);
+uint64_t build_cache_hash_string(uint64_t hash, const char* text);
+
+// Hash of a file's contents; false if it cannot be read
+bool build_cache_hash_file(const char* path, uint64_t* hash);
+
+#endif // BUILD_CACHE_H
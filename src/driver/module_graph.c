@@ -0,0 +1,438 @@
+#define _GNU_SOURCE
+#include "module_graph.h"
+#include "build_cache.h"
+#include "../semantic/import_system.h"
+#include "../utils/string_builder.h"
+#include "../utils/thread_pool.h"
+#include "../utils/timing.h"
+#include "../utils/log.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Create an empty graph
+ModuleGraph* module_graph_create(void) {
+    return calloc(1, sizeof(ModuleGraph));
+}
+
+// Destroy the graph with every module's source, parser and analysis
+void module_graph_destroy(ModuleGraph* graph) {
+    if (!graph) return;
+    
+    for (int i = 0; i < graph->count; i++) {
+        Module* module = &graph->modules[i];
+        semantic_destroy(module->semantic);
+        parser_destroy(module->parser);
+        lexer_destroy(module->lexer);
+        source_file_close(&module->source);
+        cache_entry_destroy(module->cached);
+        free(module->interface);
+        free(module->imports);
+        free(module->name);
+        free(module->path);
+        free(module->key);
+    }
+    
+    for (int i = 0; i < graph->search_path_count; i++) {
+        free(graph->search_paths[i]);
+    }
+    
+    free(graph->modules);
+    free(graph->search_paths);
+    free(graph->order);
+    free(graph);
+}
+
+// Add a directory to the search path (once)
+bool module_graph_add_search_path(ModuleGraph* graph, const char* directory) {
+    if (!graph || !directory) return false;
+    
+    for (int i = 0; i < graph->search_path_count; i++) {
+        if (strcmp(graph->search_paths[i], directory) == 0) return true;
+    }
+    
+    char** paths = realloc(graph->search_paths, (graph->search_path_count + 1) * sizeof(char*));
+    if (!paths) return false;
+    graph->search_paths = paths;
+    
+    paths[graph->search_path_count] = strdup(directory);
+    if (!paths[graph->search_path_count]) return false;
+    graph->search_path_count++;
+    return true;
+}
+
+// Index of the module stored in `path`, adding it if it is new
+static int module_graph_intern(ModuleGraph* graph, const char* name, const char* path) {
+    char canonical[PATH_MAX];
+    char* key = strdup(realpath(path, canonical) ? canonical : path);
+    if (!key) return -1;
+    
+    for (int i = 0; i < graph->count; i++) {
+        if (strcmp(graph->modules[i].key, key) == 0) {
+            free(key);
+            return i;
+        }
+    }
+    
+    if (graph->count >= graph->capacity) {
+        int new_capacity = graph->capacity ? graph->capacity * 2 : 16;
+        Module* modules = realloc(graph->modules, new_capacity * sizeof(Module));
+        if (!modules) {
+            free(key);
+            return -1;
+        }
+        graph->modules = modules;
+        graph->capacity = new_capacity;
+    }
+    
+    Module* module = &graph->modules[graph->count];
+    memset(module, 0, sizeof(Module));
+    module->name = strdup(name);
+    module->path = strdup(path);
+    module->key = key;
+    if (!module->name || !module->path) {
+        free(module->name);
+        free(module->path);
+        free(key);
+        return -1;
+    }
+    
+    return graph->count++;
+}
+
+// Copy of the first `length` bytes of text
+static char* module_copy_prefix(const char* text, size_t length) {
+    char* copy = malloc(length + 1);
+    if (copy) {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+// Add a file named on the command line
+bool module_graph_add_root(ModuleGraph* graph, const char* path) {
+    if (!graph || !path) return false;
+    
+    // Module name: the file name without directory and extension
+    const char* slash = strrchr(path, '/');
+    const char* base = slash ? slash + 1 : path;
+    const char* dot = strrchr(base, '.');
+    size_t length = dot && dot > base ? (size_t)(dot - base) : strlen(base);
+    
+    char* name = module_copy_prefix(base, length);
+    char* directory = slash ? module_copy_prefix(path, slash - path + (slash == path)) : strdup(".");
+    bool ok = name && directory && module_graph_add_search_path(graph, directory) &&
+              module_graph_intern(graph, name, path) >= 0;
+    
+    free(name);
+    free(directory);
+    return ok;
+}
+
+// Record that `from` imports `to`
+static bool module_add_import(Module* from, int to) {
+    for (int i = 0; i < from->import_count; i++) {
+        if (from->imports[i] == to) return true;
+    }
+    
+    if (from->import_count >= from->import_capacity) {
+        int new_capacity = from->import_capacity ? from->import_capacity * 2 : 4;
+        int* imports = realloc(from->imports, new_capacity * sizeof(int));
+        if (!imports) return false;
+        from->imports = imports;
+        from->import_capacity = new_capacity;
+    }
+    
+    from->imports[from->import_count++] = to;
+    return true;
+}
+
+// Modules parsed on worker threads
+typedef struct ModuleParse {
+    ModuleGraph* graph;
+    const int* modules;            // Module indices
+    int jobs;                      // Threads per module
+} ModuleParse;
+
+static void module_parse_job(void* arg, int index, int worker) {
+    (void)worker;
+    ModuleParse* parse = arg;
+    Module* module = &parse->graph->modules[parse->modules[index]];
+    if (!source_file_is_open(&module->source) || module->ast) return;
+    
+    if (module->source.stream) {
+        module->lexer = lexer_create_stream(module->source.stream, SOURCE_STREAM_CHUNK);
+    } else {
+        module->lexer = lexer_create_buffer(module->source.data, module->source.length);
+    }
+    module->parser = module->lexer ? parser_create(module->lexer) : NULL;
+    if (module->parser) {
+        module->parser->jobs = parse->jobs;
+        module->ast = parser_parse(module->parser);
+    }
+}
+
+// Parse modules on up to `jobs` threads; errors are logged in the given order
+bool module_graph_parse(ModuleGraph* graph, const int* modules, int count, int jobs) {
+    if (!graph || !modules) return false;
+    if (count == 0) return true;
+    
+    int phase = timing_begin("parse");
+    ModuleParse parse = { graph, modules, count == 1 ? jobs : 1 };
+    thread_pool_run(jobs, count, module_parse_job, &parse);
+    timing_end(phase);
+    
+    bool success = true;
+    for (int i = 0; i < count; i++) {
+        Module* module = &graph->modules[modules[i]];
+        if (!source_file_is_open(&module->source)) {
+            success = false;
+        } else if (!module->parser) {
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: Failed to create parser for '%s'\n", module->path);
+            success = false;
+        } else if (parser_has_error(module->parser)) {
+            LOG_ERROR(LOG_CAT_PARSER, "Parse failed with errors in %s:\n", module->path);
+            LOG_ERROR(LOG_CAT_PARSER, "%s\n", parser_get_error(module->parser));
+            success = false;
+        } else if (!module->ast) {
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: Failed to parse '%s'\n", module->path);
+            success = false;
+        }
+    }
+    return success;
+}
+
+// Record that module `index` imports the module `name` stored in `path`
+static bool module_graph_add_import(ModuleGraph* graph, int index, const char* name, const char* path) {
+    int target = module_graph_intern(graph, name, path);
+    if (target < 0 || !module_add_import(&graph->modules[index], target)) return false;
+    graph->modules[target].imported = true;
+    
+    // A root imported by module path is registered under that path
+    if (strcmp(graph->modules[target].name, name) != 0) {
+        free(graph->modules[target].name);
+        graph->modules[target].name = strdup(name);
+        return graph->modules[target].name != NULL;
+    }
+    return true;
+}
+
+// Add the user module named by an #include of module `index` to the graph.
+// Builtin modules are skipped; "#include app::util::add" imports app::util.
+static bool module_graph_resolve_include(ModuleGraph* graph, int index, ASTNode* include) {
+    if (!include->value || strncmp(include->value, "#include ", 9) != 0) return true;
+    
+    Import* import = import_parse_statement(include->value + 9);
+    if (!import) return false;
+    
+    bool ok = true;
+    if (!import->function_name && !import_is_builtin_module(import->module_path)) {
+        char* name = import->module_path;
+        char* path = import_resolve_module(name, (const char* const*)graph->search_paths,
+                                           graph->search_path_count);
+        
+        // A function of a user module: resolve the enclosing module
+        char* separator = strstr(name, "::") ? strrchr(name, ':') - 1 : NULL;
+        if (!path && separator) {
+            *separator = '\0';
+            path = import_resolve_module(name, (const char* const*)graph->search_paths,
+                                         graph->search_path_count);
+            if (!path) *separator = ':';
+        }
+        
+        if (path) {
+            ok = module_graph_add_import(graph, index, name, path);
+        } else {
+            Module* module = &graph->modules[index];
+            int line, column;
+            line_index_position(module->lexer ? &module->lexer->lines : NULL, include->location, &line, &column);
+            LOG_ERROR(LOG_CAT_DRIVER, "%s:%d:%d: error: Cannot find module '%s'\n",
+                      module->path, line, column, name);
+            ok = false;
+        }
+        free(path);
+    }
+    
+    free(import->module_path);
+    free(import->function_name);
+    free(import->alias);
+    free(import);
+    return ok;
+}
+
+// Take the imports of module `index` from its cache entry. Fails without
+// changing the graph if one of them no longer resolves.
+static bool module_graph_resolve_cached(ModuleGraph* graph, int index) {
+    CacheEntry* entry = graph->modules[index].cached;
+    char** paths = calloc(entry->import_count + 1, sizeof(char*));
+    bool ok = paths != NULL;
+    
+    for (int i = 0; ok && i < entry->import_count; i++) {
+        paths[i] = import_resolve_module(entry->imports[i], (const char* const*)graph->search_paths,
+                                         graph->search_path_count);
+        ok = paths[i] != NULL;
+    }
+    for (int i = 0; ok && i < entry->import_count; i++) {
+        ok = module_graph_add_import(graph, index, entry->imports[i], paths[i]);
+    }
+    
+    for (int i = 0; paths && i < entry->import_count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    return ok;
+}
+
+// Read a wave's sources and look up their cache entries
+static void module_graph_read(ModuleGraph* graph, int first, int last) {
+    int phase = timing_begin("read");
+    for (int i = first; i < last; i++) {
+        Module* module = &graph->modules[i];
+        if (!source_file_open(&module->source, module->path, graph->stream_sources)) continue;
+        
+        // A streamed source is hashed in a chunked pass of its own
+        if (module->source.data) {
+            module->source_hash = build_cache_hash(BUILD_CACHE_SEED, module->source.data, module->source.length);
+        } else if (!build_cache_hash_file(module->path, &module->source_hash)) {
+            module->source_hash = 0;
+        }
+        module->cached = build_cache_load(graph->cache, module->key);
+        if (module->cached && module->cached->source_hash != module->source_hash) {
+            cache_entry_destroy(module->cached);
+            module->cached = NULL;
+        }
+    }
+    timing_end(phase);
+}
+
+// Read and parse all reachable modules, one wave of new modules at a time
+bool module_graph_load(ModuleGraph* graph, int jobs) {
+    if (!graph) return false;
+    
+    bool success = true;
+    int first = 0;
+    while (first < graph->count) {
+        int last = graph->count;
+        module_graph_read(graph, first, last);
+        
+        // Modules with a cache entry wait until their AST is needed
+        int* pending = calloc(last - first, sizeof(int));
+        if (!pending) return false;
+        
+        int pending_count = 0;
+        for (int i = first; i < last; i++) {
+            if (!graph->modules[i].cached) pending[pending_count++] = i;
+        }
+        success = module_graph_parse(graph, pending, pending_count, jobs) && success;
+        free(pending);
+        
+        // Imports in module order, which may add the next wave
+        for (int i = first; i < last; i++) {
+            if (graph->modules[i].cached) {
+                if (module_graph_resolve_cached(graph, i)) continue;
+                
+                // A module moved: rediscover the imports from the source
+                cache_entry_destroy(graph->modules[i].cached);
+                graph->modules[i].cached = NULL;
+                if (!module_graph_parse(graph, &i, 1, 1)) {
+                    success = false;
+                    continue;
+                }
+            }
+            
+            Module* module = &graph->modules[i];
+            if (!module->ast || parser_has_error(module->parser)) continue;
+            
+            // Adding modules may move graph->modules; the AST stays put
+            ASTNode* ast = module->ast;
+            for (int j = 0; j < ast->child_count; j++) {
+                ASTNode* child = ast->children[j];
+                if (child->type == AST_PREPROCESSOR && !module_graph_resolve_include(graph, i, child)) {
+                    success = false;
+                }
+            }
+        }
+        
+        first = last;
+    }
+    
+    return success;
+}
+
+// Level of a module; -1 if it is on an import cycle (which is logged).
+// `stack` holds the modules whose level is being computed.
+static int module_graph_level(ModuleGraph* graph, int index, char* state, int* stack, int depth) {
+    Module* module = &graph->modules[index];
+    if (state[index] == 2) return module->level;
+    
+    if (state[index] == 1) {
+        StringBuilder cycle;
+        string_builder_init(&cycle);
+        
+        int start = depth;
+        while (start > 0 && stack[start - 1] != index) start--;
+        for (int i = start - 1; i < depth; i++) {
+            string_builder_append(&cycle, graph->modules[stack[i]].name);
+            string_builder_append(&cycle, " -> ");
+        }
+        string_builder_append(&cycle, module->name);
+        
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Import cycle: %s\n", cycle.data ? cycle.data : module->name);
+        string_builder_free(&cycle);
+        return -1;
+    }
+    
+    state[index] = 1;
+    stack[depth] = index;
+    
+    int level = 0;
+    for (int i = 0; i < module->import_count; i++) {
+        int imported = module_graph_level(graph, module->imports[i], state, stack, depth + 1);
+        if (imported < 0) return -1;
+        if (imported + 1 > level) level = imported + 1;
+    }
+    
+    state[index] = 2;
+    module->level = level;
+    return level;
+}
+
+// Order modules by level (and by index within a level)
+bool module_graph_sort(ModuleGraph* graph) {
+    if (!graph) return false;
+    
+    char* state = calloc(graph->count + 1, 1);
+    int* stack = calloc(graph->count + 1, sizeof(int));
+    int* order = calloc(graph->count + 1, sizeof(int));
+    bool success = state && stack && order;
+    
+    graph->level_count = 0;
+    for (int i = 0; success && i < graph->count; i++) {
+        int level = module_graph_level(graph, i, state, stack, 0);
+        if (level < 0) {
+            success = false;
+        } else if (level + 1 > graph->level_count) {
+            graph->level_count = level + 1;
+        }
+    }
+    
+    if (success) {
+        int position = 0;
+        for (int level = 0; level < graph->level_count; level++) {
+            for (int i = 0; i < graph->count; i++) {
+                if (graph->modules[i].level == level) order[position++] = i;
+            }
+        }
+        
+        free(graph->order);
+        graph->order = order;
+        order = NULL;
+    }
+    
+    free(state);
+    free(stack);
+    free(order);
+    return success;
+}
@@ -0,0 +1,79 @@
+#ifndef MODULE_GRAPH_H
+#define MODULE_GRAPH_H
+
+#include "../lexer/lexer.h"
+#include "../parser/parser.h"
+#include "../ast/ast.h"
+#include "../semantic/semantic.h"
+#include "source_file.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+struct BuildCache;
+struct CacheEntry;
+
+// Modules of a build and the imports between them.
+// The graph starts from the files named on the command line (roots) and
+// takes in every user module they import, directly or not:
+// "#include app::util" names app/util.ec in the search path. Builtin modules
+// (core::*) are not part of the graph. Modules are read and parsed in waves
+// (the roots, then the modules they import, ...), each wave on a thread
+// pool. Sorting places every module one level above its highest import, so
+// the modules of one level can be analyzed at the same time.
+// With a build cache, a module whose source matches its cache entry takes
+// its imports from the entry and is parsed only if something needs its AST.
+
+typedef struct Module {
+    char* name;                // Module path ("app::util"); the file stem for a root
+    char* path;                // Source file
+    char* key;                 // Canonical path, identifies the file
+    SourceFile source;         // Mapped, read or streamed text
+    uint64_t source_hash;
+    struct CacheEntry* cached; // Cache entry matching the source, or NULL
+    Lexer* lexer;
+    Parser* parser;
+    ASTNode* ast;
+    SemanticContext* semantic; // Owned; set up by the driver
+    int* imports;              // Indices of imported modules
+    int import_count;
+    int import_capacity;
+    int level;                 // 0 without user imports, else 1 + highest imported level
+    bool imported;             // Some module imports it (its functions take prefixed C names)
+    bool registered;           // Exported through the import registry
+    bool up_to_date;           // Output reused from the cache entry
+    uint64_t cache_key;        // Source, compiler and imported interfaces (set by the driver)
+    char* interface;           // Section of the shared header (set by the driver)
+} Module;
+
+typedef struct ModuleGraph {
+    Module* modules;           // Roots first, then in discovery order
+    int count;
+    int capacity;
+    char** search_paths;       // Directories of the roots, then added ones
+    int search_path_count;
+    int* order;                // Module indices by level (filled by module_graph_sort)
+    int level_count;
+    struct BuildCache* cache;  // Not owned; NULL without --cache-dir
+    bool stream_sources;       // Lex sources in chunks instead of mapping them
+} ModuleGraph;
+
+ModuleGraph* module_graph_create(void);
+void module_graph_destroy(ModuleGraph* graph);
+
+// A root's directory becomes a search path; add roots before other paths
+bool module_graph_add_root(ModuleGraph* graph, const char* path);
+bool module_graph_add_search_path(ModuleGraph* graph, const char* directory);
+
+// Read and parse every module reachable from the roots on up to `jobs`
+// threads. Unreadable files, parse errors and imports of unknown modules are
+// logged; returns false if there were any.
+bool module_graph_load(ModuleGraph* graph, int jobs);
+
+// Parse modules whose imports came from the cache (indices; logs errors)
+bool module_graph_parse(ModuleGraph* graph, const int* modules, int count, int jobs);
+
+// Assign levels and fill order; returns false (and logs the cycle) if the
+// imports form a cycle
+bool module_graph_sort(ModuleGraph* graph);
+
+#endif // MODULE_GRAPH_H
@@ -0,0 +1,313 @@
+#define _GNU_SOURCE
+#include "server.h"
+#include "../utils/log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define SERVER_MAX_ARGUMENTS 4096
+#define SERVER_MAX_FRAME (1u << 20)   // Largest frame either side accepts
+#define SERVER_CHUNK 65536            // Output is relayed in chunks of this size
+#define SERVER_TIMEOUT 30             // Seconds a client may stall a read or write
+
+static volatile sig_atomic_t server_stopping = 0;
+
+static void server_stop(int signal_number) {
+    (void)signal_number;
+    server_stopping = 1;
+}
+
+// Write all of data; false if the peer went away
+static bool server_write_all(int fd, const void* data, size_t length) {
+    const char* bytes = data;
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// Read exactly length bytes; false on end of stream or error
+static bool server_read_all(int fd, void* data, size_t length) {
+    char* bytes = data;
+    while (length > 0) {
+        ssize_t count = read(fd, bytes, length);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        bytes += count;
+        length -= (size_t)count;
+    }
+    return true;
+}
+
+static bool server_send_frame(int fd, ServerFrame kind, const void* data, uint32_t length) {
+    unsigned char header[5];
+    header[0] = (unsigned char)kind;
+    memcpy(header + 1, &length, sizeof(length));
+    return server_write_all(fd, header, sizeof(header)) &&
+           (length == 0 || server_write_all(fd, data, length));
+}
+
+// Next frame's payload, NUL-terminated (caller frees; NULL on error)
+static char* server_read_frame(int fd, ServerFrame* kind, uint32_t* length) {
+    unsigned char header[5];
+    if (!server_read_all(fd, header, sizeof(header))) return NULL;
+    
+    *kind = (ServerFrame)header[0];
+    memcpy(length, header + 1, sizeof(*length));
+    if (*length > SERVER_MAX_FRAME) return NULL;
+    
+    char* payload = malloc(*length + 1);
+    if (!payload || !server_read_all(fd, payload, *length)) {
+        free(payload);
+        return NULL;
+    }
+    payload[*length] = '\0';
+    return payload;
+}
+
+// Address of a socket path; false if the path is too long
+static bool server_address(const char* socket_path, struct sockaddr_un* address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (!socket_path || strlen(socket_path) >= sizeof(address->sun_path)) return false;
+    
+    strcpy(address->sun_path, socket_path);
+    return true;
+}
+
+// Connected socket, or -1
+static int server_connect(const char* socket_path) {
+    struct sockaddr_un address;
+    if (!server_address(socket_path, &address)) return -1;
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Relay a captured stream
+static bool server_send_stream(int fd, ServerFrame kind, FILE* stream) {
+    char buffer[SERVER_CHUNK];
+    size_t length;
+    
+    rewind(stream);
+    while ((length = fread(buffer, 1, sizeof(buffer), stream)) > 0) {
+        if (!server_send_frame(fd, kind, buffer, (uint32_t)length)) return false;
+    }
+    return true;
+}
+
+// Run one command with stdout and stderr redirected to the given files
+static int server_run_captured(ServerCommand command, int argc, char* argv[], FILE* out, FILE* err) {
+    fflush(stdout);
+    fflush(stderr);
+    int saved_out = dup(STDOUT_FILENO);
+    int saved_err = dup(STDERR_FILENO);
+    if (saved_out < 0 || saved_err < 0 ||
+        dup2(fileno(out), STDOUT_FILENO) < 0 || dup2(fileno(err), STDERR_FILENO) < 0) {
+        if (saved_out >= 0) close(saved_out);
+        if (saved_err >= 0) close(saved_err);
+        fprintf(err, "Error: Cannot capture compiler output\n");
+        return 1;
+    }
+    
+    int status = command(argc, argv);
+    
+    fflush(stdout);
+    fflush(stderr);
+    dup2(saved_out, STDOUT_FILENO);
+    dup2(saved_err, STDERR_FILENO);
+    close(saved_out);
+    close(saved_err);
+    return status;
+}
+
+// Read a request from a client, run it and send back its output and status
+static void server_handle(int client, ServerCommand command) {
+    char* argv[SERVER_MAX_ARGUMENTS + 1];
+    int argc = 0;
+    char* directory = NULL;
+    bool ok = true;
+    
+    while (ok && !directory) {
+        ServerFrame kind;
+        uint32_t length;
+        char* payload = server_read_frame(client, &kind, &length);
+        if (payload && kind == SERVER_FRAME_ARGUMENT && argc < SERVER_MAX_ARGUMENTS) {
+            argv[argc++] = payload;
+        } else if (payload && kind == SERVER_FRAME_DIRECTORY) {
+            directory = payload;
+        } else {
+            free(payload);
+            ok = false;
+        }
+    }
+    argv[argc] = NULL;
+    
+    FILE* out = ok ? tmpfile() : NULL;
+    FILE* err = ok ? tmpfile() : NULL;
+    int32_t status = 1;
+    if (!out || !err) {
+        ok = false;
+    } else if (argc == 0 || chdir(directory) != 0) {
+        fprintf(err, "Error: Cannot enter directory '%s'\n", directory);
+    } else {
+        status = server_run_captured(command, argc, argv, out, err);
+    }
+    
+    // A connection that closes without a request is a liveness probe
+    bool sent = ok && server_send_stream(client, SERVER_FRAME_STDOUT, out) &&
+                server_send_stream(client, SERVER_FRAME_STDERR, err) &&
+                server_send_frame(client, SERVER_FRAME_STATUS, &status, sizeof(status));
+    if (ok && !sent) {
+        LOG_WARN(LOG_CAT_DRIVER, "Warning: Client left before its reply\n");
+    }
+    
+    if (out) fclose(out);
+    if (err) fclose(err);
+    for (int i = 0; i < argc; i++) {
+        free(argv[i]);
+    }
+    free(directory);
+}
+
+// Serve requests until SIGINT or SIGTERM
+int server_run(const char* socket_path, ServerCommand command) {
+    struct sockaddr_un address;
+    if (!server_address(socket_path, &address)) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Invalid socket path '%s'\n", socket_path ? socket_path : "");
+        return 1;
+    }
+    
+    // Take over a stale socket, but not a live server or another kind of file
+    struct stat info;
+    if (lstat(socket_path, &info) == 0) {
+        int live = S_ISSOCK(info.st_mode) ? server_connect(socket_path) : -1;
+        if (!S_ISSOCK(info.st_mode) || live >= 0) {
+            if (live >= 0) close(live);
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: '%s' is already in use\n", socket_path);
+            return 1;
+        }
+        unlink(socket_path);
+    }
+    
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, 64) != 0) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot listen on '%s': %s\n", socket_path, strerror(errno));
+        if (listener >= 0) close(listener);
+        return 1;
+    }
+    
+    // No SA_RESTART: a signal interrupts accept() and ends the loop
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = server_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    
+    // Requests run in their client's directory; come back here after each
+    // one, so relative paths (the socket's included) keep their meaning
+    int home = open(".", O_RDONLY | O_DIRECTORY);
+    if (home < 0) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot open the working directory: %s\n", strerror(errno));
+        close(listener);
+        unlink(socket_path);
+        return 1;
+    }
+    
+    // A client that goes quiet gives up its request rather than the server
+    struct timeval timeout = { SERVER_TIMEOUT, 0 };
+    
+    LOG_INFO(LOG_CAT_DRIVER, "Serving compile requests on %s\n", socket_path);
+    int status = 0;
+    while (!server_stopping) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: accept failed: %s\n", strerror(errno));
+            status = 1;
+            break;
+        }
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        
+        server_handle(client, command);
+        close(client);
+        if (fchdir(home) != 0) {
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot return to the working directory: %s\n", strerror(errno));
+            status = 1;
+            break;
+        }
+    }
+    
+    close(home);
+    close(listener);
+    unlink(socket_path);
+    return status;
+}
+
+// Send one command line to a server and relay its output
+int server_request(const char* socket_path, int argc, char* argv[]) {
+    int fd = server_connect(socket_path);
+    if (fd < 0) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot connect to compile server '%s'\n", socket_path);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    
+    char directory[PATH_MAX];
+    bool ok = getcwd(directory, sizeof(directory)) != NULL;
+    for (int i = 0; ok && i < argc; i++) {
+        ok = server_send_frame(fd, SERVER_FRAME_ARGUMENT, argv[i], (uint32_t)strlen(argv[i]));
+    }
+    ok = ok && server_send_frame(fd, SERVER_FRAME_DIRECTORY, directory, (uint32_t)strlen(directory));
+    
+    int32_t status = 1;
+    bool done = false;
+    while (ok && !done) {
+        ServerFrame kind;
+        uint32_t length;
+        char* payload = server_read_frame(fd, &kind, &length);
+        if (!payload) {
+            ok = false;
+        } else if (kind == SERVER_FRAME_STDOUT) {
+            fwrite(payload, 1, length, stdout);
+        } else if (kind == SERVER_FRAME_STDERR) {
+            fwrite(payload, 1, length, stderr);
+        } else if (kind == SERVER_FRAME_STATUS && length == sizeof(status)) {
+            memcpy(&status, payload, sizeof(status));
+            done = true;
+        } else {
+            ok = false;
+        }
+        free(payload);
+    }
+    
+    close(fd);
+    if (!done) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Compile server '%s' did not answer\n", socket_path);
+        return 1;
+    }
+    return status;
+}
@@ -0,0 +1,37 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// Compile server (--server=SOCKET) and its thin client (--connect=SOCKET).
+// The server is one long-lived process listening on a Unix socket. Each
+// request carries a command line and a working directory; the server runs
+// it as a normal compilation and sends back its stdout, its stderr and its
+// exit status. Requests are served one at a time, so process-wide state
+// (interned strings, types, the build cache) stays warm between them; the
+// caller's command may reset the string and type tables when they grow.
+// The server returns to its own directory after each request and drops a
+// client that stalls a read or write for SERVER_TIMEOUT seconds.
+//
+// Frames on the wire: a kind byte, a 32-bit length and the payload.
+// Request: one SERVER_FRAME_ARGUMENT per argument, then SERVER_FRAME_DIRECTORY.
+// Reply: SERVER_FRAME_STDOUT / SERVER_FRAME_STDERR chunks, then
+// SERVER_FRAME_STATUS with the exit status.
+
+typedef enum {
+    SERVER_FRAME_ARGUMENT = 1,
+    SERVER_FRAME_DIRECTORY,
+    SERVER_FRAME_STDOUT,
+    SERVER_FRAME_STDERR,
+    SERVER_FRAME_STATUS
+} ServerFrame;
+
+// A compilation, as main would run it
+typedef int (*ServerCommand)(int argc, char* argv[]);
+
+// Serve requests until SIGINT or SIGTERM; returns the exit status
+int server_run(const char* socket_path, ServerCommand command);
+
+// Send one command line to a server and relay its output; returns the
+// compilation's exit status (1 if the server cannot be reached)
+int server_request(const char* socket_path, int argc, char* argv[]);
+
+#endif // SERVER_H
@@ -0,0 +1,92 @@
+#define _GNU_SOURCE
+#include "source_file.h"
+#include "../utils/log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Read a whole file into memory (files that cannot be mapped)
+static bool source_file_read(SourceFile* source, int fd, size_t size_hint) {
+    size_t capacity = size_hint + 4096;   // Room to see the end of the file
+    char* data = malloc(capacity);
+    size_t length = 0;
+    while (data) {
+        if (length == capacity) {
+            char* grown = realloc(data, capacity * 2);
+            if (!grown) break;
+            data = grown;
+            capacity *= 2;
+        }
+        
+        ssize_t count = read(fd, data + length, capacity - length);
+        if (count <= 0) {
+            if (count == 0) {
+                source->copy = data;
+                source->data = data;
+                source->length = length;
+                return true;
+            }
+            break;
+        }
+        length += (size_t)count;
+    }
+    
+    free(data);
+    return false;
+}
+
+bool source_file_open(SourceFile* source, const char* path, bool stream) {
+    memset(source, 0, sizeof(*source));
+    
+    if (stream) {
+        source->stream = fopen(path, "rb");
+        if (!source->stream) {
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot open file '%s'\n", path);
+        }
+        return source->stream != NULL;
+    }
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot open file '%s'\n", path);
+        return false;
+    }
+    
+    // Empty files have nothing to map
+    struct stat info;
+    bool regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+    if (regular && info.st_size == 0) {
+        close(fd);
+        source->data = "";
+        return true;
+    }
+    
+    if (regular) {
+        void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+            source->mapping = mapping;
+            source->data = mapping;
+            source->length = (size_t)info.st_size;
+        }
+    }
+    
+    bool ok = source->data || source_file_read(source, fd, regular ? (size_t)info.st_size : 0);
+    close(fd);
+    if (!ok) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot read file '%s'\n", path);
+    }
+    return ok;
+}
+
+void source_file_close(SourceFile* source) {
+    if (!source) return;
+    
+    if (source->mapping) munmap(source->mapping, source->length);
+    if (source->stream) fclose(source->stream);
+    free(source->copy);
+    memset(source, 0, sizeof(*source));
+}
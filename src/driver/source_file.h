@@ -0,0 +1,32 @@
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Source text of a module, handed to the lexer as (data, length) without a
+// copy or a NUL terminator. A regular file is mapped read-only; a file that
+// cannot be mapped is read into memory. In streaming mode (--stream) the file
+// is only opened, and the lexer reads it in chunks.
+
+#define SOURCE_STREAM_CHUNK (64 * 1024)   // Chunk size of streamed sources
+
+typedef struct SourceFile {
+    const char* data;          // NULL when streamed or not open
+    size_t length;
+    FILE* stream;              // Streaming mode: the open file
+    void* mapping;             // mmap()ed region, or NULL
+    char* copy;                // Heap copy when the file could not be mapped
+} SourceFile;
+
+// Open a source file, logging why it cannot be read
+bool source_file_open(SourceFile* source, const char* path, bool stream);
+void source_file_close(SourceFile* source);
+
+// The file is open, mapped, read or streamed
+static inline bool source_file_is_open(const SourceFile* source) {
+    return source->data || source->stream;
+}
+
+#endif // SOURCE_FILE_H
@@ -1,33 +1,279 @@
 #include "lexer.h"
+#include "lexer_scan.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 #include <stdio.h>
 
-// Keywords array
-static const char* keywords[] = {
-    "fn", "struct", "enum", "if", "else", "for", "while", "return", 
-    "break", "continue", "auto", "null", "true", "false", "alloc", 
-    "delete", "sizeof", "const", "static", "global", "typedef", 
-    "switch", "case", "default",
+// Character classes used by the dispatch table below
+enum {
+    CC_ALPHA     = 1 << 0,   // [A-Za-z_]
+    CC_DIGIT     = 1 << 1,   // [0-9]
+    CC_SPACE     = 1 << 2,   // ' ' \t \n \r
+    CC_OPERATOR  = 1 << 3,   // + - * / % = ! < > & | ^ ~ ? : .
+    CC_DELIMITER = 1 << 4    // ( ) { } [ ] ; ,
+};
+
+#define CC_ALNUM (CC_ALPHA | CC_DIGIT)
+
+// 256-entry character class table, indexed by unsigned byte
+static const unsigned char char_class[256] = {
+    [' '] = CC_SPACE, ['\t'] = CC_SPACE, ['\n'] = CC_SPACE, ['\r'] = CC_SPACE,
+    
+    ['0'] = CC_DIGIT, ['1'] = CC_DIGIT, ['2'] = CC_DIGIT, ['3'] = CC_DIGIT, ['4'] = CC_DIGIT,
+    ['5'] = CC_DIGIT, ['6'] = CC_DIGIT, ['7'] = CC_DIGIT, ['8'] = CC_DIGIT, ['9'] = CC_DIGIT,
+    
+    ['a'] = CC_ALPHA, ['b'] = CC_ALPHA, ['c'] = CC_ALPHA, ['d'] = CC_ALPHA, ['e'] = CC_ALPHA,
+    ['f'] = CC_ALPHA, ['g'] = CC_ALPHA, ['h'] = CC_ALPHA, ['i'] = CC_ALPHA, ['j'] = CC_ALPHA,
+    ['k'] = CC_ALPHA, ['l'] = CC_ALPHA, ['m'] = CC_ALPHA, ['n'] = CC_ALPHA, ['o'] = CC_ALPHA,
+    ['p'] = CC_ALPHA, ['q'] = CC_ALPHA, ['r'] = CC_ALPHA, ['s'] = CC_ALPHA, ['t'] = CC_ALPHA,
+    ['u'] = CC_ALPHA, ['v'] = CC_ALPHA, ['w'] = CC_ALPHA, ['x'] = CC_ALPHA, ['y'] = CC_ALPHA,
+    ['z'] = CC_ALPHA,
+    ['A'] = CC_ALPHA, ['B'] = CC_ALPHA, ['C'] = CC_ALPHA, ['D'] = CC_ALPHA, ['E'] = CC_ALPHA,
+    ['F'] = CC_ALPHA, ['G'] = CC_ALPHA, ['H'] = CC_ALPHA, ['I'] = CC_ALPHA, ['J'] = CC_ALPHA,
+    ['K'] = CC_ALPHA, ['L'] = CC_ALPHA, ['M'] = CC_ALPHA, ['N'] = CC_ALPHA, ['O'] = CC_ALPHA,
+    ['P'] = CC_ALPHA, ['Q'] = CC_ALPHA, ['R'] = CC_ALPHA, ['S'] = CC_ALPHA, ['T'] = CC_ALPHA,
+    ['U'] = CC_ALPHA, ['V'] = CC_ALPHA, ['W'] = CC_ALPHA, ['X'] = CC_ALPHA, ['Y'] = CC_ALPHA,
+    ['Z'] = CC_ALPHA, ['_'] = CC_ALPHA,
+    
+    ['+'] = CC_OPERATOR, ['-'] = CC_OPERATOR, ['*'] = CC_OPERATOR, ['/'] = CC_OPERATOR,
+    ['%'] = CC_OPERATOR, ['='] = CC_OPERATOR, ['!'] = CC_OPERATOR, ['<'] = CC_OPERATOR,
+    ['>'] = CC_OPERATOR, ['&'] = CC_OPERATOR, ['|'] = CC_OPERATOR, ['^'] = CC_OPERATOR,
+    ['~'] = CC_OPERATOR, ['?'] = CC_OPERATOR, [':'] = CC_OPERATOR, ['.'] = CC_OPERATOR,
+    
+    ['('] = CC_DELIMITER, [')'] = CC_DELIMITER, ['{'] = CC_DELIMITER, ['}'] = CC_DELIMITER,
+    ['['] = CC_DELIMITER, [']'] = CC_DELIMITER, [';'] = CC_DELIMITER, [','] = CC_DELIMITER
+};
+
+#define CHAR_CLASS(c) (char_class[(unsigned char)(c)])
+
+// Keyword spellings, indexed by KeywordId
+static const char* keyword_names[KW_COUNT] = {
+    [KW_NONE] = NULL,
+    [KW_FN] = "fn", [KW_STRUCT] = "struct", [KW_ENUM] = "enum", [KW_IF] = "if",
+    [KW_ELSE] = "else", [KW_FOR] = "for", [KW_WHILE] = "while", [KW_RETURN] = "return",
+    [KW_BREAK] = "break", [KW_CONTINUE] = "continue", [KW_AUTO] = "auto", [KW_NULL] = "null",
+    [KW_TRUE] = "true", [KW_FALSE] = "false", [KW_ALLOC] = "alloc", [KW_DELETE] = "delete",
+    [KW_SIZEOF] = "sizeof", [KW_CONST] = "const", [KW_STATIC] = "static", [KW_GLOBAL] = "global",
+    [KW_TYPEDEF] = "typedef", [KW_SWITCH] = "switch", [KW_CASE] = "case", [KW_DEFAULT] = "default",
     // Types
-    "i8", "i16", "i32", "i64", "f32", "f64", "bool", "string", "char", "void",
-    NULL
+    [KW_I8] = "i8", [KW_I16] = "i16", [KW_I32] = "i32", [KW_I64] = "i64",
+    [KW_F32] = "f32", [KW_F64] = "f64", [KW_BOOL] = "bool", [KW_STRING] = "string",
+    [KW_CHAR] = "char", [KW_VOID] = "void"
 };
 
-// Create lexer
+// Operator spellings, indexed by OperatorId
+static const char* operator_names[OP_COUNT] = {
+    [OP_NONE] = NULL,
+    [OP_PLUS] = "+", [OP_MINUS] = "-", [OP_STAR] = "*", [OP_SLASH] = "/",
+    [OP_PERCENT] = "%", [OP_ASSIGN] = "=", [OP_BANG] = "!", [OP_LESS] = "<",
+    [OP_GREATER] = ">", [OP_AMPERSAND] = "&", [OP_PIPE] = "|", [OP_CARET] = "^",
+    [OP_TILDE] = "~", [OP_QUESTION] = "?", [OP_COLON] = ":", [OP_DOT] = ".",
+    [OP_EQUAL] = "==", [OP_NOT_EQUAL] = "!=", [OP_LESS_EQUAL] = "<=", [OP_GREATER_EQUAL] = ">=",
+    [OP_AND] = "&&", [OP_OR] = "||", [OP_INCREMENT] = "++", [OP_DECREMENT] = "--",
+    [OP_PLUS_ASSIGN] = "+=", [OP_MINUS_ASSIGN] = "-=", [OP_STAR_ASSIGN] = "*=",
+    [OP_SLASH_ASSIGN] = "/=", [OP_PERCENT_ASSIGN] = "%=", [OP_SHIFT_LEFT] = "<<",
+    [OP_SHIFT_RIGHT] = ">>", [OP_ARROW] = "->", [OP_SCOPE] = "::"
+};
+
+// One-character operators, indexed by unsigned byte (every CC_OPERATOR character)
+static const unsigned char single_operators[256] = {
+    ['+'] = OP_PLUS, ['-'] = OP_MINUS, ['*'] = OP_STAR, ['/'] = OP_SLASH,
+    ['%'] = OP_PERCENT, ['='] = OP_ASSIGN, ['!'] = OP_BANG, ['<'] = OP_LESS,
+    ['>'] = OP_GREATER, ['&'] = OP_AMPERSAND, ['|'] = OP_PIPE, ['^'] = OP_CARET,
+    ['~'] = OP_TILDE, ['?'] = OP_QUESTION, [':'] = OP_COLON, ['.'] = OP_DOT
+};
+
+// Two-character operator spelled first, second (OP_NONE if the pair is not one)
+static OperatorId operator_pair(char first, char second) {
+    switch (first) {
+        case '=': return second == '=' ? OP_EQUAL : OP_NONE;
+        case '!': return second == '=' ? OP_NOT_EQUAL : OP_NONE;
+        case '<': return second == '=' ? OP_LESS_EQUAL : second == '<' ? OP_SHIFT_LEFT : OP_NONE;
+        case '>': return second == '=' ? OP_GREATER_EQUAL : second == '>' ? OP_SHIFT_RIGHT : OP_NONE;
+        case '&': return second == '&' ? OP_AND : OP_NONE;
+        case '|': return second == '|' ? OP_OR : OP_NONE;
+        case '+': return second == '+' ? OP_INCREMENT : second == '=' ? OP_PLUS_ASSIGN : OP_NONE;
+        case '-':
+            if (second == '-') return OP_DECREMENT;
+            if (second == '=') return OP_MINUS_ASSIGN;
+            return second == '>' ? OP_ARROW : OP_NONE;
+        case '*': return second == '=' ? OP_STAR_ASSIGN : OP_NONE;
+        case '/': return second == '=' ? OP_SLASH_ASSIGN : OP_NONE;
+        case '%': return second == '=' ? OP_PERCENT_ASSIGN : OP_NONE;
+        case ':': return second == ':' ? OP_SCOPE : OP_NONE;
+        default: return OP_NONE;
+    }
+}
+
+// Perfect hash over the keyword set: every keyword lands in its own slot.
+// If you add a keyword, re-derive the multipliers so the table stays collision-free.
+#define KEYWORD_HASH_SIZE 64
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 8
+
+static inline unsigned int keyword_hash(const char* str, size_t length) {
+    return (2u * (unsigned char)str[0] +
+            22u * (unsigned char)str[1] +
+            9u * (unsigned char)str[length - 1] +
+            (unsigned int)length) & (KEYWORD_HASH_SIZE - 1);
+}
+
+static const struct {
+    const char* text;
+    unsigned char length;
+    KeywordId id;
+} keyword_table[KEYWORD_HASH_SIZE] = {
+    [3] = { "string", 6, KW_STRING },
+    [5] = { "true", 4, KW_TRUE },
+    [7] = { "f64", 3, KW_F64 },
+    [8] = { "sizeof", 6, KW_SIZEOF },
+    [9] = { "delete", 6, KW_DELETE },
+    [10] = { "alloc", 5, KW_ALLOC },
+    [13] = { "i64", 3, KW_I64 },
+    [14] = { "switch", 6, KW_SWITCH },
+    [17] = { "default", 7, KW_DEFAULT },
+    [23] = { "enum", 4, KW_ENUM },
+    [24] = { "break", 5, KW_BREAK },
+    [27] = { "for", 3, KW_FOR },
+    [28] = { "i8", 2, KW_I8 },
+    [30] = { "bool", 4, KW_BOOL },
+    [31] = { "static", 6, KW_STATIC },
+    [32] = { "fn", 2, KW_FN },
+    [35] = { "else", 4, KW_ELSE },
+    [37] = { "continue", 8, KW_CONTINUE },
+    [40] = { "global", 6, KW_GLOBAL },
+    [41] = { "const", 5, KW_CONST },
+    [43] = { "typedef", 7, KW_TYPEDEF },
+    [45] = { "case", 4, KW_CASE },
+    [46] = { "if", 2, KW_IF },
+    [48] = { "while", 5, KW_WHILE },
+    [49] = { "i16", 3, KW_I16 },
+    [51] = { "f32", 3, KW_F32 },
+    [52] = { "false", 5, KW_FALSE },
+    [54] = { "return", 6, KW_RETURN },
+    [56] = { "struct", 6, KW_STRUCT },
+    [57] = { "i32", 3, KW_I32 },
+    [58] = { "null", 4, KW_NULL },
+    [59] = { "auto", 4, KW_AUTO },
+    [60] = { "char", 4, KW_CHAR },
+    [62] = { "void", 4, KW_VOID }
+};
+
+// Resolve a (possibly non NUL-terminated) identifier to its keyword ID
+KeywordId keyword_lookup(const char* str, size_t length) {
+    if (!str || length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH) {
+        return KW_NONE;
+    }
+    
+    unsigned int slot = keyword_hash(str, length);
+    if (keyword_table[slot].length == length &&
+        memcmp(keyword_table[slot].text, str, length) == 0) {
+        return keyword_table[slot].id;
+    }
+    return KW_NONE;
+}
+
+// Get keyword spelling
+const char* keyword_to_string(KeywordId keyword) {
+    if (keyword <= KW_NONE || keyword >= KW_COUNT) return NULL;
+    return keyword_names[keyword];
+}
+
+// Check if keyword names a builtin type
+bool keyword_is_type(KeywordId keyword) {
+    return keyword >= KW_I8 && keyword <= KW_VOID;
+}
+
+// Resolve a (possibly non NUL-terminated) operator spelling to its ID
+OperatorId operator_lookup(const char* str, size_t length) {
+    if (!str) return OP_NONE;
+    
+    if (length == 1) return (OperatorId)single_operators[(unsigned char)str[0]];
+    return length == 2 ? operator_pair(str[0], str[1]) : OP_NONE;
+}
+
+// Get operator spelling
+const char* operator_to_string(OperatorId op) {
+    if (op <= OP_NONE || op >= OP_COUNT) return NULL;
+    return operator_names[op];
+}
+
+// Create lexer over a NUL-terminated string
 Lexer* lexer_create(const char* source_code) {
     if (!source_code) return NULL;
+    return lexer_create_buffer(source_code, strlen(source_code));
+}
+
+// Create lexer over length bytes of text, used in place
+Lexer* lexer_create_buffer(const char* source, size_t length) {
+    if (!source) return NULL;
     
-    Lexer* lexer = malloc(sizeof(Lexer));
+    Lexer* lexer = calloc(1, sizeof(Lexer));
     if (!lexer) return NULL;
     
-    lexer->source = source_code;
-    lexer->position = 0;
-    lexer->length = strlen(source_code);
-    lexer->line = 1;
-    lexer->column = 1;
-    lexer->current_char = lexer->length > 0 ? source_code[0] : '\0';
+    scan_level();
+    lexer->source = source;
+    lexer->length = length;
+    lexer->hold = SIZE_MAX;
+    line_index_init(&lexer->lines);
+    lexer->current_char = length > 0 ? source[0] : '\0';
+    
+    return lexer;
+}
+
+// Slide the window past bytes no live token needs and read the next chunk.
+// Returns false at the end of the input.
+static bool lexer_fill(Lexer* lexer) {
+    if (!lexer->stream) return false;
+    
+    size_t keep = lexer->keep < lexer->hold ? lexer->keep : lexer->hold;
+    size_t drop = keep - lexer->base;
+    if (drop > 0) {
+        memmove(lexer->window, lexer->window + drop, lexer->length - drop);
+        lexer->base += drop;
+        lexer->length -= drop;
+        lexer->position -= drop;
+    }
+    
+    // A token longer than the window grows it
+    if (lexer->capacity - lexer->length < lexer->chunk_size) {
+        size_t capacity = lexer->capacity * 2;
+        if (capacity < lexer->length + lexer->chunk_size) capacity = lexer->length + lexer->chunk_size;
+        char* window = realloc(lexer->window, capacity);
+        if (!window) return false;
+        lexer->window = window;
+        lexer->capacity = capacity;
+    }
+    
+    size_t count = fread(lexer->window + lexer->length, 1, lexer->chunk_size, lexer->stream);
+    lexer->source = lexer->window;
+    lexer->length += count;
+    return count > 0;
+}
+
+// Create lexer reading file in chunks
+Lexer* lexer_create_stream(FILE* file, size_t chunk_size) {
+    if (!file || chunk_size == 0) return NULL;
+    
+    Lexer* lexer = calloc(1, sizeof(Lexer));
+    char* window = malloc(chunk_size);
+    if (!lexer || !window) {
+        free(lexer);
+        free(window);
+        return NULL;
+    }
+    
+    scan_level();
+    lexer->stream = file;
+    lexer->window = window;
+    lexer->capacity = chunk_size;
+    lexer->chunk_size = chunk_size;
+    lexer->source = window;
+    lexer->hold = SIZE_MAX;
+    line_index_init(&lexer->lines);
+    lexer_fill(lexer);
+    lexer->current_char = lexer->length > 0 ? window[0] : '\0';
     
     return lexer;
 }
@@ -35,10 +281,17 @@ Lexer* lexer_create(const char* source_code) {
 // Destroy lexer
 void lexer_destroy(Lexer* lexer) {
     if (lexer) {
+        line_index_free(&lexer->lines);
+        free(lexer->window);
         free(lexer);
     }
 }
 
+// Input offset of the current character
+static inline size_t lexer_offset(const Lexer* lexer) {
+    return lexer->base + lexer->position;
+}
+
 // Advance to next character
 void lexer_advance(Lexer* lexer) {
     if (!lexer || lexer->position >= lexer->length) {
@@ -47,20 +300,48 @@ void lexer_advance(Lexer* lexer) {
     }
     
     if (lexer->current_char == '\n') {
-        lexer->line++;
-        lexer->column = 1;
-    } else {
-        lexer->column++;
+        line_index_add(&lexer->lines, lexer_offset(lexer) + 1);
     }
     
     lexer->position++;
+    if (lexer->position >= lexer->length && lexer->stream) {
+        lexer_fill(lexer);
+    }
     lexer->current_char = (lexer->position < lexer->length) ? 
                          lexer->source[lexer->position] : '\0';
 }
 
+// Advance over the next count bytes of the window at once, recording the
+// lines that start among them
+static void lexer_skip(Lexer* lexer, size_t count) {
+    const char* text = lexer->source + lexer->position;
+    size_t newline = scan_until(text, count, '\n', '\n');
+    while (newline < count) {
+        line_index_add(&lexer->lines, lexer_offset(lexer) + newline + 1);
+        newline += 1 + scan_until(text + newline + 1, count - newline - 1, '\n', '\n');
+    }
+    
+    lexer->position += count;
+    if (lexer->position >= lexer->length && lexer->stream) {
+        lexer_fill(lexer);
+    }
+    lexer->current_char = (lexer->position < lexer->length) ?
+                         lexer->source[lexer->position] : '\0';
+}
+
+// Bytes left in the window from the current character
+static inline size_t lexer_remaining(const Lexer* lexer) {
+    return lexer->length - lexer->position;
+}
+
 // Peek next character
 char lexer_peek(Lexer* lexer) {
-    if (!lexer || lexer->position + 1 >= lexer->length) {
+    if (!lexer) return '\0';
+    
+    if (lexer->position + 1 >= lexer->length && lexer->stream) {
+        lexer_fill(lexer);
+    }
+    if (lexer->position + 1 >= lexer->length) {
         return '\0';
     }
     return lexer->source[lexer->position + 1];
@@ -68,193 +349,264 @@ char lexer_peek(Lexer* lexer) {
 
 // Check if string is keyword
 bool is_keyword(const char* str) {
-    for (int i = 0; keywords[i] != NULL; i++) {
-        if (strcmp(str, keywords[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+    return str && keyword_lookup(str, strlen(str)) != KW_NONE;
 }
 
 // Character classification functions
 bool is_alpha(char c) {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    return (CHAR_CLASS(c) & CC_ALPHA) != 0;
 }
 
 bool is_digit(char c) {
-    return c >= '0' && c <= '9';
+    return (CHAR_CLASS(c) & CC_DIGIT) != 0;
 }
 
 bool is_alnum(char c) {
-    return is_alpha(c) || is_digit(c);
+    return (CHAR_CLASS(c) & CC_ALNUM) != 0;
 }
 
 bool is_whitespace(char c) {
-    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    return (CHAR_CLASS(c) & CC_SPACE) != 0;
 }
 
 bool is_operator_char(char c) {
-    return strchr("+-*/%=!<>&|^~?:.-", c) != NULL;
+    return (CHAR_CLASS(c) & CC_OPERATOR) != 0;
 }
 
 bool is_delimiter_char(char c) {
-    return strchr("(){}[];,", c) != NULL;
+    return (CHAR_CLASS(c) & CC_DELIMITER) != 0;
 }
 
-// Skip whitespace
+// Skip whitespace, a run at a time (a streamed window may split a run)
 void lexer_skip_whitespace(Lexer* lexer) {
-    while (lexer->current_char != '\0' && is_whitespace(lexer->current_char)) {
+    // A single blank between tokens is the common case
+    if (lexer->current_char == ' ' && !(CHAR_CLASS(lexer_peek(lexer)) & CC_SPACE)) {
         lexer_advance(lexer);
+        return;
+    }
+    
+    while (CHAR_CLASS(lexer->current_char) & CC_SPACE) {
+        lexer_skip(lexer, scan_whitespace(lexer->source + lexer->position, lexer_remaining(lexer)));
     }
 }
 
 // Skip comments
 void lexer_skip_comment(Lexer* lexer) {
     if (lexer->current_char == '/' && lexer_peek(lexer) == '/') {
-        // Single line comment
+        // Single line comment: jump to the newline
         while (lexer->current_char != '\0' && lexer->current_char != '\n') {
-            lexer_advance(lexer);
+            lexer_skip(lexer, scan_until(lexer->source + lexer->position, lexer_remaining(lexer), '\n', '\n'));
         }
     } else if (lexer->current_char == '/' && lexer_peek(lexer) == '*') {
-        // Multi line comment
+        // Multi line comment: jump from '*' to '*'
         lexer_advance(lexer); // skip '/'
         lexer_advance(lexer); // skip '*'
         
         while (lexer->current_char != '\0') {
-            if (lexer->current_char == '*' && lexer_peek(lexer) == '/') {
+            if (lexer->current_char != '*') {
+                lexer_skip(lexer, scan_until(lexer->source + lexer->position, lexer_remaining(lexer), '*', '*'));
+            } else if (lexer_peek(lexer) == '/') {
                 lexer_advance(lexer); // skip '*'
                 lexer_advance(lexer); // skip '/'
                 break;
+            } else {
+                lexer_advance(lexer);
             }
-            lexer_advance(lexer);
         }
     }
 }
 
 // Create token
-Token token_create(TokenType type, const char* value, int line, int column) {
+Token token_create(TokenType type, size_t offset, int length) {
     Token token;
     token.type = type;
-    token.line = line;
-    token.column = column;
-    token.length = value ? strlen(value) : 0;
-    
-    if (value) {
-        token.value = malloc(strlen(value) + 1);
-        strcpy(token.value, value);
-    } else {
-        token.value = NULL;
+    token.keyword = KW_NONE;
+    token.op = OP_NONE;
+    token.error = LEX_ERROR_NONE;
+    token.offset = offset;
+    token.length = length;
+    return token;
+}
+
+// Create error token (span covers the offending text)
+Token token_error(LexError error, size_t offset, int length) {
+    Token token = token_create(TOKEN_ERROR, offset, length);
+    token.error = error;
+    return token;
+}
+
+// Get the reason for an error token
+const char* lex_error_message(LexError error) {
+    switch (error) {
+        case LEX_ERROR_UNTERMINATED_STRING: return "Unterminated string literal";
+        case LEX_ERROR_UNTERMINATED_CHAR: return "Unterminated character literal";
+        case LEX_ERROR_UNKNOWN_CHARACTER: return "Unknown character";
+        case LEX_ERROR_INVALID_LEXER: return "Invalid lexer";
+        default: return "Invalid token";
     }
+}
+
+// Get pointer to the first byte of the lexeme
+const char* token_start(const Lexer* lexer, const Token* token) {
+    return lexer->source + (token->offset - lexer->base);
+}
+
+// Compare lexeme against a NUL-terminated string without materializing it
+bool token_equals(const Lexer* lexer, const Token* token, const char* text) {
+    if (!lexer || !token || !text) return false;
     
-    return token;
+    size_t length = strlen(text);
+    return (size_t)token->length == length &&
+           memcmp(token_start(lexer, token), text, length) == 0;
 }
 
-// Create error token
-Token token_error(const char* message, int line, int column) {
-    return token_create(TOKEN_ERROR, message, line, column);
+// Decode string literal escapes into buffer, returns decoded length
+static size_t decode_string(const char* src, size_t length, char* buffer, size_t size) {
+    size_t out = 0;
+    
+    for (size_t i = 0; i < length; i++) {
+        char decoded[2];
+        size_t count = 1;
+        
+        if (src[i] == '\\' && i + 1 < length) {
+            i++;
+            switch (src[i]) {
+                case 'n': decoded[0] = '\n'; break;
+                case 't': decoded[0] = '\t'; break;
+                case 'r': decoded[0] = '\r'; break;
+                case '\\': decoded[0] = '\\'; break;
+                case '"': decoded[0] = '"'; break;
+                case '\'': decoded[0] = '\''; break;
+                default:
+                    decoded[0] = '\\';
+                    decoded[1] = src[i];
+                    count = 2;
+                    break;
+            }
+        } else {
+            decoded[0] = src[i];
+        }
+        
+        for (size_t k = 0; k < count; k++, out++) {
+            if (out + 1 < size) buffer[out] = decoded[k];
+        }
+    }
+    
+    return out;
 }
 
-// Destroy token
-void token_destroy(Token* token) {
-    if (token && token->value) {
-        free(token->value);
-        token->value = NULL;
+// Copy the lexeme into buffer (NUL-terminated, truncated to size).
+// Returns the full text length, like snprintf.
+size_t token_copy_text(const Lexer* lexer, const Token* token, char* buffer, size_t size) {
+    if (!lexer || !token) {
+        if (buffer && size > 0) buffer[0] = '\0';
+        return 0;
+    }
+    
+    const char* src = token_start(lexer, token);
+    size_t length = (size_t)token->length;
+    
+    if (token->type == TOKEN_STRING) {
+        length = decode_string(src, length, buffer, size);
+    } else if (buffer && size > 0) {
+        memcpy(buffer, src, length < size ? length : size - 1);
     }
+    
+    if (buffer && size > 0) {
+        buffer[length < size ? length : size - 1] = '\0';
+    }
+    return length;
+}
+
+// Materialize the lexeme as a heap-allocated string (caller frees)
+char* token_text(const Lexer* lexer, const Token* token) {
+    size_t length = token_copy_text(lexer, token, NULL, 0);
+    char* text = malloc(length + 1);
+    if (!text) return NULL;
+    
+    token_copy_text(lexer, token, text, length + 1);
+    return text;
+}
+
+// Line and column of a token, from the lines read so far
+void token_position(const Lexer* lexer, const Token* token, int* line, int* column) {
+    line_index_position(lexer ? &lexer->lines : NULL, token_location(token), line, column);
 }
 
 // Read identifier or keyword
 Token lexer_read_identifier(Lexer* lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
-    char buffer[256];
-    int i = 0;
+    size_t start = lexer_offset(lexer);
     
-    while (lexer->current_char != '\0' && is_alnum(lexer->current_char) && i < 255) {
-        buffer[i++] = lexer->current_char;
+    while (CHAR_CLASS(lexer->current_char) & CC_ALNUM) {
         lexer_advance(lexer);
     }
-    buffer[i] = '\0';
     
-    TokenType type = is_keyword(buffer) ? TOKEN_KEYWORD : TOKEN_IDENTIFIER;
-    return token_create(type, buffer, start_line, start_column);
+    size_t length = lexer_offset(lexer) - start;
+    KeywordId keyword = keyword_lookup(lexer->source + (start - lexer->base), length);
+    
+    Token token = token_create(keyword != KW_NONE ? TOKEN_KEYWORD : TOKEN_IDENTIFIER,
+                               start, (int)length);
+    token.keyword = keyword;
+    return token;
 }
 
 // Read number (integer or float)
 Token lexer_read_number(Lexer* lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
-    char buffer[64];
-    int i = 0;
+    size_t start = lexer_offset(lexer);
     bool is_float = false;
     
     // Handle hex, binary, octal prefixes
-    if (lexer->current_char == '0' && i < 63) {
-        buffer[i++] = lexer->current_char;
+    if (lexer->current_char == '0') {
         lexer_advance(lexer);
         
         if (lexer->current_char == 'x' || lexer->current_char == 'X') {
             // Hexadecimal
-            buffer[i++] = lexer->current_char;
             lexer_advance(lexer);
-            while (lexer->current_char != '\0' && 
-                   (is_digit(lexer->current_char) || 
-                    (lexer->current_char >= 'a' && lexer->current_char <= 'f') ||
-                    (lexer->current_char >= 'A' && lexer->current_char <= 'F')) && i < 63) {
-                buffer[i++] = lexer->current_char;
+            while (is_digit(lexer->current_char) ||
+                   (lexer->current_char >= 'a' && lexer->current_char <= 'f') ||
+                   (lexer->current_char >= 'A' && lexer->current_char <= 'F')) {
                 lexer_advance(lexer);
             }
         } else if (lexer->current_char == 'b' || lexer->current_char == 'B') {
             // Binary
-            buffer[i++] = lexer->current_char;
             lexer_advance(lexer);
-            while (lexer->current_char != '\0' && 
-                   (lexer->current_char == '0' || lexer->current_char == '1') && i < 63) {
-                buffer[i++] = lexer->current_char;
+            while (lexer->current_char == '0' || lexer->current_char == '1') {
                 lexer_advance(lexer);
             }
         } else if (lexer->current_char == 'o' || lexer->current_char == 'O') {
             // Octal
-            buffer[i++] = lexer->current_char;
             lexer_advance(lexer);
-            while (lexer->current_char != '\0' && 
-                   (lexer->current_char >= '0' && lexer->current_char <= '7') && i < 63) {
-                buffer[i++] = lexer->current_char;
+            while (lexer->current_char >= '0' && lexer->current_char <= '7') {
                 lexer_advance(lexer);
             }
         }
     }
     
     // Read decimal digits
-    while (lexer->current_char != '\0' && is_digit(lexer->current_char) && i < 63) {
-        buffer[i++] = lexer->current_char;
+    while (is_digit(lexer->current_char)) {
         lexer_advance(lexer);
     }
     
     // Check for decimal point
-    if (lexer->current_char == '.' && is_digit(lexer_peek(lexer)) && i < 63) {
+    if (lexer->current_char == '.' && is_digit(lexer_peek(lexer))) {
         is_float = true;
-        buffer[i++] = lexer->current_char;
         lexer_advance(lexer);
         
-        while (lexer->current_char != '\0' && is_digit(lexer->current_char) && i < 63) {
-            buffer[i++] = lexer->current_char;
+        while (is_digit(lexer->current_char)) {
             lexer_advance(lexer);
         }
     }
     
     // Check for scientific notation
-    if ((lexer->current_char == 'e' || lexer->current_char == 'E') && i < 63) {
+    if (lexer->current_char == 'e' || lexer->current_char == 'E') {
         is_float = true;
-        buffer[i++] = lexer->current_char;
         lexer_advance(lexer);
         
         if (lexer->current_char == '+' || lexer->current_char == '-') {
-            buffer[i++] = lexer->current_char;
             lexer_advance(lexer);
         }
         
-        while (lexer->current_char != '\0' && is_digit(lexer->current_char) && i < 63) {
-            buffer[i++] = lexer->current_char;
+        while (is_digit(lexer->current_char)) {
             lexer_advance(lexer);
         }
     }
@@ -262,214 +614,164 @@ Token lexer_read_number(Lexer* lexer) {
     // Check for float suffix
     if (lexer->current_char == 'f' || lexer->current_char == 'F') {
         is_float = true;
-        buffer[i++] = lexer->current_char;
         lexer_advance(lexer);
     }
     
-    buffer[i] = '\0';
     TokenType type = is_float ? TOKEN_FLOAT : TOKEN_INTEGER;
-    return token_create(type, buffer, start_line, start_column);
+    return token_create(type, start, (int)(lexer_offset(lexer) - start));
 }
 
-// Read string literal
+// Read string literal (span covers the raw contents, escapes are decoded by token_copy_text)
 Token lexer_read_string(Lexer* lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
-    char buffer[1024];
-    int i = 0;
+    size_t quote = lexer_offset(lexer);
     char quote_char = lexer->current_char;
     
     lexer_advance(lexer); // skip opening quote
+    size_t start = lexer_offset(lexer);
     
-    while (lexer->current_char != '\0' && lexer->current_char != quote_char && i < 1023) {
+    // Jump between quotes and escapes
+    while (lexer->current_char != '\0' && lexer->current_char != quote_char) {
         if (lexer->current_char == '\\') {
+            lexer_advance(lexer); // skip escaped character
             lexer_advance(lexer);
-            switch (lexer->current_char) {
-                case 'n': buffer[i++] = '\n'; break;
-                case 't': buffer[i++] = '\t'; break;
-                case 'r': buffer[i++] = '\r'; break;
-                case '\\': buffer[i++] = '\\'; break;
-                case '"': buffer[i++] = '"'; break;
-                case '\'': buffer[i++] = '\''; break;
-                default: 
-                    buffer[i++] = '\\';
-                    buffer[i++] = lexer->current_char;
-                    break;
-            }
         } else {
-            buffer[i++] = lexer->current_char;
+            lexer_skip(lexer, scan_until(lexer->source + lexer->position, lexer_remaining(lexer), quote_char, '\\'));
         }
-        lexer_advance(lexer);
     }
     
-    if (lexer->current_char == quote_char) {
-        lexer_advance(lexer); // skip closing quote
-    } else {
-        return token_error("Unterminated string literal", start_line, start_column);
+    if (lexer->current_char != quote_char) {
+        return token_error(LEX_ERROR_UNTERMINATED_STRING, quote, 1);
     }
     
-    buffer[i] = '\0';
-    return token_create(TOKEN_STRING, buffer, start_line, start_column);
+    size_t length = lexer_offset(lexer) - start;
+    lexer_advance(lexer); // skip closing quote
+    return token_create(TOKEN_STRING, start, (int)length);
 }
 
 // Read character literal
 Token lexer_read_char(Lexer* lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
-    char buffer[4];
-    int i = 0;
+    size_t quote = lexer_offset(lexer);
     
     lexer_advance(lexer); // skip opening quote
+    size_t start = lexer_offset(lexer);
     
     if (lexer->current_char == '\\') {
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
-    } else {
-        buffer[i++] = lexer->current_char;
         lexer_advance(lexer);
     }
+    lexer_advance(lexer);
     
-    if (lexer->current_char == '\'') {
-        lexer_advance(lexer); // skip closing quote
-    } else {
-        return token_error("Unterminated character literal", start_line, start_column);
+    if (lexer->current_char != '\'') {
+        return token_error(LEX_ERROR_UNTERMINATED_CHAR, quote, 1);
     }
     
-    buffer[i] = '\0';
-    return token_create(TOKEN_CHAR, buffer, start_line, start_column);
+    size_t length = lexer_offset(lexer) - start;
+    lexer_advance(lexer); // skip closing quote
+    return token_create(TOKEN_CHAR, start, (int)length);
 }
 
 // Read operator
 Token lexer_read_operator(Lexer* lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
-    char buffer[4];
-    int i = 0;
+    size_t start = lexer_offset(lexer);
     
-    buffer[i++] = lexer->current_char;
     char first = lexer->current_char;
     lexer_advance(lexer);
     
-    // Check for two-character operators
-    if (lexer->current_char != '\0') {
-        char second = lexer->current_char;
-        
-        // Two character operators
-        if ((first == '=' && second == '=') ||
-            (first == '!' && second == '=') ||
-            (first == '<' && second == '=') ||
-            (first == '>' && second == '=') ||
-            (first == '&' && second == '&') ||
-            (first == '|' && second == '|') ||
-            (first == '+' && second == '+') ||
-            (first == '-' && second == '-') ||
-            (first == '+' && second == '=') ||
-            (first == '-' && second == '=') ||
-            (first == '*' && second == '=') ||
-            (first == '/' && second == '=') ||
-            (first == '%' && second == '=') ||
-            (first == '<' && second == '<') ||
-            (first == '>' && second == '>') ||
-            (first == '-' && second == '>') ||
-            (first == ':' && second == ':')) {
-            buffer[i++] = lexer->current_char;
-            lexer_advance(lexer);
-        }
+    // Longest match: take the next character too if the pair is an operator
+    OperatorId op = operator_pair(first, lexer->current_char);
+    if (op != OP_NONE) {
+        lexer_advance(lexer);
+    } else {
+        op = (OperatorId)single_operators[(unsigned char)first];
     }
     
-    buffer[i] = '\0';
-    return token_create(TOKEN_OPERATOR, buffer, start_line, start_column);
+    Token token = token_create(TOKEN_OPERATOR, start, (int)(lexer_offset(lexer) - start));
+    token.op = op;
+    return token;
 }
 
 // Read preprocessor directive
 Token lexer_read_preprocessor(Lexer* lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
-    char buffer[256];
-    int i = 0;
-    
-    // Include the # character
-    buffer[i++] = lexer->current_char;
-    lexer_advance(lexer);
+    size_t start = lexer_offset(lexer);
     
-    // Read the directive name and arguments
-    while (lexer->current_char != '\0' && lexer->current_char != '\n' && i < 255) {
-        buffer[i++] = lexer->current_char;
+    // The # character, directive name and arguments up to end of line
+    while (lexer->current_char != '\0' && lexer->current_char != '\n') {
         lexer_advance(lexer);
     }
     
-    buffer[i] = '\0';
-    return token_create(TOKEN_PREPROCESSOR, buffer, start_line, start_column);
+    return token_create(TOKEN_PREPROCESSOR, start, (int)(lexer_offset(lexer) - start));
 }
 
-// Main tokenization function
-Token lexer_next_token(Lexer* lexer) {
-    if (!lexer) {
-        return token_error("Invalid lexer", 0, 0);
-    }
-    
+// Scan the next token
+static Token lexer_scan(Lexer* lexer) {
     while (lexer->current_char != '\0') {
+        char c = lexer->current_char;
+        unsigned char cls = CHAR_CLASS(c);
+        
         // Skip whitespace
-        if (is_whitespace(lexer->current_char)) {
+        if (cls & CC_SPACE) {
             lexer_skip_whitespace(lexer);
             continue;
         }
         
-        // Skip comments
-        if (lexer->current_char == '/' && 
-            (lexer_peek(lexer) == '/' || lexer_peek(lexer) == '*')) {
-            lexer_skip_comment(lexer);
-            continue;
-        }
-        
-        // Preprocessor directives
-        if (lexer->current_char == '#') {
-            return lexer_read_preprocessor(lexer);
-        }
-        
-        // String literals
-        if (lexer->current_char == '"') {
-            return lexer_read_string(lexer);
-        }
-        
-        // Character literals
-        if (lexer->current_char == '\'') {
-            return lexer_read_char(lexer);
+        // Identifiers and keywords
+        if (cls & CC_ALPHA) {
+            return lexer_read_identifier(lexer);
         }
         
         // Numbers
-        if (is_digit(lexer->current_char)) {
+        if (cls & CC_DIGIT) {
             return lexer_read_number(lexer);
         }
         
-        // Identifiers and keywords
-        if (is_alpha(lexer->current_char)) {
-            return lexer_read_identifier(lexer);
+        // Delimiters
+        if (cls & CC_DELIMITER) {
+            Token token = token_create(TOKEN_DELIMITER, lexer_offset(lexer), 1);
+            lexer_advance(lexer);
+            return token;
         }
         
-        // Operators
-        if (is_operator_char(lexer->current_char)) {
+        // Operators (comments start with an operator character too)
+        if (cls & CC_OPERATOR) {
+            if (c == '/') {
+                char next = lexer_peek(lexer);
+                if (next == '/' || next == '*') {
+                    lexer_skip_comment(lexer);
+                    continue;
+                }
+            }
             return lexer_read_operator(lexer);
         }
         
-        // Delimiters
-        if (is_delimiter_char(lexer->current_char)) {
-            char buffer[2] = {lexer->current_char, '\0'};
-            Token token = token_create(TOKEN_DELIMITER, buffer, lexer->line, lexer->column);
-            lexer_advance(lexer);
-            return token;
+        switch (c) {
+            case '#':
+                return lexer_read_preprocessor(lexer);
+            case '"':
+                return lexer_read_string(lexer);
+            case '\'':
+                return lexer_read_char(lexer);
+            default:
+                break;
         }
         
         // Unknown character
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "Unknown character: '%c'", lexer->current_char);
-        Token error = token_error(buffer, lexer->line, lexer->column);
+        Token error = token_error(LEX_ERROR_UNKNOWN_CHARACTER, lexer_offset(lexer), 1);
         lexer_advance(lexer);
         return error;
     }
     
     // End of file
-    return token_create(TOKEN_EOF, NULL, lexer->line, lexer->column);
-} 
\ No newline at end of file
+    return token_create(TOKEN_EOF, lexer_offset(lexer), 0);
+}
+
+// Main tokenization function
+Token lexer_next_token(Lexer* lexer) {
+    if (!lexer) {
+        return token_error(LEX_ERROR_INVALID_LEXER, 0, 0);
+    }
+    
+    // The previous token stays readable while this one is scanned
+    lexer->keep = lexer->last_start;
+    Token token = lexer_scan(lexer);
+    lexer->last_start = token.offset;
+    return token;
+}
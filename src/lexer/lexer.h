@@ -3,6 +3,8 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+#include "line_index.h"
 
 // Token types
 typedef enum {
@@ -19,31 +21,113 @@ typedef enum {
     TOKEN_ERROR
 } TokenType;
 
-// Token structure
+// Keyword identifiers (reported in Token::keyword, KW_NONE for non-keywords)
+typedef enum {
+    KW_NONE = 0,
+    KW_FN, KW_STRUCT, KW_ENUM, KW_IF, KW_ELSE, KW_FOR, KW_WHILE, KW_RETURN,
+    KW_BREAK, KW_CONTINUE, KW_AUTO, KW_NULL, KW_TRUE, KW_FALSE, KW_ALLOC,
+    KW_DELETE, KW_SIZEOF, KW_CONST, KW_STATIC, KW_GLOBAL, KW_TYPEDEF,
+    KW_SWITCH, KW_CASE, KW_DEFAULT,
+    // Types (keep contiguous, see keyword_is_type)
+    KW_I8, KW_I16, KW_I32, KW_I64, KW_F32, KW_F64,
+    KW_BOOL, KW_STRING, KW_CHAR, KW_VOID,
+    KW_COUNT
+} KeywordId;
+
+// Operator identifiers (reported in Token::op, OP_NONE for non-operators).
+// Named after their spelling: the parser decides whether '-' is a
+// subtraction or a negation, '*' a product or a dereference.
+typedef enum {
+    OP_NONE = 0,
+    // One character
+    OP_PLUS, OP_MINUS, OP_STAR, OP_SLASH, OP_PERCENT, OP_ASSIGN, OP_BANG, OP_LESS,
+    OP_GREATER, OP_AMPERSAND, OP_PIPE, OP_CARET, OP_TILDE, OP_QUESTION, OP_COLON, OP_DOT,
+    // Two characters
+    OP_EQUAL, OP_NOT_EQUAL, OP_LESS_EQUAL, OP_GREATER_EQUAL, OP_AND, OP_OR,
+    OP_INCREMENT, OP_DECREMENT, OP_PLUS_ASSIGN, OP_MINUS_ASSIGN, OP_STAR_ASSIGN,
+    OP_SLASH_ASSIGN, OP_PERCENT_ASSIGN, OP_SHIFT_LEFT, OP_SHIFT_RIGHT, OP_ARROW, OP_SCOPE,
+    OP_COUNT
+} OperatorId;
+
+// Lexer error identifiers (reported in Token::error, LEX_ERROR_NONE for
+// tokens other than TOKEN_ERROR); lex_error_message gives the reason.
+typedef enum {
+    LEX_ERROR_NONE = 0,
+    LEX_ERROR_UNTERMINATED_STRING,
+    LEX_ERROR_UNTERMINATED_CHAR,
+    LEX_ERROR_UNKNOWN_CHARACTER,
+    LEX_ERROR_INVALID_LEXER
+} LexError;
+
+// Token structure: a span of the lexer's input, tokens own no memory.
+// Use token_start/token_copy_text/token_text to reach the lexeme and
+// token_position for its line and column.
 typedef struct {
     TokenType type;
-    char* value;
-    int line;
-    int column;
-    int length;
+    KeywordId keyword;
+    OperatorId op;
+    LexError error;
+    size_t offset;      // start of the lexeme in the input
+    int length;         // lexeme length in bytes (string/char: contents between quotes)
 } Token;
 
-// Lexer structure
+// Lexer structure.
+// An in-memory input is lexed in place: source/length view the whole text,
+// which need not be NUL-terminated. A streamed input is read in chunks into
+// a window; source then views the window, which starts at input offset base.
 typedef struct {
     const char* source;
-    size_t position;
-    size_t length;
-    int line;
-    int column;
+    size_t position;            // index into source
+    size_t length;              // bytes available in source
+    LineIndex lines;            // starts of the lines read so far
     char current_char;
+    // Streaming
+    size_t base;                // input offset of source[0] (0 in memory)
+    FILE* stream;               // not owned; NULL for an in-memory input
+    char* window;
+    size_t capacity;
+    size_t chunk_size;
+    size_t keep;                // input offset of the oldest byte a live token needs
+    size_t last_start;          // input offset of the last returned token
+    size_t hold;                // input offset the owner still reads from (SIZE_MAX: none)
 } Lexer;
 
 // Function declarations
 Lexer* lexer_create(const char* source_code);
+Lexer* lexer_create_buffer(const char* source, size_t length);
 void lexer_destroy(Lexer* lexer);
 
+// Streaming lexer: reads file in chunks of chunk_size bytes, so memory stays
+// bounded by the chunk size plus the longest stretch from one token's start
+// to the end of the next. A token's text is valid until two more tokens have
+// been read, or for as long as lexer->hold is at or before its start.
+Lexer* lexer_create_stream(FILE* file, size_t chunk_size);
+
 Token lexer_next_token(Lexer* lexer);
-void token_destroy(Token* token);
+
+// Token text
+const char* token_start(const Lexer* lexer, const Token* token);
+bool token_equals(const Lexer* lexer, const Token* token, const char* text);
+size_t token_copy_text(const Lexer* lexer, const Token* token, char* buffer, size_t size);
+char* token_text(const Lexer* lexer, const Token* token);
+
+// Token position: a source location, resolved to line and column on demand.
+// String and character spans start after the opening quote, but are
+// positioned at it.
+static inline uint32_t token_location(const Token* token) {
+    bool quoted = token->type == TOKEN_STRING || token->type == TOKEN_CHAR;
+    return source_location(token->offset - (quoted ? 1 : 0));
+}
+void token_position(const Lexer* lexer, const Token* token, int* line, int* column);
+
+// Keyword lookup (perfect hash, see lexer.c)
+KeywordId keyword_lookup(const char* str, size_t length);
+const char* keyword_to_string(KeywordId keyword);
+bool keyword_is_type(KeywordId keyword);
+
+// Operator lookup
+OperatorId operator_lookup(const char* str, size_t length);
+const char* operator_to_string(OperatorId op);
 
 // Utility functions
 bool is_keyword(const char* str);
@@ -67,7 +151,8 @@ Token lexer_read_identifier(Lexer* lexer);
 Token lexer_read_operator(Lexer* lexer);
 Token lexer_read_preprocessor(Lexer* lexer);
 
-Token token_create(TokenType type, const char* value, int line, int column);
-Token token_error(const char* message, int line, int column);
+Token token_create(TokenType type, size_t offset, int length);
+Token token_error(LexError error, size_t offset, int length);
+const char* lex_error_message(LexError error);
 
 #endif // LEXER_H 
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "lexer_scan.h"
+#include <pthread.h>
+
+// The kernels are only worth their setup cost when optimized, so keep
+// them optimized in the default -O0 debug build as well
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__OPTIMIZE__)
+#pragma GCC optimize ("O2")
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+typedef struct Scanner {
+    size_t (*whitespace)(const char* text, size_t length);
+    size_t (*until)(const char* text, size_t length, char a, char b);
+} Scanner;
+
+// Scalar versions, also used for the tails of the vector ones
+
+static inline bool scan_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static size_t scalar_whitespace(const char* text, size_t length) {
+    size_t i = 0;
+    while (i < length && scan_is_space(text[i])) i++;
+    return i;
+}
+
+static size_t scalar_until(const char* text, size_t length, char a, char b) {
+    size_t i = 0;
+    while (i < length && text[i] != '\0' && text[i] != a && text[i] != b) i++;
+    return i;
+}
+
+#ifdef SCAN_X86
+
+// SSE2 (part of every x86-64 CPU)
+
+static inline unsigned sse2_space_mask(__m128i block) {
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                                 _mm_cmpeq_epi8(block, _mm_set1_epi8('\t')));
+    __m128i line = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')),
+                                _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(space, line));
+}
+
+static size_t sse2_whitespace(const char* text, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        unsigned other = ~sse2_space_mask(_mm_loadu_si128((const __m128i*)(text + i))) & 0xFFFFu;
+        if (other) return i + (size_t)__builtin_ctz(other);
+    }
+    return i + scalar_whitespace(text + i, length - i);
+}
+
+static size_t sse2_until(const char* text, size_t length, char a, char b) {
+    __m128i va = _mm_set1_epi8(a);
+    __m128i vb = _mm_set1_epi8(b);
+    __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(block, zero),
+                                   _mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    return i + scalar_until(text + i, length - i, a, b);
+}
+
+// AVX2, compiled for that target only and used if the CPU has it. The SSE2
+// tails are legacy-encoded, so clear the upper halves before calling them:
+// GCC does not, and the dirty state would slow every SSE instruction after.
+
+__attribute__((target("avx2")))
+static size_t avx2_whitespace(const char* text, size_t length) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(text + i));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                                        _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')));
+        __m256i line = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')),
+                                       _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')));
+        unsigned other = ~(unsigned)_mm256_movemask_epi8(_mm256_or_si256(space, line));
+        if (other) return i + (size_t)__builtin_ctz(other);
+    }
+    _mm256_zeroupper();
+    return i + sse2_whitespace(text + i, length - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_until(const char* text, size_t length, char a, char b) {
+    __m256i va = _mm256_set1_epi8(a);
+    __m256i vb = _mm256_set1_epi8(b);
+    __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(text + i));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(block, zero),
+                                      _mm256_or_si256(_mm256_cmpeq_epi8(block, va),
+                                                      _mm256_cmpeq_epi8(block, vb)));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(hit);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    _mm256_zeroupper();
+    return i + sse2_until(text + i, length - i, a, b);
+}
+
+#endif // SCAN_X86
+
+static const Scanner scanners[] = {
+    [SCAN_SCALAR] = { scalar_whitespace, scalar_until },
+#ifdef SCAN_X86
+    [SCAN_SSE2] = { sse2_whitespace, sse2_until },
+    [SCAN_AVX2] = { avx2_whitespace, avx2_until },
+#endif
+};
+
+// Selected version; written once (or by scan_select), then only read
+static ScanLevel scan_current = SCAN_SCALAR;
+static const Scanner* scan_active = &scanners[SCAN_SCALAR];
+static pthread_once_t scan_once = PTHREAD_ONCE_INIT;
+
+static bool scan_supported(ScanLevel level) {
+#ifdef SCAN_X86
+    if (level == SCAN_AVX2) return __builtin_cpu_supports("avx2");
+    return level == SCAN_SCALAR || level == SCAN_SSE2;
+#else
+    return level == SCAN_SCALAR;
+#endif
+}
+
+static void scan_detect(void) {
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+#endif
+    ScanLevel level = scan_supported(SCAN_AVX2) ? SCAN_AVX2 :
+                      scan_supported(SCAN_SSE2) ? SCAN_SSE2 : SCAN_SCALAR;
+    scan_current = level;
+    scan_active = &scanners[level];
+}
+
+// Lexers call this when created, which also orders the detection before
+// their scans on any thread
+ScanLevel scan_level(void) {
+    pthread_once(&scan_once, scan_detect);
+    return scan_current;
+}
+
+bool scan_select(ScanLevel level) {
+    pthread_once(&scan_once, scan_detect);
+    if (!scan_supported(level)) return false;
+    
+    scan_current = level;
+    scan_active = &scanners[level];
+    return true;
+}
+
+size_t scan_whitespace(const char* text, size_t length) {
+    return scan_active->whitespace(text, length);
+}
+
+size_t scan_until(const char* text, size_t length, char a, char b) {
+    return scan_active->until(text, length, a, b);
+}
@@ -0,0 +1,32 @@
+#ifndef LEXER_SCAN_H
+#define LEXER_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Byte scanners behind the lexer's hot loops: whitespace runs and the bodies
+// of comments and string literals. Each comes in a scalar, an SSE2 and an
+// AVX2 version working 1, 16 and 32 bytes at a time; the widest one the CPU
+// supports is selected at runtime. None reads past length.
+
+typedef enum {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2
+} ScanLevel;
+
+// Version in use, detecting the CPU on the first call (made by every
+// lexer constructor, before the scanners below are used)
+ScanLevel scan_level(void);
+
+// Use another version (tests); false if the CPU does not support it.
+// Not thread-safe: call it while no lexer is running.
+bool scan_select(ScanLevel level);
+
+// Length of the leading run of ' ', '\t', '\n' and '\r'
+size_t scan_whitespace(const char* text, size_t length);
+
+// Index of the first NUL, a or b byte (length if there is none)
+size_t scan_until(const char* text, size_t length, char a, char b);
+
+#endif // LEXER_SCAN_H
@@ -0,0 +1,56 @@
+#include "line_index.h"
+#include <stdlib.h>
+
+void line_index_init(LineIndex* index) {
+    if (!index) return;
+    
+    index->starts = NULL;
+    index->count = 0;
+    index->capacity = 0;
+}
+
+void line_index_free(LineIndex* index) {
+    if (!index) return;
+    
+    free(index->starts);
+    line_index_init(index);
+}
+
+void line_index_add(LineIndex* index, size_t offset) {
+    if (!index || offset >= UINT32_MAX) return;
+    if (index->count > 0 && index->starts[index->count - 1] >= offset) return;
+    
+    if (index->count == index->capacity) {
+        size_t capacity = index->capacity ? index->capacity * 2 : 256;
+        uint32_t* starts = realloc(index->starts, capacity * sizeof(uint32_t));
+        if (!starts) return;
+        index->starts = starts;
+        index->capacity = capacity;
+    }
+    index->starts[index->count++] = (uint32_t)offset;
+}
+
+void line_index_position(const LineIndex* index, uint32_t location, int* line, int* column) {
+    if (!index || location == SOURCE_LOCATION_NONE) {
+        *line = 0;
+        *column = 0;
+        return;
+    }
+    
+    // Number of recorded line starts at or before the offset
+    uint32_t offset = location - 1;
+    size_t low = 0;
+    size_t high = index->count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (index->starts[middle] <= offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    
+    uint32_t start = low > 0 ? index->starts[low - 1] : 0;
+    *line = (int)low + 1;
+    *column = (int)(offset - start) + 1;
+}
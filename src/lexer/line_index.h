@@ -0,0 +1,37 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Source locations and the line table that resolves them.
+// Tokens and AST nodes carry a location: the byte offset of their first
+// character plus one, so that 0 means "no position". The lexer records where
+// each line starts as it passes the newline before it; line and column are
+// only worked out (by binary search) when a diagnostic is reported.
+
+#define SOURCE_LOCATION_NONE 0u
+
+// Location of an input offset (offsets past 4 GiB saturate)
+static inline uint32_t source_location(size_t offset) {
+    return offset < UINT32_MAX ? (uint32_t)(offset + 1) : UINT32_MAX;
+}
+
+// Starts of lines 2, 3, ... of one input (line 1 starts at offset 0)
+typedef struct LineIndex {
+    uint32_t* starts;
+    size_t count;
+    size_t capacity;
+} LineIndex;
+
+void line_index_init(LineIndex* index);
+void line_index_free(LineIndex* index);
+
+// Record a line starting at offset (ignored unless past the last one)
+void line_index_add(LineIndex* index, size_t offset);
+
+// Line and column (both from 1) of a location; 0, 0 for
+// SOURCE_LOCATION_NONE or without an index
+void line_index_position(const LineIndex* index, uint32_t location, int* line, int* column);
+
+#endif // LINE_INDEX_H
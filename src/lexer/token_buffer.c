@@ -0,0 +1,199 @@
+#include "token_buffer.h"
+#include <stdlib.h>
+
+// Lex a chunk of tokens (NULL if out of memory); *done is set once the EOF
+// token is stored
+static TokenChunk* token_chunk_lex(Lexer* lexer, bool* done) {
+    TokenChunk* chunk = malloc(sizeof(TokenChunk));
+    if (!chunk) return NULL;
+    
+    chunk->count = 0;
+    chunk->next = NULL;
+    while (chunk->count < TOKEN_CHUNK_SIZE && !*done) {
+        Token token = lexer_next_token(lexer);
+        int i = chunk->count++;
+        chunk->types[i] = (uint8_t)token.type;
+        chunk->ids[i] = (uint8_t)(token.type == TOKEN_KEYWORD ? (int)token.keyword :
+                                  token.type == TOKEN_ERROR ? (int)token.error : (int)token.op);
+        chunk->lengths[i] = (uint32_t)token.length;
+        chunk->offsets[i] = token.offset;
+        *done = token.type == TOKEN_EOF;
+    }
+    return chunk;
+}
+
+// Add a lexed chunk (with the lock held if threaded)
+static void token_buffer_append(TokenBuffer* buffer, TokenChunk* chunk, bool done) {
+    if (!chunk) {
+        buffer->failed = true;
+        buffer->done = true;
+        return;
+    }
+    
+    if (buffer->tail) {
+        buffer->tail->next = chunk;
+    } else {
+        buffer->head = chunk;
+    }
+    buffer->tail = chunk;
+    buffer->chunks++;
+    buffer->done = done;
+}
+
+// Lex the next chunk on the reading thread
+static void token_buffer_lex(TokenBuffer* buffer) {
+    // A streamed window must keep the text from the current token on
+    Lexer* lexer = buffer->lexer;
+    lexer->hold = buffer->head ? buffer->head->offsets[buffer->position] : lexer->base + lexer->position;
+    
+    bool done = false;
+    TokenChunk* chunk = token_chunk_lex(lexer, &done);
+    token_buffer_append(buffer, chunk, done);
+}
+
+// Lexer thread: stay up to TOKEN_BUFFER_AHEAD chunks ahead of the reader
+static void* token_buffer_run(void* argument) {
+    TokenBuffer* buffer = argument;
+    
+    pthread_mutex_lock(&buffer->lock);
+    while (!buffer->done && !buffer->stopping) {
+        if (buffer->chunks >= TOKEN_BUFFER_AHEAD) {
+            pthread_cond_wait(&buffer->changed, &buffer->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&buffer->lock);
+        
+        bool done = false;
+        TokenChunk* chunk = token_chunk_lex(buffer->lexer, &done);
+        
+        pthread_mutex_lock(&buffer->lock);
+        token_buffer_append(buffer, chunk, done);
+        pthread_cond_broadcast(&buffer->changed);
+    }
+    pthread_mutex_unlock(&buffer->lock);
+    return NULL;
+}
+
+TokenBuffer* token_buffer_create(Lexer* lexer) {
+    if (!lexer) return NULL;
+    
+    TokenBuffer* buffer = calloc(1, sizeof(TokenBuffer));
+    if (!buffer) return NULL;
+    
+    buffer->lexer = lexer;
+    pthread_mutex_init(&buffer->lock, NULL);
+    pthread_cond_init(&buffer->changed, NULL);
+    
+    // The first chunk is lexed here, so the reader never starts empty-handed
+    token_buffer_lex(buffer);
+    return buffer;
+}
+
+bool token_buffer_start_thread(TokenBuffer* buffer) {
+    if (!buffer || buffer->lexer->stream || buffer->done) return false;
+    if (buffer->threaded) return true;
+    
+    buffer->stopping = false;
+    buffer->threaded = pthread_create(&buffer->thread, NULL, token_buffer_run, buffer) == 0;
+    return buffer->threaded;
+}
+
+void token_buffer_join(TokenBuffer* buffer) {
+    if (!buffer || !buffer->threaded) return;
+    
+    pthread_mutex_lock(&buffer->lock);
+    buffer->stopping = true;
+    pthread_cond_broadcast(&buffer->changed);
+    pthread_mutex_unlock(&buffer->lock);
+    
+    pthread_join(buffer->thread, NULL);
+    buffer->threaded = false;
+}
+
+void token_buffer_destroy(TokenBuffer* buffer) {
+    if (!buffer) return;
+    
+    token_buffer_join(buffer);
+    while (buffer->head) {
+        TokenChunk* next = buffer->head->next;
+        free(buffer->head);
+        buffer->head = next;
+    }
+    pthread_mutex_destroy(&buffer->lock);
+    pthread_cond_destroy(&buffer->changed);
+    free(buffer);
+}
+
+// Chunk after chunk, waiting for the lexer thread if needed (NULL at the end)
+static TokenChunk* token_buffer_next(TokenBuffer* buffer, TokenChunk* chunk) {
+    if (!buffer->threaded) return chunk->next;
+    
+    pthread_mutex_lock(&buffer->lock);
+    while (!chunk->next && !buffer->done) {
+        pthread_cond_wait(&buffer->changed, &buffer->lock);
+    }
+    TokenChunk* next = chunk->next;
+    pthread_mutex_unlock(&buffer->lock);
+    return next;
+}
+
+// Token past the end: the EOF token, or one standing in for it after a failure
+static Token token_buffer_end(const TokenBuffer* buffer) {
+    const TokenChunk* tail = buffer->tail;
+    if (buffer->failed || !tail) {
+        Token end = { TOKEN_EOF, KW_NONE, OP_NONE, LEX_ERROR_NONE, tail ? tail->offsets[tail->count - 1] : 0, 0 };
+        return end;
+    }
+    Token end;
+    token_chunk_get(tail, tail->count - 1, &end);
+    return end;
+}
+
+Token token_buffer_peek(TokenBuffer* buffer, int distance) {
+    TokenChunk* chunk = buffer->head;
+    int index = buffer->position + distance;
+    while (chunk && index >= chunk->count) {
+        // Without a thread, the next chunk is lexed here
+        if (!buffer->threaded && chunk == buffer->tail && !buffer->done) {
+            token_buffer_lex(buffer);
+            continue;
+        }
+        index -= chunk->count;
+        chunk = token_buffer_next(buffer, chunk);
+    }
+    if (!chunk) return token_buffer_end(buffer);
+    
+    Token token;
+    token_chunk_get(chunk, index, &token);
+    return token;
+}
+
+void token_buffer_advance_chunk(TokenBuffer* buffer, Token* token) {
+    TokenChunk* head = buffer->head;
+    if (!head) {
+        *token = token_buffer_end(buffer);
+        return;
+    }
+    
+    *token = token_buffer_peek(buffer, 1);
+    if (buffer->position + 1 < head->count) {
+        buffer->position++;
+        return;
+    }
+    
+    TokenChunk* next = token_buffer_next(buffer, head);
+    if (!next) return;
+    
+    // Release the finished chunk; a waiting lexer thread may go on
+    if (buffer->threaded) {
+        pthread_mutex_lock(&buffer->lock);
+        buffer->chunks--;
+        pthread_cond_broadcast(&buffer->changed);
+        pthread_mutex_unlock(&buffer->lock);
+    } else {
+        buffer->chunks--;
+    }
+    free(head);
+    buffer->head = next;
+    buffer->position = 0;
+}
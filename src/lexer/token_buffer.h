@@ -0,0 +1,91 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include "lexer.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pre-lexed tokens for the parser.
+// Tokens are lexed a chunk at a time into struct-of-arrays chunks (types,
+// ids, lengths and offsets each stored together) and read back by index:
+// the current token and any of the next TOKEN_LOOKAHEAD_MAX. Chunks behind
+// the current token are released, so memory stays bounded by the chunks in
+// flight rather than the size of the input.
+//
+// Chunks are lexed on the reading thread as it gets to them, or, once a
+// lexer thread is started, on that thread up to TOKEN_BUFFER_AHEAD chunks
+// ahead of the reader. Streamed lexers always run on the reading thread and
+// are told to keep their window from the current token on (lexer->hold).
+
+#define TOKEN_CHUNK_SIZE 1024
+#define TOKEN_LOOKAHEAD_MAX TOKEN_CHUNK_SIZE
+#define TOKEN_BUFFER_AHEAD 16
+#define TOKEN_BUFFER_THREAD_MIN (1u << 20)   // Smallest input worth a lexer thread
+
+typedef struct TokenChunk {
+    uint8_t types[TOKEN_CHUNK_SIZE];   // TokenType
+    uint8_t ids[TOKEN_CHUNK_SIZE];     // KeywordId, OperatorId or LexError, by type
+    uint32_t lengths[TOKEN_CHUNK_SIZE];
+    size_t offsets[TOKEN_CHUNK_SIZE];
+    int count;
+    struct TokenChunk* next;
+} TokenChunk;
+
+typedef struct TokenBuffer {
+    Lexer* lexer;              // Not owned
+    TokenChunk* head;          // Chunk of the current token
+    int position;              // Current token's index in head
+    TokenChunk* tail;          // Last chunk lexed
+    int chunks;                // Chunks from head to tail
+    bool done;                 // The EOF token has been lexed
+    bool failed;               // Out of memory: the tokens end early
+    // Lexer thread (all of the above from head on is shared with it)
+    bool threaded;
+    bool stopping;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} TokenBuffer;
+
+TokenBuffer* token_buffer_create(Lexer* lexer);
+void token_buffer_destroy(TokenBuffer* buffer);
+
+// Lex the rest of the input on a thread of its own; false if it does not
+// run (a streamed lexer, lexing already done, or no thread to be had)
+bool token_buffer_start_thread(TokenBuffer* buffer);
+
+// Token distance places after the current one (0: the current token),
+// distance <= TOKEN_LOOKAHEAD_MAX. Past the end, the EOF token.
+Token token_buffer_peek(TokenBuffer* buffer, int distance);
+
+// Token at index of a chunk. Fields are stored one by one: a Token built
+// on the stack and copied out whole stalls on store forwarding.
+static inline void token_chunk_get(const TokenChunk* chunk, int index, Token* token) {
+    TokenType type = (TokenType)chunk->types[index];
+    token->type = type;
+    token->keyword = type == TOKEN_KEYWORD ? (KeywordId)chunk->ids[index] : KW_NONE;
+    token->op = type == TOKEN_OPERATOR ? (OperatorId)chunk->ids[index] : OP_NONE;
+    token->error = type == TOKEN_ERROR ? (LexError)chunk->ids[index] : LEX_ERROR_NONE;
+    token->offset = chunk->offsets[index];
+    token->length = (int)chunk->lengths[index];
+}
+
+// token_buffer_advance across the end of the current chunk
+void token_buffer_advance_chunk(TokenBuffer* buffer, Token* token);
+
+// Move to the next token and store it in *token (stays on the EOF token)
+static inline void token_buffer_advance(TokenBuffer* buffer, Token* token) {
+    TokenChunk* head = buffer->head;
+    if (head && buffer->position + 1 < head->count) {
+        token_chunk_get(head, ++buffer->position, token);
+    } else {
+        token_buffer_advance_chunk(buffer, token);
+    }
+}
+
+// Stop the lexer thread; later chunks are lexed on the reading thread.
+// Call before reading lexer state the thread writes, such as its line index.
+void token_buffer_join(TokenBuffer* buffer);
+
+#endif // TOKEN_BUFFER_H
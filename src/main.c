@@ -2,248 +2,768 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include "lexer/lexer.h"
 #include "parser/parser.h"
 #include "ast/ast.h"
 #include "semantic/semantic.h"
+#include "semantic/import_system.h"
+#include "semantic/types.h"
+#include "semantic/module_interface.h"
 #include "codegen/codegen.h"
+#include "utils/string_intern.h"
+#include "utils/log.h"
+#include "utils/timing.h"
+#include "utils/thread_pool.h"
+#include "utils/string_builder.h"
+#include "driver/module_graph.h"
+#include "driver/build_cache.h"
+#include "driver/server.h"
 
-// Read file contents
-char* read_file(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        printf("Error: Cannot open file '%s'\n", filename);
-        return NULL;
+#define ECHO_VERSION "1.0"
+
+// Compiler identity in cache keys when the executable cannot be read
+#define ECHO_BUILD_ID ECHO_VERSION " " __DATE__ " " __TIME__
+
+// --time-report settings of the current compilation
+static const char* time_report_format = NULL;
+static const char* time_report_input = NULL;
+
+// Cache entries kept in memory by a compile server (--server)
+static BuildCache* server_cache = NULL;
+
+// Interned strings and types a compile server keeps warm between requests;
+// past either mark, both tables are released after the request
+#define SERVER_INTERN_LIMIT (1u << 18)
+#define SERVER_TYPE_LIMIT (1u << 16)
+
+// Close the compile phase and print the report
+static void print_time_report(void) {
+    timing_end(0);
+    
+    if (strcmp(time_report_format, "json") == 0) {
+        timing_report_json(stderr, ECHO_VERSION, time_report_input);
+    } else {
+        timing_report_text(stderr);
     }
+    timing_reset();
+}
+
+// Parse a -j value (a positive thread count), 0 if invalid
+static int parse_jobs(const char* text) {
+    if (!text || !*text) return 0;
     
-    fseek(file, 0, SEEK_END);
-    long length = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    char* end = NULL;
+    long jobs = strtol(text, &end, 10);
+    return *end == '\0' && jobs >= 1 && jobs <= 256 ? (int)jobs : 0;
+}
+
+// Generate output filename: the input with its extension replaced
+char* generate_output_filename(const char* input_filename, const char* extension) {
+    if (!input_filename || !extension) return NULL;
     
-    char* content = malloc(length + 1);
-    if (!content) {
-        printf("Error: Memory allocation failed\n");
-        fclose(file);
-        return NULL;
+    // Find the last dot to replace extension
+    const char* dot = strrchr(input_filename, '.');
+    const char* slash = strrchr(input_filename, '/');
+    
+    // If no dot found or dot is before last slash, append the extension
+    size_t base_len = (!dot || (slash && dot < slash)) ? strlen(input_filename) : (size_t)(dot - input_filename);
+    char* output = malloc(base_len + strlen(extension) + 1);
+    if (!output) return NULL;
+    
+    memcpy(output, input_filename, base_len);
+    strcpy(output + base_len, extension);
+    
+    return output;
+}
+
+// Create the semantic contexts of modules (indices)
+static bool create_semantic_contexts(ModuleGraph* graph, const int* modules, int count) {
+    for (int i = 0; i < count; i++) {
+        Module* module = &graph->modules[modules[i]];
+        module->semantic = semantic_create();
+        if (!module->semantic) return false;
+        
+        // Set filename for error reporting
+        module->semantic->current_filename = strdup(module->path);
+        module->semantic->lines = module->lexer ? &module->lexer->lines : NULL;
+        
+        // Add builtin modules and functions
+        semantic_add_builtin_modules(module->semantic);
+    }
+    return true;
+}
+
+// Compiler identity in cache keys: a hash of the running executable, so a
+// compiler rebuilt after a change to any of its sources recompiles everything
+static uint64_t compiler_build_hash(void) {
+    static uint64_t hash;
+    static bool known = false;
+    if (!known) {
+        if (!build_cache_hash_file("/proc/self/exe", &hash)) {
+            hash = build_cache_hash_string(BUILD_CACHE_SEED, ECHO_BUILD_ID);
+        }
+        known = true;
     }
+    return hash;
+}
+
+// Cache key of a module: its source and name, whether it is imported (which
+// decides its C names), the compiler, the shared header it includes and the
+// interfaces of the modules it imports
+static uint64_t module_cache_key(ModuleGraph* graph, Module* module, const char* shared_header) {
+    uint64_t key = compiler_build_hash();
+    key = build_cache_hash_string(key, shared_header ? shared_header : "");
+    key = build_cache_hash_string(key, module->name);
+    key = build_cache_hash(key, &module->imported, sizeof(module->imported));
+    key = build_cache_hash(key, &module->source_hash, sizeof(module->source_hash));
+    for (int i = 0; i < module->import_count; i++) {
+        key = build_cache_hash_string(key, graph->modules[module->imports[i]].interface);
+    }
+    return key;
+}
+
+// Reuse a module's cache entry if its key matches and the C file it
+// produced is untouched; the interface then comes from the entry
+static bool module_reuse_cached(Module* module) {
+    if (!module->cached || module->cached->key != module->cache_key) return false;
+    
+    char* output_filename = generate_output_filename(module->path, ".c");
+    uint64_t output_hash = 0;
+    bool intact = build_cache_hash_file(output_filename, &output_hash) &&
+                  output_hash == module->cached->output_hash;
+    free(output_filename);
+    if (!intact) return false;
+    
+    module->interface = strdup(module->cached->interface);
+    module->up_to_date = module->interface != NULL;
+    return module->up_to_date;
+}
+
+// Declarations of an up-to-date module from the interface file written
+// next to its C file, if that still describes its source
+static bool load_module_interface(Module* module) {
+    char* interface_filename = generate_output_filename(module->path, ".ei");
+    module->ast = module_interface_read(interface_filename, module->source_hash);
+    free(interface_filename);
+    return module->ast != NULL;
+}
+
+// Give the pending modules of a level what they need for analysis: their
+// own ASTs, and in the registry the declarations of the modules they
+// import, from interface files where possible
+static bool prepare_modules(ModuleGraph* graph, const int* pending, int pending_count, int jobs) {
+    int* parse = calloc(graph->count, sizeof(int));
+    bool* listed = calloc(graph->count, sizeof(bool));
+    bool success = parse && listed;
+    
+    int phase = timing_begin("interface");
+    int parse_count = 0;
+    for (int i = 0; success && i < pending_count; i++) {
+        Module* module = &graph->modules[pending[i]];
+        for (int j = -1; j < module->import_count; j++) {
+            int index = j < 0 ? pending[i] : module->imports[j];
+            if (graph->modules[index].ast || listed[index]) continue;
+            
+            listed[index] = true;
+            if (j < 0 || !load_module_interface(&graph->modules[index])) {
+                parse[parse_count++] = index;
+            }
+        }
+    }
+    timing_end(phase);
     
-    fread(content, 1, length, file);
-    content[length] = '\0';
+    if (success && parse_count > 0) {
+        success = module_graph_parse(graph, parse, parse_count, jobs);
+    }
     
-    fclose(file);
-    return content;
+    for (int i = 0; success && i < pending_count; i++) {
+        Module* module = &graph->modules[pending[i]];
+        for (int j = 0; success && j < module->import_count; j++) {
+            Module* imported = &graph->modules[module->imports[j]];
+            if (imported->registered) continue;
+            
+            imported->registered = import_register_module(imported->name, imported->ast);
+            if (!imported->registered) {
+                LOG_ERROR(LOG_CAT_DRIVER, "Error: Failed to register module '%s'\n", imported->name);
+                success = false;
+            }
+        }
+    }
+    
+    free(parse);
+    free(listed);
+    return success;
+}
+
+// Modules of one level, analyzed on worker threads
+typedef struct ModuleAnalysis {
+    ModuleGraph* graph;
+    const int* modules;            // Module indices
+    bool* success;
+} ModuleAnalysis;
+
+static void analyze_module_job(void* arg, int index, int worker) {
+    (void)worker;
+    ModuleAnalysis* analysis = arg;
+    Module* module = &analysis->graph->modules[analysis->modules[index]];
+    analysis->success[index] = semantic_analyze_program(module->semantic, module->ast);
 }
 
-// Generate output filename
-char* generate_output_filename(const char* input_filename) {
-    if (!input_filename) return NULL;
+// Analyze the modules level by level. Modules whose cache entry still holds
+// are skipped; the others of a level run on the thread pool once the modules
+// they import are registered, and their diagnostics are printed in module
+// order. A lone module uses the threads for its bodies. In a multi-module
+// build every module's interface is rendered for the shared header.
+static bool analyze_modules(ModuleGraph* graph, int jobs, const char* shared_header) {
+    int* pending = calloc(graph->count, sizeof(int));
+    bool* results = calloc(graph->count, sizeof(bool));
+    bool success = pending && results;
+    
+    int start = 0;
+    while (success && start < graph->count) {
+        int level = graph->modules[graph->order[start]].level;
+        int end = start;
+        while (end < graph->count && graph->modules[graph->order[end]].level == level) end++;
+        
+        int pending_count = 0;
+        for (int i = start; i < end; i++) {
+            Module* module = &graph->modules[graph->order[i]];
+            module->cache_key = module_cache_key(graph, module, shared_header);
+            if (module_reuse_cached(module)) {
+                LOG_INFO(LOG_CAT_DRIVER, "Up to date: %s\n", module->path);
+            } else {
+                pending[pending_count++] = graph->order[i];
+            }
+        }
+        
+        if (!prepare_modules(graph, pending, pending_count, jobs) ||
+            !create_semantic_contexts(graph, pending, pending_count)) {
+            success = false;
+            break;
+        }
+        
+        for (int i = 0; i < pending_count; i++) {
+            Module* module = &graph->modules[pending[i]];
+            module->semantic->jobs = pending_count == 1 ? jobs : 1;
+            LOG_INFO(LOG_CAT_SEMANTIC, "Starting semantic analysis of %s...\n", module->path);
+        }
+        
+        ModuleAnalysis analysis = { graph, pending, results };
+        thread_pool_run(jobs, pending_count, analyze_module_job, &analysis);
+        
+        for (int i = 0; i < pending_count; i++) {
+            Module* module = &graph->modules[pending[i]];
+            if (!semantic_report(module->semantic, results[i]) || semantic_has_errors(module->semantic)) {
+                success = false;
+                continue;
+            }
+            
+            module->interface = shared_header ?
+                codegen_render_module_interface(module->semantic->symbol_table, module->ast, module->name,
+                                                module->imported) :
+                strdup("");
+            if (!module->interface) {
+                LOG_ERROR(LOG_CAT_CODEGEN, "❌ Code generation failed for the interface of %s\n", module->name);
+                success = false;
+            }
+        }
+        
+        start = end;
+    }
     
-    // Find the last dot to replace extension
-    const char* dot = strrchr(input_filename, '.');
-    const char* slash = strrchr(input_filename, '/');
+    free(pending);
+    free(results);
+    return success;
+}
+
+// Generate the C translation unit of one module
+static CodegenResult generate_module(Module* module, const char* output_filename,
+                                     const char* shared_header, int jobs) {
+    FILE* output_file = fopen(output_filename, "w");
+    if (!output_file) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot create output file '%s'\n", output_filename);
+        return CODEGEN_ERROR_FILE_IO;
+    }
     
-    // If no dot found or dot is before last slash, append .c
-    if (!dot || (slash && dot < slash)) {
-        size_t len = strlen(input_filename);
-        char* output = malloc(len + 3); // +2 for ".c" +1 for null
-        if (!output) return NULL;
-        strcpy(output, input_filename);
-        strcat(output, ".c");
-        return output;
+    CodeGenerator* codegen = codegen_create_with_inference(output_file, module->semantic->symbol_table, 
+                                                          module->semantic->type_inference);
+    if (!codegen) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Failed to create code generator\n");
+        fclose(output_file);
+        return CODEGEN_ERROR_MEMORY_ALLOCATION;
     }
+    codegen->jobs = jobs;
+    codegen->shared_header = shared_header;
+    codegen->module_path = module->imported ? module->name : NULL;
     
-    // Replace extension with .c
-    size_t base_len = dot - input_filename;
-    char* output = malloc(base_len + 3); // +2 for ".c" +1 for null
-    if (!output) return NULL;
+    CodegenResult result = codegen_generate(codegen, module->ast);
+    codegen_destroy(codegen);
+    
+    if (fclose(output_file) != 0 && result == CODEGEN_SUCCESS) {
+        result = CODEGEN_ERROR_FILE_IO;
+    }
+    return result;
+}
+
+// Replace a file's contents unless it already holds exactly `text`, so an
+// unchanged header keeps its timestamp
+static bool write_if_changed(const char* filename, const char* text, size_t length) {
+    FILE* file = fopen(filename, "rb");
+    if (file) {
+        char* current = malloc(length + 1);
+        bool same = current && fread(current, 1, length + 1, file) == length &&
+                    memcmp(current, text, length) == 0;
+        free(current);
+        fclose(file);
+        if (same) return true;
+    }
     
-    strncpy(output, input_filename, base_len);
-    output[base_len] = '\0';
-    strcat(output, ".c");
+    file = fopen(filename, "wb");
+    if (!file) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot create output file '%s'\n", filename);
+        return false;
+    }
     
-    return output;
+    bool ok = fwrite(text, 1, length, file) == length;
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Cannot write output file '%s'\n", filename);
+    }
+    return ok;
 }
 
-int main(int argc, char* argv[]) {
-    printf("Echo Language Compiler v1.0\n");
-    printf("===========================\n\n");
+// Write the header shared by the modules of a multi-module build: the
+// modules' interfaces in dependency order
+static bool generate_shared_header(ModuleGraph* graph, const char* header_filename) {
+    // Include guard from the root's name: ECHO_<NAME>_H
+    const char* root = graph->modules[0].name;
+    char guard[128];
+    size_t length = snprintf(guard, sizeof(guard) - 2, "ECHO_%s", root);
+    if (length > sizeof(guard) - 3) length = sizeof(guard) - 3;
+    for (size_t i = 5; i < length; i++) {
+        guard[i] = isalnum((unsigned char)guard[i]) ? toupper((unsigned char)guard[i]) : '_';
+    }
+    strcpy(guard + length, "_H");
     
-    if (argc != 2) {
-        printf("Usage: %s <echo_file>\n", argv[0]);
-        printf("Example: %s examples/hello.ec\n", argv[0]);
-        return 1;
+    CodeGenerator* header = codegen_create(NULL, NULL);
+    CodegenResult result = header ? codegen_generate_header_begin(header, guard) : CODEGEN_ERROR_MEMORY_ALLOCATION;
+    for (int i = 0; i < graph->count && result == CODEGEN_SUCCESS; i++) {
+        codegen_write_raw(header, graph->modules[graph->order[i]].interface);
+    }
+    if (result == CODEGEN_SUCCESS) {
+        result = codegen_generate_header_end(header, guard);
+    }
+    if (header && header->output_failed && result == CODEGEN_SUCCESS) {
+        result = CODEGEN_ERROR_MEMORY_ALLOCATION;
     }
     
-    char* source = read_file(argv[1]);
-    if (!source) {
-        return 1;
+    if (result == CODEGEN_SUCCESS &&
+        !write_if_changed(header_filename, header->buffer.data, header->buffer.length)) {
+        result = CODEGEN_ERROR_FILE_IO;
     }
+    codegen_destroy(header);
     
-    printf("Compiling file: %s\n", argv[1]);
-    printf("Source code:\n");
-    printf("------------\n");
-    printf("%s\n", source);
-    printf("------------\n\n");
+    if (result != CODEGEN_SUCCESS) {
+        LOG_ERROR(LOG_CAT_CODEGEN, "❌ Code generation failed for %s: %s\n", header_filename, codegen_result_to_string(result));
+        return false;
+    }
+    return true;
+}
+
+// Record the compilation of a module in the cache. Failures only cost a
+// rebuild next time, so they are warnings.
+static void store_cache_entry(ModuleGraph* graph, Module* module, const char* output_filename) {
+    char* imports[module->import_count + 1];
+    for (int i = 0; i < module->import_count; i++) {
+        imports[i] = graph->modules[module->imports[i]].name;
+    }
     
-    // Create lexer
-    Lexer* lexer = lexer_create(source);
-    if (!lexer) {
-        printf("Error: Failed to create lexer\n");
-        free(source);
-        return 1;
+    CacheEntry entry = { module->source_hash, module->cache_key, 0,
+                         imports, module->import_count, module->interface };
+    if (!build_cache_hash_file(output_filename, &entry.output_hash) ||
+        !build_cache_store(graph->cache, module->key, &entry)) {
+        LOG_WARN(LOG_CAT_DRIVER, "Warning: Cannot write the cache entry of %s\n", module->path);
+    }
+}
+
+// Modules generated on worker threads
+typedef struct ModuleOutput {
+    ModuleGraph* graph;
+    const int* modules;            // Module indices
+    char** filenames;              // By module index
+    const char* shared_header;
+    int jobs;                      // Threads per module
+    CodegenResult* results;
+} ModuleOutput;
+
+static void generate_module_job(void* arg, int index, int worker) {
+    (void)worker;
+    ModuleOutput* output = arg;
+    int module = output->modules[index];
+    output->results[index] = generate_module(&output->graph->modules[module], output->filenames[module],
+                                             output->shared_header, output->jobs);
+    
+    // Imported modules get an interface file next to the C file
+    Module* generated = &output->graph->modules[module];
+    if (output->results[index] == CODEGEN_SUCCESS && generated->imported) {
+        char* interface_filename = generate_output_filename(generated->path, ".ei");
+        if (!module_interface_write(interface_filename, generated->ast, generated->source_hash)) {
+            LOG_WARN(LOG_CAT_DRIVER, "Warning: Cannot write interface file '%s'\n",
+                     interface_filename ? interface_filename : generated->path);
+        }
+        free(interface_filename);
+    }
+}
+
+// Generate one C file per module that is not up to date, plus the shared
+// header when there are several modules (named after the first root, next
+// to it) and an interface file for each generated module that is imported;
+// generated modules are recorded in the cache
+static bool generate_modules(ModuleGraph* graph, int jobs, const char* header_filename) {
+    char** filenames = calloc(graph->count, sizeof(char*));
+    int* pending = calloc(graph->count, sizeof(int));
+    CodegenResult* results = calloc(graph->count, sizeof(CodegenResult));
+    bool success = filenames && pending && results;
+    
+    int pending_count = 0;
+    for (int i = 0; success && i < graph->count; i++) {
+        filenames[i] = generate_output_filename(graph->modules[i].path, ".c");
+        if (!filenames[i]) {
+            LOG_ERROR(LOG_CAT_DRIVER, "Error: Failed to generate output filename\n");
+            success = false;
+        } else {
+            LOG_INFO(LOG_CAT_DRIVER, "Output file: %s\n", filenames[i]);
+        }
+        if (!graph->modules[i].up_to_date) pending[pending_count++] = i;
     }
     
-    // Create parser
-    Parser* parser = parser_create(lexer);
-    if (!parser) {
-        printf("Error: Failed to create parser\n");
-        lexer_destroy(lexer);
-        free(source);
-        return 1;
+    int phase = timing_begin("codegen");
+    if (success && header_filename) {
+        success = generate_shared_header(graph, header_filename);
     }
     
-    printf("Parsing...\n");
-    printf("----------\n");
+    if (success) {
+        const char* slash = header_filename ? strrchr(header_filename, '/') : NULL;
+        ModuleOutput output = { graph, pending, filenames, slash ? slash + 1 : header_filename,
+                                pending_count == 1 ? jobs : 1, results };
+        thread_pool_run(jobs, pending_count, generate_module_job, &output);
+        
+        for (int i = 0; i < pending_count; i++) {
+            if (results[i] != CODEGEN_SUCCESS) {
+                LOG_ERROR(LOG_CAT_CODEGEN, "❌ Code generation failed: %s\n", codegen_result_to_string(results[i]));
+                success = false;
+            }
+        }
+    }
     
-    // Parse the program
-    ASTNode* ast = parser_parse(parser);
+    for (int i = 0; success && graph->cache && i < pending_count; i++) {
+        store_cache_entry(graph, &graph->modules[pending[i]], filenames[pending[i]]);
+    }
+    timing_end(phase);
     
-    if (parser_has_error(parser)) {
-        printf("Parse failed with errors:\n");
-        printf("%s\n", parser_get_error(parser));
+    if (success) {
+        LOG_INFO(LOG_CAT_DRIVER, "\n🎉 Compilation completed successfully!\n");
+        for (int i = 0; i < graph->count; i++) {
+            LOG_INFO(LOG_CAT_DRIVER, "Generated C code: %s\n", filenames[i]);
+        }
+        if (header_filename) {
+            LOG_INFO(LOG_CAT_DRIVER, "Shared header: %s\n", header_filename);
+        }
         
-        if (ast) {
-            ast_destroy(ast);
+        // Modules in other directories include the shared header by name
+        StringBuilder command;
+        string_builder_init(&command);
+        if (header_filename) {
+            const char* slash = strrchr(header_filename, '/');
+            if (!slash) {
+                string_builder_append(&command, " -I .");
+            } else if (slash == header_filename) {
+                string_builder_append(&command, " -I /");
+            } else {
+                string_builder_appendf(&command, " -I %.*s", (int)(slash - header_filename), header_filename);
+            }
         }
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
-        return 1;
+        for (int i = 0; i < graph->count; i++) {
+            string_builder_appendf(&command, " %s", filenames[i]);
+        }
+        LOG_INFO(LOG_CAT_DRIVER, "Next step: Compile with gcc\n");
+        LOG_INFO(LOG_CAT_DRIVER, "  gcc -o program%s\n", command.data ? command.data : "");
+        string_builder_free(&command);
     }
     
-    if (!ast) {
-        printf("Error: Failed to parse program\n");
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
-        return 1;
+    for (int i = 0; filenames && i < graph->count; i++) {
+        free(filenames[i]);
+    }
+    free(filenames);
+    free(pending);
+    free(results);
+    return success;
+}
+
+// Parse, analyze and generate every module reachable from the roots
+static int compile_modules(ModuleGraph* graph, int jobs, bool ast_stats) {
+    for (int i = 0; i < graph->count; i++) {
+        LOG_INFO(LOG_CAT_DRIVER, "Compiling file: %s\n", graph->modules[i].path);
     }
     
-    printf("Parse successful! AST:\n");
-    printf("----------------------\n");
-    ast_print(ast, 0);
-    printf("\n");
+    LOG_INFO(LOG_CAT_DRIVER, "Parsing...\n");
+    LOG_INFO(LOG_CAT_DRIVER, "----------\n");
     
-    // Semantic analysis
-    printf("Semantic Analysis...\n");
-    printf("-------------------\n");
-    
-    SemanticContext* semantic = semantic_create();
-    if (!semantic) {
-        printf("Error: Failed to create semantic analyzer\n");
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
+    if (!module_graph_load(graph, jobs) || !module_graph_sort(graph)) {
         return 1;
     }
     
-    // Set filename for error reporting
-    semantic->current_filename = strdup(argv[1]);
-    
-    // Add builtin modules and functions
-    semantic_add_builtin_modules(semantic);
+    LOG_INFO(LOG_CAT_PARSER, "Parse successful!\n");
+    for (int i = 0; i < graph->count; i++) {
+        Module* module = &graph->modules[graph->order[i]];
+        
+        // Streamed sources are never held in memory as a whole
+        if (module->source.data) {
+            LOG_DEBUG(LOG_CAT_LEXER, "Source code (%s):\n", module->path);
+            LOG_DEBUG(LOG_CAT_LEXER, "------------\n");
+            LOG_DEBUG(LOG_CAT_LEXER, "%.*s\n", (int)module->source.length, module->source.data);
+            LOG_DEBUG(LOG_CAT_LEXER, "------------\n\n");
+        }
+        
+        // Modules taken from the cache may not have been parsed
+        if (!module->ast) continue;
+        
+        if (log_enabled(LOG_CAT_PARSER, LOG_LEVEL_DEBUG)) {
+            printf("AST:\n");
+            printf("----------------------\n");
+            ast_print(module->ast, 0, &module->lexer->lines);
+            printf("\n");
+        }
+        
+        if (ast_stats) {
+            ast_print_memory_stats(module->ast);
+            printf("\n");
+        }
+    }
     
-    bool semantic_ok = semantic_analyze(semantic, ast);
+    // Semantic analysis
+    LOG_INFO(LOG_CAT_DRIVER, "Semantic Analysis...\n");
+    LOG_INFO(LOG_CAT_DRIVER, "-------------------\n");
     
-    if (!semantic_ok || semantic_has_errors(semantic)) {
-        printf("\n❌ Compilation failed due to semantic errors\n");
-        semantic_destroy(semantic);
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
+    char* header_filename = graph->count > 1 ? generate_output_filename(graph->modules[0].path, ".h") : NULL;
+    if (graph->count > 1 && !header_filename) {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Failed to generate output filename\n");
         return 1;
     }
     
-    // Code generation
-    printf("\nCode Generation...\n");
-    printf("-----------------\n");
-    
-    // Generate output filename
-    char* output_filename = generate_output_filename(argv[1]);
-    if (!output_filename) {
-        printf("Error: Failed to generate output filename\n");
-        semantic_destroy(semantic);
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
+    const char* slash = header_filename ? strrchr(header_filename, '/') : NULL;
+    int phase = timing_begin("semantic");
+    bool semantic_ok = analyze_modules(graph, jobs, slash ? slash + 1 : header_filename);
+    timing_end(phase);
+    
+    if (!semantic_ok) {
+        LOG_ERROR(LOG_CAT_SEMANTIC, "\n❌ Compilation failed due to semantic errors\n");
+        free(header_filename);
         return 1;
     }
     
-    printf("Output file: %s\n", output_filename);
+    // Code generation
+    LOG_INFO(LOG_CAT_DRIVER, "\nCode Generation...\n");
+    LOG_INFO(LOG_CAT_DRIVER, "-----------------\n");
     
-    // Open output file
-    FILE* output_file = fopen(output_filename, "w");
-    if (!output_file) {
-        printf("Error: Cannot create output file '%s'\n", output_filename);
-        free(output_filename);
-        semantic_destroy(semantic);
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
-        return 1;
+    bool generated = generate_modules(graph, jobs, header_filename);
+    free(header_filename);
+    return generated ? 0 : 1;
+}
+
+// One compilation; a compile server runs this once per request
+static int compile_command(int argc, char* argv[]) {
+    // Settings of an earlier request must not leak into this one
+    log_set_all_levels(LOG_DEFAULT_LEVEL);
+    time_report_format = NULL;
+    time_report_input = NULL;
+    
+    // Parse command line options
+    const char* input_filenames[argc];
+    const char* module_paths[argc];
+    int input_count = 0;
+    int module_path_count = 0;
+    const char* cache_directory = NULL;
+    bool ast_stats = false;
+    bool stream_sources = false;
+    int jobs = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ast-stats") == 0) {
+            ast_stats = true;
+        } else if (strcmp(argv[i], "--time-report") == 0) {
+            time_report_format = "text";
+        } else if (strncmp(argv[i], "--time-report=", 14) == 0) {
+            time_report_format = argv[i] + 14;
+            if (strcmp(time_report_format, "text") != 0 && strcmp(time_report_format, "json") != 0) {
+                printf("Error: Unknown time report format '%s'\n", time_report_format);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "-j", 2) == 0 || strncmp(argv[i], "--jobs=", 7) == 0) {
+            const char* value = argv[i][1] == 'j' ? argv[i] + 2 : argv[i] + 7;
+            if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                value = argv[++i];
+            }
+            jobs = parse_jobs(value);
+            if (jobs == 0) {
+                printf("Error: Invalid job count '%s'\n", value);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "-I", 2) == 0 || strncmp(argv[i], "--module-path=", 14) == 0) {
+            const char* value = argv[i][1] == 'I' ? argv[i] + 2 : argv[i] + 14;
+            if (strcmp(argv[i], "-I") == 0 && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (!*value) {
+                printf("Error: Missing module directory\n");
+                return 1;
+            }
+            module_paths[module_path_count++] = value;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream_sources = true;
+        } else if (strncmp(argv[i], "--cache-dir=", 12) == 0 && argv[i][12]) {
+            cache_directory = argv[i] + 12;
+        } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            log_set_all_levels(LOG_LEVEL_ERROR);
+        } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
+            log_set_all_levels(LOG_LEVEL_INFO);
+        } else if (strcmp(argv[i], "-vv") == 0) {
+            log_set_all_levels(LOG_LEVEL_DEBUG);
+        } else if (strncmp(argv[i], "--log=", 6) == 0) {
+            if (!log_configure(argv[i] + 6)) {
+                printf("Error: Invalid log specification '%s'\n", argv[i] + 6);
+                return 1;
+            }
+        } else if (argv[i][0] != '-') {
+            input_filenames[input_count++] = argv[i];
+        } else {
+            input_count = 0;
+            break;
+        }
     }
     
-    // Create code generator
-    CodeGenerator* codegen = codegen_create_with_inference(output_file, semantic->symbol_table, 
-                                                          semantic->type_inference);
-    if (!codegen) {
-        printf("Error: Failed to create code generator\n");
-        fclose(output_file);
-        free(output_filename);
-        semantic_destroy(semantic);
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
+    if (input_count == 0) {
+        printf("Usage: %s [options] <echo_file>...\n", argv[0]);
+        printf("Options:\n");
+        printf("  -q, --quiet        Report errors only\n");
+        printf("  -v, --verbose      Report compilation progress\n");
+        printf("  -vv                Also dump source, AST and debug traces\n");
+        printf("  --log=SPEC         Per-phase levels, e.g. 'semantic=debug,codegen=info'\n");
+        printf("                     (phases: driver lexer parser semantic inference codegen;\n");
+        printf("                      levels: silent error warn info debug trace)\n");
+        printf("  -j N, --jobs=N     Compile modules and function bodies on N threads\n");
+        printf("  -I DIR, --module-path=DIR\n");
+        printf("                     Also look for imported modules in DIR\n");
+        printf("  --cache-dir=DIR    Keep compiled modules in DIR and recompile only\n");
+        printf("                     what changed since the last build\n");
+        printf("  --stream           Read sources in fixed-size chunks instead of\n");
+        printf("                     mapping them (memory stays bounded)\n");
+        printf("  --server=SOCKET    Serve compilations on a Unix socket, keeping\n");
+        printf("                     compiler state warm between them\n");
+        printf("  --connect=SOCKET   Run this compilation on a compile server\n");
+        printf("  --ast-stats        Print AST memory statistics\n");
+        printf("  --time-report[=text|json]\n");
+        printf("                     Print per-phase time and memory to stderr\n");
+        printf("Example: %s examples/hello.ec\n", argv[0]);
         return 1;
     }
     
-    // Generate C code
-    CodegenResult result = codegen_generate(codegen, ast);
+    if (time_report_format) {
+        time_report_input = input_filenames[0];
+        timing_enable(true);
+        timing_begin("compile");
+    }
     
-    if (result != CODEGEN_SUCCESS) {
-        printf("❌ Code generation failed: %s\n", codegen_result_to_string(result));
-        codegen_destroy(codegen);
-        fclose(output_file);
-        free(output_filename);
-        semantic_destroy(semantic);
-        ast_destroy(ast);
-        parser_destroy(parser);
-        lexer_destroy(lexer);
-        free(source);
-        return 1;
+    LOG_INFO(LOG_CAT_DRIVER, "Echo Language Compiler v" ECHO_VERSION "\n");
+    LOG_INFO(LOG_CAT_DRIVER, "===========================\n\n");
+    
+    // All AST nodes of this compilation live in one arena
+    Arena* ast_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    ast_use_arena(ast_arena);
+    
+    // Roots first: their directories come before -I directories in the search path
+    ModuleGraph* graph = module_graph_create();
+    bool ready = graph != NULL;
+    if (ready) graph->stream_sources = stream_sources;
+    for (int i = 0; ready && i < input_count; i++) {
+        ready = module_graph_add_root(graph, input_filenames[i]);
+    }
+    for (int i = 0; ready && i < module_path_count; i++) {
+        ready = module_graph_add_search_path(graph, module_paths[i]);
     }
     
-    // Close output file
-    fclose(output_file);
+    // A compile server falls back to its in-memory cache
+    BuildCache* cache = NULL;
+    if (ready && !cache_directory) {
+        graph->cache = server_cache;
+    } else if (ready) {
+        cache = build_cache_open(cache_directory);
+        graph->cache = cache;
+        if (!cache) {
+            LOG_WARN(LOG_CAT_DRIVER, "Warning: Cannot use cache directory '%s'\n", cache_directory);
+        }
+    }
     
-    printf("\n🎉 Compilation completed successfully!\n");
-    printf("Generated C code: %s\n", output_filename);
-    printf("Next step: Compile with gcc\n");
-    printf("  gcc -o program %s\n", output_filename);
+    int status = 1;
+    if (ready) {
+        status = compile_modules(graph, jobs, ast_stats);
+    } else {
+        LOG_ERROR(LOG_CAT_DRIVER, "Error: Memory allocation failed\n");
+    }
     
-    // Cleanup
-    codegen_destroy(codegen);
-    free(output_filename);
-    semantic_destroy(semantic);
-    ast_destroy(ast);
-    parser_destroy(parser);
-    lexer_destroy(lexer);
-    free(source);
-    
-    return 0;
-} 
\ No newline at end of file
+    // Cleanup; interned strings and types outlive the compilation
+    module_graph_destroy(graph);
+    build_cache_close(cache);
+    ast_use_arena(NULL);
+    arena_destroy(ast_arena);
+    import_registry_clear_user_modules();
+    
+    if (time_report_format) {
+        print_time_report();
+    }
+    return status;
+}
+
+// A compile server request. Nothing kept between requests holds interned
+// strings or types (cache entries own copies, the import index is rebuilt
+// on use), so the tables can be reset once they grow too large.
+static int server_compile_command(int argc, char* argv[]) {
+    int status = compile_command(argc, argv);
+    if (intern_count() > SERVER_INTERN_LIMIT || types_count() > SERVER_TYPE_LIMIT) {
+        types_clear();
+        intern_clear();
+    }
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strncmp(argv[1], "--server=", 9) == 0) {
+        if (argc > 2) {
+            printf("Error: --server takes no other options\n");
+            return 1;
+        }
+        server_cache = build_cache_open(NULL);
+        int status = server_cache ? server_run(argv[1] + 9, server_compile_command) : 1;
+        build_cache_close(server_cache);
+        import_registry_clear();
+        types_clear();
+        intern_clear();
+        return status;
+    }
+    
+    if (argc >= 2 && strncmp(argv[1], "--connect=", 10) == 0) {
+        // The server sees the command line without --connect
+        char* request[argc];
+        request[0] = argv[0];
+        for (int i = 2; i < argc; i++) {
+            request[i - 1] = argv[i];
+        }
+        return server_request(argv[1] + 10, argc - 1, request);
+    }
+    
+    int status = compile_command(argc, argv);
+    import_registry_clear();
+    types_clear();
+    intern_clear();
+    return status;
+}
@@ -1,26 +1,21 @@
 #define _GNU_SOURCE
 #include "parser.h"
+#include "../utils/log.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// Type keywords
-static const char* type_keywords[] = {
-    "i8", "i16", "i32", "i64", "f32", "f64", "bool", "string", "char", "void", "auto", NULL
+// Binary operator precedence, indexed by OperatorId (0: not a binary operator)
+static const unsigned char binary_precedence[OP_COUNT] = {
+    [OP_OR] = 1, [OP_AND] = 2, [OP_EQUAL] = 3, [OP_NOT_EQUAL] = 3,
+    [OP_LESS] = 4, [OP_GREATER] = 4, [OP_LESS_EQUAL] = 4, [OP_GREATER_EQUAL] = 4,
+    [OP_PLUS] = 5, [OP_MINUS] = 5, [OP_STAR] = 6, [OP_SLASH] = 6, [OP_PERCENT] = 6
 };
 
-// Binary operators with precedence
-static const struct {
-    const char* op;
-    int precedence;
-} binary_operators[] = {
-    {"||", 1}, {"&&", 2}, {"==", 3}, {"!=", 3}, {"<", 4}, {">", 4}, 
-    {"<=", 4}, {">=", 4}, {"+", 5}, {"-", 5}, {"*", 6}, {"/", 6}, {"%", 6}, {NULL, 0}
-};
-
-// Unary operators
-static const char* unary_operators[] = {
-    "!", "-", "+", "*", "&", "++", "--", NULL
+// Prefix operators, indexed by OperatorId
+static const bool unary_operators[OP_COUNT] = {
+    [OP_BANG] = true, [OP_MINUS] = true, [OP_PLUS] = true, [OP_STAR] = true,
+    [OP_AMPERSAND] = true, [OP_INCREMENT] = true, [OP_DECREMENT] = true
 };
 
 // Create parser
@@ -30,15 +25,21 @@ Parser* parser_create(Lexer* lexer) {
     Parser* parser = malloc(sizeof(Parser));
     if (!parser) return NULL;
     
+    parser->tokens = token_buffer_create(lexer);
+    if (!parser->tokens) {
+        free(parser);
+        return NULL;
+    }
+    
     parser->lexer = lexer;
     parser->has_error = false;
     parser->error_count = 0;
     parser->error_message = NULL;
+    parser->text_buffer = NULL;
+    parser->text_capacity = 0;
+    parser->jobs = 1;
     
-    // Initialize tokens
-    parser->current_token = lexer_next_token(lexer);
-    parser->peek_token = lexer_next_token(lexer);
-    
+    parser->current_token = token_buffer_peek(parser->tokens, 0);
     return parser;
 }
 
@@ -46,9 +47,9 @@ Parser* parser_create(Lexer* lexer) {
 void parser_destroy(Parser* parser) {
     if (!parser) return;
     
-    token_destroy(&parser->current_token);
-    token_destroy(&parser->peek_token);
+    token_buffer_destroy(parser->tokens);
     free(parser->error_message);
+    free(parser->text_buffer);
     free(parser);
 }
 
@@ -57,18 +58,16 @@ Token parser_current_token(Parser* parser) {
     return parser->current_token;
 }
 
-// Get peek token
-Token parser_peek_token(Parser* parser) {
-    return parser->peek_token;
+// Get a token after the current one (up to TOKEN_LOOKAHEAD_MAX ahead)
+Token parser_peek_token(Parser* parser, int distance) {
+    return token_buffer_peek(parser->tokens, distance);
 }
 
 // Advance to next token
 void parser_advance(Parser* parser) {
     if (!parser) return;
     
-    token_destroy(&parser->current_token);
-    parser->current_token = parser->peek_token;
-    parser->peek_token = lexer_next_token(parser->lexer);
+    token_buffer_advance(parser->tokens, &parser->current_token);
 }
 
 // Check if current token matches type
@@ -96,17 +95,55 @@ bool parser_expect(Parser* parser, TokenType type, const char* message) {
     return false;
 }
 
+// Check if current token is a specific keyword
+bool parser_check_keyword(Parser* parser, KeywordId keyword) {
+    return parser && parser->current_token.type == TOKEN_KEYWORD &&
+           parser->current_token.keyword == keyword;
+}
+
+// Check if current token is the given operator
+bool parser_check_operator(Parser* parser, OperatorId op) {
+    return parser && parser->current_token.type == TOKEN_OPERATOR &&
+           parser->current_token.op == op;
+}
+
+// Check if current token is the given single-character delimiter
+bool parser_check_delimiter(Parser* parser, char delimiter) {
+    return parser && parser->current_token.type == TOKEN_DELIMITER &&
+           *token_start(parser->lexer, &parser->current_token) == delimiter;
+}
+
+// Materialize current token text into the parser's scratch buffer.
+// The result is valid until the next call; AST constructors copy it.
+const char* parser_token_text(Parser* parser) {
+    size_t length = token_copy_text(parser->lexer, &parser->current_token,
+                                    parser->text_buffer, parser->text_capacity);
+    
+    if (length >= parser->text_capacity) {
+        size_t new_capacity = parser->text_capacity ? parser->text_capacity : 64;
+        while (new_capacity <= length) new_capacity *= 2;
+        
+        char* new_buffer = realloc(parser->text_buffer, new_capacity);
+        if (!new_buffer) return "";
+        
+        parser->text_buffer = new_buffer;
+        parser->text_capacity = new_capacity;
+        token_copy_text(parser->lexer, &parser->current_token,
+                        parser->text_buffer, parser->text_capacity);
+    }
+    
+    return parser->text_buffer;
+}
+
 // Expect specific keyword
-bool parser_expect_keyword(Parser* parser, const char* keyword) {
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && 
-        strcmp(parser->current_token.value, keyword) == 0) {
+bool parser_expect_keyword(Parser* parser, KeywordId keyword) {
+    if (parser_check_keyword(parser, keyword)) {
         parser_advance(parser);
         return true;
     }
     
     char error_msg[256];
-    snprintf(error_msg, sizeof(error_msg), "Expected keyword '%s'", keyword);
+    snprintf(error_msg, sizeof(error_msg), "Expected keyword '%s'", keyword_to_string(keyword));
     parser_error(parser, error_msg);
     return false;
 }
@@ -120,15 +157,26 @@ void parser_error(Parser* parser, const char* message) {
     
     free(parser->error_message);
     
+    Token* token = &parser->current_token;
+    bool at_eof = token->type == TOKEN_EOF;
+    int line, column;
+    token_buffer_join(parser->tokens);   // before reading the lexer's line index
+    token_position(parser->lexer, token, &line, &column);
+    
+    // A TOKEN_ERROR also says why the lexer rejected the text
+    bool lex_error = token->type == TOKEN_ERROR;
     char full_message[512];
     snprintf(full_message, sizeof(full_message), 
-             "Parse error at line %d, column %d: %s (got '%s')",
-             parser->current_token.line, parser->current_token.column,
-             message, parser->current_token.value ? parser->current_token.value : "EOF");
+             "Parse error at line %d, column %d: %s (got '%.*s'%s%s)",
+             line, column, message,
+             at_eof ? 3 : token->length,
+             at_eof ? "EOF" : token_start(parser->lexer, token),
+             lex_error ? ": " : "",
+             lex_error ? lex_error_message(token->error) : "");
     
     parser->error_message = strdup(full_message);
     
-    printf("ERROR: %s\n", full_message);
+    LOG_ERROR(LOG_CAT_PARSER, "ERROR: %s\n", full_message);
 }
 
 // Synchronize after error (panic mode recovery)
@@ -138,19 +186,23 @@ void parser_synchronize(Parser* parser) {
     parser->has_error = false;
     
     while (parser->current_token.type != TOKEN_EOF) {
-        if (parser->current_token.type == TOKEN_DELIMITER && 
-            parser->current_token.value && strcmp(parser->current_token.value, ";") == 0) {
+        if (parser_check_delimiter(parser, ';')) {
             parser_advance(parser);
             return;
         }
         
         if (parser->current_token.type == TOKEN_KEYWORD) {
-            const char* kw = parser->current_token.value;
-            if (kw && (strcmp(kw, "fn") == 0 || strcmp(kw, "struct") == 0 || 
-                      strcmp(kw, "enum") == 0 || strcmp(kw, "if") == 0 ||
-                      strcmp(kw, "for") == 0 || strcmp(kw, "while") == 0 ||
-                      strcmp(kw, "return") == 0)) {
-                return;
+            switch (parser->current_token.keyword) {
+                case KW_FN:
+                case KW_STRUCT:
+                case KW_ENUM:
+                case KW_IF:
+                case KW_FOR:
+                case KW_WHILE:
+                case KW_RETURN:
+                    return;
+                default:
+                    break;
             }
         }
         
@@ -171,51 +223,41 @@ const char* parser_get_error(Parser* parser) {
 // Helper functions
 bool is_type_keyword(const char* keyword) {
     if (!keyword) return false;
-    
-    for (int i = 0; type_keywords[i]; i++) {
-        if (strcmp(keyword, type_keywords[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+    return is_type_keyword_id(keyword_lookup(keyword, strlen(keyword)));
 }
 
-bool is_binary_operator(const char* op) {
-    if (!op) return false;
-    
-    for (int i = 0; binary_operators[i].op; i++) {
-        if (strcmp(op, binary_operators[i].op) == 0) {
-            return true;
-        }
-    }
-    return false;
+// Builtin type keywords plus 'auto'
+bool is_type_keyword_id(KeywordId keyword) {
+    return keyword_is_type(keyword) || keyword == KW_AUTO;
 }
 
-bool is_unary_operator(const char* op) {
-    if (!op) return false;
-    
-    for (int i = 0; unary_operators[i]; i++) {
-        if (strcmp(op, unary_operators[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+bool is_binary_operator(OperatorId op) {
+    return get_operator_precedence(op) > 0;
 }
 
-int get_operator_precedence(const char* op) {
-    if (!op) return 0;
-    
-    for (int i = 0; binary_operators[i].op; i++) {
-        if (strcmp(op, binary_operators[i].op) == 0) {
-            return binary_operators[i].precedence;
-        }
-    }
-    return 0;
+bool is_unary_operator(OperatorId op) {
+    return op > OP_NONE && op < OP_COUNT && unary_operators[op];
+}
+
+int get_operator_precedence(OperatorId op) {
+    if (op <= OP_NONE || op >= OP_COUNT) return 0;
+    return binary_precedence[op];
 }
 
 // Main parsing function
 ASTNode* parser_parse(Parser* parser) {
     if (!parser) return NULL;
     
-    return parse_program(parser);
+    // Lexing a large input alongside parsing it takes a thread of its own
+    if (parser->jobs > 1 && parser->lexer->length >= TOKEN_BUFFER_THREAD_MIN) {
+        token_buffer_start_thread(parser->tokens);
+    }
+    ASTNode* program = parse_program(parser);
+    
+    // The lexer thread writes the line index, which positions are read from
+    token_buffer_join(parser->tokens);
+    if (parser->tokens->failed) {
+        parser_error(parser, "Out of memory while lexing");
+    }
+    return program;
 } 
\ No newline at end of file
@@ -2,17 +2,21 @@
 #define PARSER_H
 
 #include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
 #include "../ast/ast.h"
 #include <stdbool.h>
 
-// Parser structure
+// Parser structure. Tokens come pre-lexed from a token buffer.
 typedef struct {
     Lexer* lexer;
+    TokenBuffer* tokens;
     Token current_token;
-    Token peek_token;
     bool has_error;
     int error_count;
     char* error_message;
+    char* text_buffer;        // scratch space for parser_token_text
+    size_t text_capacity;
+    int jobs;                 // Threads (-j): above 1, large inputs are lexed on a second one
 } Parser;
 
 // Parser creation and destruction
@@ -38,12 +42,7 @@ ASTNode* parse_while_statement(Parser* parser);
 
 // Expression parsing (precedence climbing)
 ASTNode* parse_assignment(Parser* parser);
-ASTNode* parse_logical_or(Parser* parser);
-ASTNode* parse_logical_and(Parser* parser);
-ASTNode* parse_equality(Parser* parser);
-ASTNode* parse_comparison(Parser* parser);
-ASTNode* parse_term(Parser* parser);
-ASTNode* parse_factor(Parser* parser);
+ASTNode* parse_binary(Parser* parser, int min_precedence);
 ASTNode* parse_unary(Parser* parser);
 ASTNode* parse_postfix(Parser* parser);
 ASTNode* parse_primary(Parser* parser);
@@ -51,12 +50,16 @@ ASTNode* parse_call(Parser* parser, ASTNode* callee);
 
 // Utility functions
 Token parser_current_token(Parser* parser);
-Token parser_peek_token(Parser* parser);
+Token parser_peek_token(Parser* parser, int distance);   // 1: the next token
 void parser_advance(Parser* parser);
 bool parser_match(Parser* parser, TokenType type);
 bool parser_check(Parser* parser, TokenType type);
 bool parser_expect(Parser* parser, TokenType type, const char* message);
-bool parser_expect_keyword(Parser* parser, const char* keyword);
+bool parser_check_keyword(Parser* parser, KeywordId keyword);
+bool parser_check_operator(Parser* parser, OperatorId op);
+bool parser_check_delimiter(Parser* parser, char delimiter);
+const char* parser_token_text(Parser* parser);
+bool parser_expect_keyword(Parser* parser, KeywordId keyword);
 
 // Error handling
 void parser_error(Parser* parser, const char* message);
@@ -66,8 +69,9 @@ const char* parser_get_error(Parser* parser);
 
 // Helper functions
 bool is_type_keyword(const char* keyword);
-bool is_binary_operator(const char* op);
-bool is_unary_operator(const char* op);
-int get_operator_precedence(const char* op);
+bool is_type_keyword_id(KeywordId keyword);
+bool is_binary_operator(OperatorId op);
+bool is_unary_operator(OperatorId op);
+int get_operator_precedence(OperatorId op);
 
 #endif // PARSER_H 
\ No newline at end of file
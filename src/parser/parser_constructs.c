@@ -1,5 +1,6 @@
 #define _GNU_SOURCE
 #include "parser.h"
+#include "../utils/log.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -11,8 +12,8 @@ ASTNode* parse_program(Parser* parser) {
     
     // Skip preprocessor directives at the beginning
     while (parser_check(parser, TOKEN_PREPROCESSOR)) {
-        ASTNode* preprocessor = ast_create_node(AST_PREPROCESSOR, parser->current_token.value);
-        ast_set_position(preprocessor, parser->current_token.line, parser->current_token.column);
+        ASTNode* preprocessor = ast_create_node(AST_PREPROCESSOR, parser_token_text(parser));
+        ast_set_location(preprocessor, token_location(&parser->current_token));
         ast_add_child(program, preprocessor);
         parser_advance(parser);
     }
@@ -20,19 +21,19 @@ ASTNode* parse_program(Parser* parser) {
     // Parse top-level declarations
     while (!parser_check(parser, TOKEN_EOF)) {
         if (parser->error_count > 10) {
-            printf("Too many errors, stopping parse\n");
+            LOG_ERROR(LOG_CAT_PARSER, "Too many errors, stopping parse\n");
             break;
         }
         
         ASTNode* decl = NULL;
         
         if (parser_check(parser, TOKEN_KEYWORD)) {
-            const char* kw = parser->current_token.value;
-            if (kw && strcmp(kw, "fn") == 0) {
+            KeywordId kw = parser->current_token.keyword;
+            if (kw == KW_FN) {
                 decl = parse_function(parser);
-            } else if (kw && strcmp(kw, "struct") == 0) {
+            } else if (kw == KW_STRUCT) {
                 decl = parse_struct(parser);
-            } else if (kw && strcmp(kw, "enum") == 0) {
+            } else if (kw == KW_ENUM) {
                 // TODO: implement enum parsing
                 parser_error(parser, "Enum parsing not implemented yet");
                 parser_synchronize(parser);
@@ -43,8 +44,8 @@ ASTNode* parse_program(Parser* parser) {
                 continue;
             }
         } else if (parser_check(parser, TOKEN_PREPROCESSOR)) {
-            decl = ast_create_node(AST_PREPROCESSOR, parser->current_token.value);
-            ast_set_position(decl, parser->current_token.line, parser->current_token.column);
+            decl = ast_create_node(AST_PREPROCESSOR, parser_token_text(parser));
+            ast_set_location(decl, token_location(&parser->current_token));
             parser_advance(parser);
         } else {
             parser_error(parser, "Expected declaration");
@@ -66,7 +67,7 @@ ASTNode* parse_program(Parser* parser) {
 
 // Parse function declaration
 ASTNode* parse_function(Parser* parser) {
-    if (!parser_expect_keyword(parser, "fn")) {
+    if (!parser_expect_keyword(parser, KW_FN)) {
         return NULL;
     }
     
@@ -76,8 +77,8 @@ ASTNode* parse_function(Parser* parser) {
         return NULL;
     }
     
-    ASTNode* function = ast_create_node(AST_FUNCTION, parser->current_token.value);
-    ast_set_position(function, parser->current_token.line, parser->current_token.column);
+    ASTNode* function = ast_create_node(AST_FUNCTION, parser_token_text(parser));
+    ast_set_location(function, token_location(&parser->current_token));
     parser_advance(parser);
     
     // Parameters
@@ -90,8 +91,7 @@ ASTNode* parse_function(Parser* parser) {
     bool has_auto_params = false;  // Track if function has generic parameters
     
     // Parse parameter list
-    if (!parser_check(parser, TOKEN_DELIMITER) || 
-        strcmp(parser->current_token.value, ")") != 0) {
+    if (!parser_check_delimiter(parser, ')')) {
         
         do {
             // Parse type
@@ -116,16 +116,15 @@ ASTNode* parse_function(Parser* parser) {
                 return NULL;
             }
             
-            ASTNode* param = ast_create_node(AST_PARAMETER, parser->current_token.value);
-            ast_set_position(param, parser->current_token.line, parser->current_token.column);
+            ASTNode* param = ast_create_node(AST_PARAMETER, parser_token_text(parser));
+            ast_set_location(param, token_location(&parser->current_token));
             ast_add_child(param, param_type);
             ast_add_child(params, param);
             
             parser_advance(parser);
             
             // Check for comma before consuming it
-            if (parser_check(parser, TOKEN_DELIMITER) && 
-                parser->current_token.value && strcmp(parser->current_token.value, ",") == 0) {
+            if (parser_check_delimiter(parser, ',')) {
                 parser_advance(parser); // consume comma
                 continue;
             } else {
@@ -144,8 +143,7 @@ ASTNode* parse_function(Parser* parser) {
     
     // Return type
     ASTNode* return_type = NULL;
-    if (parser_check(parser, TOKEN_OPERATOR) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "->") == 0) {
+    if (parser_check_operator(parser, OP_ARROW)) {
         parser_advance(parser);
         
         return_type = parse_type(parser);
@@ -174,7 +172,7 @@ ASTNode* parse_function(Parser* parser) {
     if (has_auto_params) {
         function->type = AST_GENERIC_FUNCTION;
         ast_mark_as_generic(function);
-        printf("✓ Parsed generic function: %s\n", function->value);
+        LOG_DEBUG(LOG_CAT_PARSER, "✓ Parsed generic function: %s\n", function->value);
     }
     
     return function;
@@ -182,7 +180,7 @@ ASTNode* parse_function(Parser* parser) {
 
 // Parse struct declaration
 ASTNode* parse_struct(Parser* parser) {
-    if (!parser_expect_keyword(parser, "struct")) {
+    if (!parser_expect_keyword(parser, KW_STRUCT)) {
         return NULL;
     }
     
@@ -192,8 +190,8 @@ ASTNode* parse_struct(Parser* parser) {
         return NULL;
     }
     
-    ASTNode* struct_node = ast_create_node(AST_STRUCT, parser->current_token.value);
-    ast_set_position(struct_node, parser->current_token.line, parser->current_token.column);
+    ASTNode* struct_node = ast_create_node(AST_STRUCT, parser_token_text(parser));
+    ast_set_location(struct_node, token_location(&parser->current_token));
     parser_advance(parser);
     
     // Opening brace
@@ -203,8 +201,7 @@ ASTNode* parse_struct(Parser* parser) {
     }
     
     // Parse field declarations
-    while (!parser_check(parser, TOKEN_DELIMITER) || 
-           strcmp(parser->current_token.value, "}") != 0) {
+    while (!parser_check_delimiter(parser, '}')) {
         
         if (parser_check(parser, TOKEN_EOF)) {
             parser_error(parser, "Unexpected end of file in struct");
@@ -227,8 +224,8 @@ ASTNode* parse_struct(Parser* parser) {
             return NULL;
         }
         
-        ASTNode* field = ast_create_node(AST_VARIABLE_DECL, parser->current_token.value);
-        ast_set_position(field, parser->current_token.line, parser->current_token.column);
+        ASTNode* field = ast_create_node(AST_VARIABLE_DECL, parser_token_text(parser));
+        ast_set_location(field, token_location(&parser->current_token));
         ast_add_child(field, field_type);
         ast_add_child(struct_node, field);
         
@@ -256,21 +253,20 @@ ASTNode* parse_type(Parser* parser) {
     ASTNode* type_node = NULL;
     
     // Handle 'auto' keyword specifically
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "auto") == 0) {
+    if (parser_check_keyword(parser, KW_AUTO)) {
         type_node = ast_create_auto_type();
-        ast_set_position(type_node, parser->current_token.line, parser->current_token.column);
+        ast_set_location(type_node, token_location(&parser->current_token));
         parser_advance(parser);
         return type_node;
     }
     
     // Check for built-in type keywords
-    if (parser_check(parser, TOKEN_KEYWORD) && is_type_keyword(parser->current_token.value)) {
-        type_name = parser->current_token.value;
+    if (parser_check(parser, TOKEN_KEYWORD) && keyword_is_type(parser->current_token.keyword)) {
+        type_name = parser_token_text(parser);
     }
     // Check for user-defined types (identifiers like struct names)
     else if (parser_check(parser, TOKEN_IDENTIFIER)) {
-        type_name = parser->current_token.value;
+        type_name = parser_token_text(parser);
     }
     else {
         parser_error(parser, "Expected type");
@@ -278,20 +274,18 @@ ASTNode* parse_type(Parser* parser) {
     }
     
     type_node = ast_create_node(AST_TYPE, type_name);
-    ast_set_position(type_node, parser->current_token.line, parser->current_token.column);
+    ast_set_location(type_node, token_location(&parser->current_token));
     parser_advance(parser);
     
     // Check for pointer
-    if (parser_check(parser, TOKEN_OPERATOR) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "*") == 0) {
-        type_node->is_pointer = true;
+    if (parser_check_operator(parser, OP_STAR)) {
+        ast_set_flag(type_node, AST_FLAG_POINTER, true);
         parser_advance(parser);
     }
     
     // Check for optional
-    if (parser_check(parser, TOKEN_OPERATOR) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "?") == 0) {
-        type_node->is_optional = true;
+    if (parser_check_operator(parser, OP_QUESTION)) {
+        ast_set_flag(type_node, AST_FLAG_OPTIONAL, true);
         parser_advance(parser);
     }
     
@@ -305,10 +299,9 @@ ASTNode* parse_block(Parser* parser) {
     }
     
     ASTNode* block = ast_create_node(AST_BLOCK, NULL);
-    ast_set_position(block, parser->current_token.line, parser->current_token.column);
+    ast_set_location(block, token_location(&parser->current_token));
     
-    while (!parser_check(parser, TOKEN_DELIMITER) || 
-           strcmp(parser->current_token.value, "}") != 0) {
+    while (!parser_check_delimiter(parser, '}')) {
         
         if (parser_check(parser, TOKEN_EOF)) {
             parser_error(parser, "Unexpected end of file in block");
@@ -337,17 +330,17 @@ ASTNode* parse_block(Parser* parser) {
 // Parse statement
 ASTNode* parse_statement(Parser* parser) {
     if (parser_check(parser, TOKEN_KEYWORD)) {
-        const char* kw = parser->current_token.value;
+        KeywordId kw = parser->current_token.keyword;
         
-        if (kw && strcmp(kw, "return") == 0) {
+        if (kw == KW_RETURN) {
             return parse_return_statement(parser);
-        } else if (kw && strcmp(kw, "if") == 0) {
+        } else if (kw == KW_IF) {
             return parse_if_statement(parser);
-        } else if (kw && strcmp(kw, "for") == 0) {
+        } else if (kw == KW_FOR) {
             return parse_for_statement(parser);
-        } else if (kw && strcmp(kw, "while") == 0) {
+        } else if (kw == KW_WHILE) {
             return parse_while_statement(parser);
-        } else if (is_type_keyword(kw)) {
+        } else if (is_type_keyword_id(kw)) {
             return parse_variable_declaration(parser);
         }
     }
@@ -355,13 +348,12 @@ ASTNode* parse_statement(Parser* parser) {
     // Check for user-defined type variable declarations (e.g., "Point p = ...")
     // Simple pattern check: IDENTIFIER IDENTIFIER (= | ;)
     if (parser_check(parser, TOKEN_IDENTIFIER) && 
-        parser->peek_token.type == TOKEN_IDENTIFIER) {
+        parser_peek_token(parser, 1).type == TOKEN_IDENTIFIER) {
         // This looks like a variable declaration with user-defined type
         return parse_variable_declaration(parser);
     }
     
-    if (parser_check(parser, TOKEN_DELIMITER) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "{") == 0) {
+    if (parser_check_delimiter(parser, '{')) {
         return parse_block(parser);
     }
     
@@ -382,16 +374,15 @@ ASTNode* parse_statement(Parser* parser) {
 
 // Parse return statement
 ASTNode* parse_return_statement(Parser* parser) {
-    if (!parser_expect_keyword(parser, "return")) {
+    if (!parser_expect_keyword(parser, KW_RETURN)) {
         return NULL;
     }
     
     ASTNode* return_stmt = ast_create_node(AST_RETURN, NULL);
-    ast_set_position(return_stmt, parser->current_token.line, parser->current_token.column);
+    ast_set_location(return_stmt, token_location(&parser->current_token));
     
     // Optional return value
-    if (!parser_check(parser, TOKEN_DELIMITER) || 
-        strcmp(parser->current_token.value, ";") != 0) {
+    if (!parser_check_delimiter(parser, ';')) {
         ASTNode* expr = parse_expression(parser);
         if (expr) {
             ast_add_child(return_stmt, expr);
@@ -417,15 +408,14 @@ ASTNode* parse_variable_declaration(Parser* parser) {
         return NULL;
     }
     
-    ASTNode* var_decl = ast_create_node(AST_VARIABLE_DECL, parser->current_token.value);
-    ast_set_position(var_decl, parser->current_token.line, parser->current_token.column);
+    ASTNode* var_decl = ast_create_node(AST_VARIABLE_DECL, parser_token_text(parser));
+    ast_set_location(var_decl, token_location(&parser->current_token));
     ast_add_child(var_decl, type_node);
     
     parser_advance(parser);
     
     // Optional initialization
-    if (parser_check(parser, TOKEN_OPERATOR) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "=") == 0) {
+    if (parser_check_operator(parser, OP_ASSIGN)) {
         parser_advance(parser);
         
         ASTNode* init_expr = parse_expression(parser);
@@ -444,12 +434,12 @@ ASTNode* parse_variable_declaration(Parser* parser) {
 
 // Parse if statement
 ASTNode* parse_if_statement(Parser* parser) {
-    if (!parser_expect_keyword(parser, "if")) {
+    if (!parser_expect_keyword(parser, KW_IF)) {
         return NULL;
     }
     
     ASTNode* if_stmt = ast_create_node(AST_IF, NULL);
-    ast_set_position(if_stmt, parser->current_token.line, parser->current_token.column);
+    ast_set_location(if_stmt, token_location(&parser->current_token));
     
     // Parse condition in parentheses
     if (!parser_expect(parser, TOKEN_DELIMITER, "Expected '(' after 'if'")) {
@@ -478,8 +468,7 @@ ASTNode* parse_if_statement(Parser* parser) {
     ast_add_child(if_stmt, then_block);
     
     // Optional else
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "else") == 0) {
+    if (parser_check_keyword(parser, KW_ELSE)) {
         parser_advance(parser);
         
         ASTNode* else_block = parse_statement(parser);
@@ -492,12 +481,12 @@ ASTNode* parse_if_statement(Parser* parser) {
 }
 
 ASTNode* parse_for_statement(Parser* parser) {
-    if (!parser_expect_keyword(parser, "for")) {
+    if (!parser_expect_keyword(parser, KW_FOR)) {
         return NULL;
     }
     
     ASTNode* for_stmt = ast_create_node(AST_FOR, NULL);
-    ast_set_position(for_stmt, parser->current_token.line, parser->current_token.column);
+    ast_set_location(for_stmt, token_location(&parser->current_token));
     
     // Parse (init; condition; increment)
     if (!parser_expect(parser, TOKEN_DELIMITER, "Expected '(' after 'for'")) {
@@ -507,10 +496,9 @@ ASTNode* parse_for_statement(Parser* parser) {
     
     // Init statement (can be variable declaration or expression)
     ASTNode* init = NULL;
-    if (!parser_check(parser, TOKEN_DELIMITER) || 
-        strcmp(parser->current_token.value, ";") != 0) {
+    if (!parser_check_delimiter(parser, ';')) {
         
-        if (parser_check(parser, TOKEN_KEYWORD) && is_type_keyword(parser->current_token.value)) {
+        if (parser_check(parser, TOKEN_KEYWORD) && is_type_keyword_id(parser->current_token.keyword)) {
             init = parse_variable_declaration(parser);
         } else {
             init = parse_expression(parser);
@@ -528,8 +516,7 @@ ASTNode* parse_for_statement(Parser* parser) {
     
     // Condition
     ASTNode* condition = NULL;
-    if (!parser_check(parser, TOKEN_DELIMITER) || 
-        strcmp(parser->current_token.value, ";") != 0) {
+    if (!parser_check_delimiter(parser, ';')) {
         condition = parse_expression(parser);
     }
     if (condition) ast_add_child(for_stmt, condition);
@@ -541,8 +528,7 @@ ASTNode* parse_for_statement(Parser* parser) {
     
     // Increment
     ASTNode* increment = NULL;
-    if (!parser_check(parser, TOKEN_DELIMITER) || 
-        strcmp(parser->current_token.value, ")") != 0) {
+    if (!parser_check_delimiter(parser, ')')) {
         increment = parse_expression(parser);
     }
     if (increment) ast_add_child(for_stmt, increment);
@@ -564,12 +550,12 @@ ASTNode* parse_for_statement(Parser* parser) {
 }
 
 ASTNode* parse_while_statement(Parser* parser) {
-    if (!parser_expect_keyword(parser, "while")) {
+    if (!parser_expect_keyword(parser, KW_WHILE)) {
         return NULL;
     }
     
     ASTNode* while_stmt = ast_create_node(AST_WHILE, NULL);
-    ast_set_position(while_stmt, parser->current_token.line, parser->current_token.column);
+    ast_set_location(while_stmt, token_location(&parser->current_token));
     
     // Parse condition in parentheses
     if (!parser_expect(parser, TOKEN_DELIMITER, "Expected '(' after 'while'")) {
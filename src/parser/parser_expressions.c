@@ -9,191 +9,47 @@ ASTNode* parse_expression(Parser* parser) {
     return parse_assignment(parser);
 }
 
-// Parse assignment (lowest precedence)
+// Parse assignment (lowest precedence, right-associative)
 ASTNode* parse_assignment(Parser* parser) {
-    ASTNode* expr = parse_logical_or(parser);
+    ASTNode* expr = parse_binary(parser, 1);
     if (!expr) return NULL;
     
-    if (parser_check(parser, TOKEN_OPERATOR) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "=") == 0) {
-        
-        char* op = strdup(parser->current_token.value);
+    if (parser_check_operator(parser, OP_ASSIGN)) {
         parser_advance(parser);
         
         ASTNode* right = parse_assignment(parser);
         if (!right) {
-            free(op);
-            ast_destroy(expr);
-            return NULL;
-        }
-        
-        ASTNode* assignment = ast_create_node(AST_ASSIGNMENT, op);
-        ast_add_child(assignment, expr);
-        ast_add_child(assignment, right);
-        free(op);
-        
-        return assignment;
-    }
-    
-    return expr;
-}
-
-// Parse logical OR
-ASTNode* parse_logical_or(Parser* parser) {
-    ASTNode* expr = parse_logical_and(parser);
-    if (!expr) return NULL;
-    
-    while (parser_check(parser, TOKEN_OPERATOR) && 
-           parser->current_token.value && strcmp(parser->current_token.value, "||") == 0) {
-        
-        char* op = strdup(parser->current_token.value);
-        parser_advance(parser);
-        
-        ASTNode* right = parse_logical_and(parser);
-        if (!right) {
-            free(op);
-            ast_destroy(expr);
-            return NULL;
-        }
-        
-        expr = ast_create_binary_op(op, expr, right);
-        free(op);
-    }
-    
-    return expr;
-}
-
-// Parse logical AND
-ASTNode* parse_logical_and(Parser* parser) {
-    ASTNode* expr = parse_equality(parser);
-    if (!expr) return NULL;
-    
-    while (parser_check(parser, TOKEN_OPERATOR) && 
-           parser->current_token.value && strcmp(parser->current_token.value, "&&") == 0) {
-        
-        char* op = strdup(parser->current_token.value);
-        parser_advance(parser);
-        
-        ASTNode* right = parse_equality(parser);
-        if (!right) {
-            free(op);
-            ast_destroy(expr);
-            return NULL;
-        }
-        
-        expr = ast_create_binary_op(op, expr, right);
-        free(op);
-    }
-    
-    return expr;
-}
-
-// Parse equality (== !=)
-ASTNode* parse_equality(Parser* parser) {
-    ASTNode* expr = parse_comparison(parser);
-    if (!expr) return NULL;
-    
-    while (parser_check(parser, TOKEN_OPERATOR) && 
-           parser->current_token.value && 
-           (strcmp(parser->current_token.value, "==") == 0 || 
-            strcmp(parser->current_token.value, "!=") == 0)) {
-        
-        char* op = strdup(parser->current_token.value);
-        parser_advance(parser);
-        
-        ASTNode* right = parse_comparison(parser);
-        if (!right) {
-            free(op);
-            ast_destroy(expr);
-            return NULL;
-        }
-        
-        expr = ast_create_binary_op(op, expr, right);
-        free(op);
-    }
-    
-    return expr;
-}
-
-// Parse comparison (< > <= >=)
-ASTNode* parse_comparison(Parser* parser) {
-    ASTNode* expr = parse_term(parser);
-    if (!expr) return NULL;
-    
-    while (parser_check(parser, TOKEN_OPERATOR) && 
-           parser->current_token.value && 
-           (strcmp(parser->current_token.value, "<") == 0 || 
-            strcmp(parser->current_token.value, ">") == 0 ||
-            strcmp(parser->current_token.value, "<=") == 0 || 
-            strcmp(parser->current_token.value, ">=") == 0)) {
-        
-        char* op = strdup(parser->current_token.value);
-        parser_advance(parser);
-        
-        ASTNode* right = parse_term(parser);
-        if (!right) {
-            free(op);
-            ast_destroy(expr);
-            return NULL;
-        }
-        
-        expr = ast_create_binary_op(op, expr, right);
-        free(op);
-    }
-    
-    return expr;
-}
-
-// Parse term (+ -)
-ASTNode* parse_term(Parser* parser) {
-    ASTNode* expr = parse_factor(parser);
-    if (!expr) return NULL;
-    
-    while (parser_check(parser, TOKEN_OPERATOR) && 
-           parser->current_token.value && 
-           (strcmp(parser->current_token.value, "+") == 0 || 
-            strcmp(parser->current_token.value, "-") == 0)) {
-        
-        char* op = strdup(parser->current_token.value);
-        parser_advance(parser);
-        
-        ASTNode* right = parse_factor(parser);
-        if (!right) {
-            free(op);
             ast_destroy(expr);
             return NULL;
         }
         
-        expr = ast_create_binary_op(op, expr, right);
-        free(op);
+        return ast_create_assignment(OP_ASSIGN, expr, right);
     }
     
     return expr;
 }
 
-// Parse factor (* / %)
-ASTNode* parse_factor(Parser* parser) {
+// Parse binary operators binding at least as tightly as min_precedence.
+// One loop for every level: an operand only recurses when an operator
+// follows it, and precedence comes from a table indexed by OperatorId.
+ASTNode* parse_binary(Parser* parser, int min_precedence) {
     ASTNode* expr = parse_unary(parser);
     if (!expr) return NULL;
     
-    while (parser_check(parser, TOKEN_OPERATOR) && 
-           parser->current_token.value && 
-           (strcmp(parser->current_token.value, "*") == 0 || 
-            strcmp(parser->current_token.value, "/") == 0 ||
-            strcmp(parser->current_token.value, "%") == 0)) {
-        
-        char* op = strdup(parser->current_token.value);
+    while (true) {
+        OperatorId op = parser->current_token.op;
+        int precedence = get_operator_precedence(op);
+        if (precedence == 0 || precedence < min_precedence) break;
         parser_advance(parser);
         
-        ASTNode* right = parse_unary(parser);
+        // All binary operators are left-associative
+        ASTNode* right = parse_binary(parser, precedence + 1);
         if (!right) {
-            free(op);
             ast_destroy(expr);
             return NULL;
         }
         
         expr = ast_create_binary_op(op, expr, right);
-        free(op);
     }
     
     return expr;
@@ -201,29 +57,21 @@ ASTNode* parse_factor(Parser* parser) {
 
 // Parse unary (! - + * & ++ --)
 ASTNode* parse_unary(Parser* parser) {
-    if (parser_check(parser, TOKEN_OPERATOR) && 
-        parser->current_token.value && is_unary_operator(parser->current_token.value)) {
-        
-        char* op = strdup(parser->current_token.value);
+    if (is_unary_operator(parser->current_token.op)) {
+        OperatorId op = parser->current_token.op;
         parser_advance(parser);
         
         ASTNode* operand = parse_unary(parser);
-        if (!operand) {
-            free(op);
-            return NULL;
-        }
+        if (!operand) return NULL;
         
-        ASTNode* unary = ast_create_unary_op(op, operand);
-        free(op);
-        return unary;
+        return ast_create_unary_op(op, operand);
     }
     
     // Handle alloc keyword
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "alloc") == 0) {
+    if (parser_check_keyword(parser, KW_ALLOC)) {
         
         ASTNode* alloc_node = ast_create_node(AST_ALLOC, "alloc");
-        ast_set_position(alloc_node, parser->current_token.line, parser->current_token.column);
+        ast_set_location(alloc_node, token_location(&parser->current_token));
         parser_advance(parser);
         
         // Parse type
@@ -235,8 +83,7 @@ ASTNode* parse_unary(Parser* parser) {
         ast_add_child(alloc_node, type_node);
         
         // Optional initialization
-        if (parser_check(parser, TOKEN_DELIMITER) && 
-            parser->current_token.value && strcmp(parser->current_token.value, "(") == 0) {
+        if (parser_check_delimiter(parser, '(')) {
             parser_advance(parser);
             
             ASTNode* init_expr = parse_expression(parser);
@@ -254,11 +101,10 @@ ASTNode* parse_unary(Parser* parser) {
     }
     
     // Handle delete keyword
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "delete") == 0) {
+    if (parser_check_keyword(parser, KW_DELETE)) {
         
         ASTNode* delete_node = ast_create_node(AST_DELETE, "delete");
-        ast_set_position(delete_node, parser->current_token.line, parser->current_token.column);
+        ast_set_location(delete_node, token_location(&parser->current_token));
         parser_advance(parser);
         
         ASTNode* operand = parse_unary(parser);
@@ -281,8 +127,7 @@ ASTNode* parse_postfix(Parser* parser) {
     
     while (true) {
         // Scope resolution ::
-        if (parser_check(parser, TOKEN_OPERATOR) && 
-            parser->current_token.value && strcmp(parser->current_token.value, "::") == 0) {
+        if (parser_check_operator(parser, OP_SCOPE)) {
             parser_advance(parser);
             
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
@@ -291,8 +136,8 @@ ASTNode* parse_postfix(Parser* parser) {
                 return NULL;
             }
             
-            ASTNode* right = ast_create_identifier(parser->current_token.value);
-            ast_set_position(right, parser->current_token.line, parser->current_token.column);
+            ASTNode* right = ast_create_identifier(parser_token_text(parser));
+            ast_set_location(right, token_location(&parser->current_token));
             parser_advance(parser);
             
             ASTNode* scope_res = ast_create_node(AST_SCOPE_RESOLUTION, "::");
@@ -301,23 +146,20 @@ ASTNode* parse_postfix(Parser* parser) {
             expr = scope_res;
         }
         // Function calls (expr(...))
-        else if (parser_check(parser, TOKEN_DELIMITER) && 
-            parser->current_token.value && strcmp(parser->current_token.value, "(") == 0) {
+        else if (parser_check_delimiter(parser, '(')) {
             expr = parse_call(parser, expr);
             if (!expr) return NULL;
         }
         // Named struct literals (TypeName {field: value})
         else if (expr->type == AST_IDENTIFIER && 
-                 parser_check(parser, TOKEN_DELIMITER) && 
-                 parser->current_token.value && strcmp(parser->current_token.value, "{") == 0) {
+                 parser_check_delimiter(parser, '{')) {
             parser_advance(parser); // consume '{'
             
             ASTNode* struct_literal = ast_create_node(AST_STRUCT_LITERAL, expr->value);
-            ast_set_position(struct_literal, parser->current_token.line, parser->current_token.column);
+            ast_set_location(struct_literal, token_location(&parser->current_token));
             
             // Parse field initializers
-            if (!parser_check(parser, TOKEN_DELIMITER) || 
-                strcmp(parser->current_token.value, "}") != 0) {
+            if (!parser_check_delimiter(parser, '}')) {
                 
                 do {
                     // Parse field name
@@ -328,13 +170,12 @@ ASTNode* parse_postfix(Parser* parser) {
                         return NULL;
                     }
                     
-                    ASTNode* field_name = ast_create_identifier(parser->current_token.value);
-                    ast_set_position(field_name, parser->current_token.line, parser->current_token.column);
+                    ASTNode* field_name = ast_create_identifier(parser_token_text(parser));
+                    ast_set_location(field_name, token_location(&parser->current_token));
                     parser_advance(parser);
                     
                     // Expect colon
-                    if (!parser_check(parser, TOKEN_OPERATOR) || 
-                        !parser->current_token.value || strcmp(parser->current_token.value, ":") != 0) {
+                    if (!parser_check_operator(parser, OP_COLON)) {
                         parser_error(parser, "Expected ':' after field name in struct literal");
                         ast_destroy(field_name);
                         ast_destroy(struct_literal);
@@ -353,14 +194,10 @@ ASTNode* parse_postfix(Parser* parser) {
                     }
                     
                     // Create field initializer node
-                    ASTNode* field_init = ast_create_node(AST_ASSIGNMENT, ":");
-                    ast_add_child(field_init, field_name);
-                    ast_add_child(field_init, field_value);
-                    ast_add_child(struct_literal, field_init);
+                    ast_add_child(struct_literal, ast_create_assignment(OP_COLON, field_name, field_value));
                     
                     // Check for comma
-                    if (parser_check(parser, TOKEN_DELIMITER) && 
-                        parser->current_token.value && strcmp(parser->current_token.value, ",") == 0) {
+                    if (parser_check_delimiter(parser, ',')) {
                         parser_advance(parser);
                         continue;
                     } else {
@@ -380,8 +217,7 @@ ASTNode* parse_postfix(Parser* parser) {
             expr = struct_literal;
         }
         // Member access with dot (obj.field)
-        else if (parser_check(parser, TOKEN_OPERATOR) && 
-                 parser->current_token.value && strcmp(parser->current_token.value, ".") == 0) {
+        else if (parser_check_operator(parser, OP_DOT)) {
             parser_advance(parser);
             
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
@@ -390,8 +226,8 @@ ASTNode* parse_postfix(Parser* parser) {
                 return NULL;
             }
             
-            ASTNode* field = ast_create_identifier(parser->current_token.value);
-            ast_set_position(field, parser->current_token.line, parser->current_token.column);
+            ASTNode* field = ast_create_identifier(parser_token_text(parser));
+            ast_set_location(field, token_location(&parser->current_token));
             parser_advance(parser);
             
             ASTNode* member_access = ast_create_node(AST_MEMBER_ACCESS, ".");
@@ -400,8 +236,7 @@ ASTNode* parse_postfix(Parser* parser) {
             expr = member_access;
         }
         // Pointer member access (ptr->field)
-        else if (parser_check(parser, TOKEN_OPERATOR) && 
-                 parser->current_token.value && strcmp(parser->current_token.value, "->") == 0) {
+        else if (parser_check_operator(parser, OP_ARROW)) {
             parser_advance(parser);
             
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
@@ -410,8 +245,8 @@ ASTNode* parse_postfix(Parser* parser) {
                 return NULL;
             }
             
-            ASTNode* field = ast_create_identifier(parser->current_token.value);
-            ast_set_position(field, parser->current_token.line, parser->current_token.column);
+            ASTNode* field = ast_create_identifier(parser_token_text(parser));
+            ast_set_location(field, token_location(&parser->current_token));
             parser_advance(parser);
             
             ASTNode* member_access = ast_create_node(AST_MEMBER_ACCESS, "->");
@@ -432,65 +267,60 @@ ASTNode* parse_postfix(Parser* parser) {
 ASTNode* parse_primary(Parser* parser) {
     // Literals
     if (parser_check(parser, TOKEN_INTEGER)) {
-        ASTNode* literal = ast_create_literal(parser->current_token.value, "integer");
-        ast_set_position(literal, parser->current_token.line, parser->current_token.column);
+        ASTNode* literal = ast_create_literal(parser_token_text(parser), "integer");
+        ast_set_location(literal, token_location(&parser->current_token));
         parser_advance(parser);
         return literal;
     }
     
     if (parser_check(parser, TOKEN_FLOAT)) {
-        ASTNode* literal = ast_create_literal(parser->current_token.value, "float");
-        ast_set_position(literal, parser->current_token.line, parser->current_token.column);
+        ASTNode* literal = ast_create_literal(parser_token_text(parser), "float");
+        ast_set_location(literal, token_location(&parser->current_token));
         parser_advance(parser);
         return literal;
     }
     
     if (parser_check(parser, TOKEN_STRING)) {
-        ASTNode* literal = ast_create_literal(parser->current_token.value, "string");
-        ast_set_position(literal, parser->current_token.line, parser->current_token.column);
+        ASTNode* literal = ast_create_literal(parser_token_text(parser), "string");
+        ast_set_location(literal, token_location(&parser->current_token));
         parser_advance(parser);
         return literal;
     }
     
     if (parser_check(parser, TOKEN_CHAR)) {
-        ASTNode* literal = ast_create_literal(parser->current_token.value, "char");
-        ast_set_position(literal, parser->current_token.line, parser->current_token.column);
+        ASTNode* literal = ast_create_literal(parser_token_text(parser), "char");
+        ast_set_location(literal, token_location(&parser->current_token));
         parser_advance(parser);
         return literal;
     }
     
     // Boolean literals
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && 
-        (strcmp(parser->current_token.value, "true") == 0 || 
-         strcmp(parser->current_token.value, "false") == 0)) {
-        ASTNode* literal = ast_create_literal(parser->current_token.value, "bool");
-        ast_set_position(literal, parser->current_token.line, parser->current_token.column);
+    if (parser_check_keyword(parser, KW_TRUE) || parser_check_keyword(parser, KW_FALSE)) {
+        ASTNode* literal = ast_create_literal(parser_token_text(parser), "bool");
+        ast_set_location(literal, token_location(&parser->current_token));
         parser_advance(parser);
         return literal;
     }
     
     // Null literal
-    if (parser_check(parser, TOKEN_KEYWORD) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "null") == 0) {
-        ASTNode* literal = ast_create_literal(parser->current_token.value, "null");
-        ast_set_position(literal, parser->current_token.line, parser->current_token.column);
+    if (parser_check_keyword(parser, KW_NULL)) {
+        ASTNode* literal = ast_create_literal(parser_token_text(parser), "null");
+        ast_set_location(literal, token_location(&parser->current_token));
         parser_advance(parser);
         return literal;
     }
     
     // Identifiers
     if (parser_check(parser, TOKEN_IDENTIFIER)) {
-        ASTNode* identifier = ast_create_identifier(parser->current_token.value);
-        ast_set_position(identifier, parser->current_token.line, parser->current_token.column);
+        ASTNode* identifier = ast_create_identifier(parser_token_text(parser));
+        ast_set_location(identifier, token_location(&parser->current_token));
         parser_advance(parser);
         
         return identifier;
     }
     
     // Parenthesized expressions
-    if (parser_check(parser, TOKEN_DELIMITER) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "(") == 0) {
+    if (parser_check_delimiter(parser, '(')) {
         parser_advance(parser);
         
         ASTNode* expr = parse_expression(parser);
@@ -505,16 +335,14 @@ ASTNode* parse_primary(Parser* parser) {
     }
     
     // Struct literals: {field: value, field2: value2}
-    if (parser_check(parser, TOKEN_DELIMITER) && 
-        parser->current_token.value && strcmp(parser->current_token.value, "{") == 0) {
+    if (parser_check_delimiter(parser, '{')) {
         parser_advance(parser);
         
         ASTNode* struct_literal = ast_create_node(AST_STRUCT_LITERAL, NULL);
-        ast_set_position(struct_literal, parser->current_token.line, parser->current_token.column);
+        ast_set_location(struct_literal, token_location(&parser->current_token));
         
         // Parse field initializers
-        if (!parser_check(parser, TOKEN_DELIMITER) || 
-            strcmp(parser->current_token.value, "}") != 0) {
+        if (!parser_check_delimiter(parser, '}')) {
             
             do {
                 // Parse field name
@@ -524,13 +352,12 @@ ASTNode* parse_primary(Parser* parser) {
                     return NULL;
                 }
                 
-                ASTNode* field_name = ast_create_identifier(parser->current_token.value);
-                ast_set_position(field_name, parser->current_token.line, parser->current_token.column);
+                ASTNode* field_name = ast_create_identifier(parser_token_text(parser));
+                ast_set_location(field_name, token_location(&parser->current_token));
                 parser_advance(parser);
                 
                 // Expect colon
-                if (!parser_check(parser, TOKEN_OPERATOR) || 
-                    !parser->current_token.value || strcmp(parser->current_token.value, ":") != 0) {
+                if (!parser_check_operator(parser, OP_COLON)) {
                     parser_error(parser, "Expected ':' after field name in struct literal");
                     ast_destroy(field_name);
                     ast_destroy(struct_literal);
@@ -547,14 +374,10 @@ ASTNode* parse_primary(Parser* parser) {
                 }
                 
                 // Create field initializer node
-                ASTNode* field_init = ast_create_node(AST_ASSIGNMENT, ":");
-                ast_add_child(field_init, field_name);
-                ast_add_child(field_init, field_value);
-                ast_add_child(struct_literal, field_init);
+                ast_add_child(struct_literal, ast_create_assignment(OP_COLON, field_name, field_value));
                 
                 // Check for comma
-                if (parser_check(parser, TOKEN_DELIMITER) && 
-                    parser->current_token.value && strcmp(parser->current_token.value, ",") == 0) {
+                if (parser_check_delimiter(parser, ',')) {
                     parser_advance(parser);
                     continue;
                 } else {
@@ -588,8 +411,7 @@ ASTNode* parse_call(Parser* parser, ASTNode* callee) {
     }
     
     // Parse arguments
-    if (!parser_check(parser, TOKEN_DELIMITER) || 
-        strcmp(parser->current_token.value, ")") != 0) {
+    if (!parser_check_delimiter(parser, ')')) {
         
         do {
             ASTNode* arg = parse_expression(parser);
@@ -599,8 +421,7 @@ ASTNode* parse_call(Parser* parser, ASTNode* callee) {
             }
             ast_add_child(call, arg);
             
-            if (parser_check(parser, TOKEN_DELIMITER) && 
-                parser->current_token.value && strcmp(parser->current_token.value, ",") == 0) {
+            if (parser_check_delimiter(parser, ',')) {
                 parser_advance(parser);
                 continue;
             } else {
@@ -1,5 +1,10 @@
 #define _GNU_SOURCE
 #include "import_system.h"
+#include "struct_layout.h"
+#include "../utils/string_intern.h"
+#include "../utils/log.h"
+#include <ctype.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -70,64 +75,471 @@ const FunctionDefinition BUILTIN_FUNCTIONS[] = {
 
 const int BUILTIN_FUNCTION_COUNT = sizeof(BUILTIN_FUNCTIONS) / sizeof(FunctionDefinition);
 
-// Find function by qualified name
-const FunctionDefinition* find_function(const char* qualified_name) {
-    if (!qualified_name) return NULL;
+// ================== FUNCTION REGISTRY ==================
+// Registered functions are indexed by interned qualified name, and every
+// module path (including parent paths such as "core" for "core::io::print")
+// maps to the list of functions below it in registration order.
+
+typedef struct ImportModule {
+    const FunctionDefinition** functions;
+    int function_count;
+    int function_capacity;
+} ImportModule;
+
+// Declarations exported by a user module
+typedef struct UserModule {
+    ASTNode* program;
+    FunctionDefinition* functions;     // Registered with the function index
+    int function_count;
+} UserModule;
+
+// Open-addressing map keyed by interned string
+typedef struct {
+    const char* key;           // NULL marks an empty slot
+    void* value;
+} RegistrySlot;
+
+typedef struct {
+    RegistrySlot* slots;
+    size_t capacity;           // Power of two
+    size_t count;
+} RegistryMap;
+
+#define REGISTRY_INITIAL_CAPACITY 64
+
+static RegistryMap registry_functions;     // qualified name -> FunctionDefinition
+static RegistryMap registry_modules;       // module path -> ImportModule
+static RegistryMap registry_user_modules;  // module path -> UserModule
+static bool registry_initialized = false;  // Set (release) once the index is built
+
+// Native tables added with import_register_functions, in registration
+// order; they are indexed again whenever the index is rebuilt
+typedef struct {
+    const FunctionDefinition* functions;
+    int count;
+} NativeTable;
+
+static NativeTable* registry_native;
+static int registry_native_count = 0;
+static int registry_native_capacity = 0;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;  // First-use initialization
+
+static RegistrySlot* registry_find_slot(const RegistryMap* map, const char* key) {
+    size_t mask = map->capacity - 1;
+    size_t index = intern_hash(key) & mask;
+    
+    while (map->slots[index].key && map->slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return &map->slots[index];
+}
+
+// Look up an interned key (NULL if absent)
+static void* registry_get(const RegistryMap* map, const char* key) {
+    if (!key || map->count == 0) return NULL;
+    return registry_find_slot(map, key)->value;
+}
+
+// Insert or replace; grows at 3/4 load
+static bool registry_put(RegistryMap* map, const char* key, void* value) {
+    if ((map->count + 1) * 4 > map->capacity * 3) {
+        size_t new_capacity = map->capacity ? map->capacity * 2 : REGISTRY_INITIAL_CAPACITY;
+        RegistrySlot* new_slots = calloc(new_capacity, sizeof(RegistrySlot));
+        if (!new_slots) return false;
+        
+        RegistryMap grown = { new_slots, new_capacity, map->count };
+        for (size_t i = 0; i < map->capacity; i++) {
+            if (map->slots[i].key) {
+                *registry_find_slot(&grown, map->slots[i].key) = map->slots[i];
+            }
+        }
+        
+        free(map->slots);
+        *map = grown;
+    }
     
-    for (int i = 0; i < BUILTIN_FUNCTION_COUNT; i++) {
-        if (strcmp(BUILTIN_FUNCTIONS[i].qualified_name, qualified_name) == 0) {
-            return &BUILTIN_FUNCTIONS[i];
+    RegistrySlot* slot = registry_find_slot(map, key);
+    if (!slot->key) {
+        slot->key = key;
+        map->count++;
+    }
+    slot->value = value;
+    return true;
+}
+
+// Append function to the list of a module, creating the module on first use
+static bool registry_add_to_module(const char* module_path, size_t length,
+                                   const FunctionDefinition* function) {
+    const char* key = intern_string_n(module_path, length);
+    if (!key) return false;
+    
+    ImportModule* module = registry_get(&registry_modules, key);
+    if (!module) {
+        module = calloc(1, sizeof(ImportModule));
+        if (!module) return false;
+        
+        if (!registry_put(&registry_modules, key, module)) {
+            free(module);
+            return false;
         }
     }
     
-    return NULL;
+    if (module->function_count >= module->function_capacity) {
+        int new_capacity = module->function_capacity ? module->function_capacity * 2 : 8;
+        const FunctionDefinition** new_functions = realloc(module->functions,
+                                                           new_capacity * sizeof(FunctionDefinition*));
+        if (!new_functions) return false;
+        
+        module->functions = new_functions;
+        module->function_capacity = new_capacity;
+    }
+    
+    module->functions[module->function_count++] = function;
+    return true;
 }
 
-// Smart module detection - no more hardcoded BUILTIN_MODULES!
-// Modules are auto-generated from BUILTIN_FUNCTIONS
+// Point every module list entry for old_function at new_function
+static void registry_replace_in_modules(const char* qualified_name,
+                                        const FunctionDefinition* old_function,
+                                        const FunctionDefinition* new_function) {
+    for (const char* sep = strstr(qualified_name, "::"); sep; sep = strstr(sep + 2, "::")) {
+        const char* key = intern_string_n(qualified_name, sep - qualified_name);
+        ImportModule* module = registry_get(&registry_modules, key);
+        if (!module) continue;
+        
+        for (int i = 0; i < module->function_count; i++) {
+            if (module->functions[i] == old_function) {
+                module->functions[i] = new_function;
+            }
+        }
+    }
+}
 
-// Check if module is builtin by looking at functions
-bool import_is_builtin_module(const char* module_path) {
+static bool registry_add_function(const FunctionDefinition* function) {
+    if (!function->qualified_name) return false;
+    
+    const char* name = intern_string(function->qualified_name);
+    if (!name) return false;
+    
+    // A later registration of the same name takes precedence
+    const FunctionDefinition* existing = registry_get(&registry_functions, name);
+    if (existing) {
+        registry_replace_in_modules(name, existing, function);
+        return registry_put(&registry_functions, name, (void*)function);
+    }
+    
+    if (!registry_put(&registry_functions, name, (void*)function)) return false;
+    
+    // Register under every enclosing module path
+    for (const char* sep = strstr(name, "::"); sep; sep = strstr(sep + 2, "::")) {
+        if (!registry_add_to_module(name, sep - name, function)) return false;
+    }
+    return true;
+}
+
+static bool registry_add_functions(const FunctionDefinition* functions, int count) {
+    bool success = true;
+    for (int i = 0; i < count; i++) {
+        if (!registry_add_function(&functions[i])) {
+            success = false;
+        }
+    }
+    return success;
+}
+
+// Build the index from BUILTIN_FUNCTIONS and the native tables on first use
+// (which may happen on several threads at once). Once it is built, callers
+// see the flag set and take no lock.
+static void registry_ensure_initialized(void) {
+    if (__atomic_load_n(&registry_initialized, __ATOMIC_ACQUIRE)) return;
+    
+    pthread_mutex_lock(&registry_lock);
+    if (!registry_initialized) {
+        registry_add_functions(BUILTIN_FUNCTIONS, BUILTIN_FUNCTION_COUNT);
+        for (int i = 0; i < registry_native_count; i++) {
+            registry_add_functions(registry_native[i].functions, registry_native[i].count);
+        }
+        __atomic_store_n(&registry_initialized, true, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&registry_lock);
+}
+
+// Register additional functions; the table must outlive the registry
+bool import_register_functions(const FunctionDefinition* functions, int count) {
+    if (!functions || count < 0) return false;
+    
+    registry_ensure_initialized();
+    
+    if (registry_native_count >= registry_native_capacity) {
+        int new_capacity = registry_native_capacity ? registry_native_capacity * 2 : 4;
+        NativeTable* new_native = realloc(registry_native, new_capacity * sizeof(NativeTable));
+        if (!new_native) return false;
+        
+        registry_native = new_native;
+        registry_native_capacity = new_capacity;
+    }
+    registry_native[registry_native_count].functions = functions;
+    registry_native[registry_native_count].count = count;
+    registry_native_count++;
+    
+    return registry_add_functions(functions, count);
+}
+
+// Free the index and the user modules; the next lookup rebuilds the index
+static void registry_release(void) {
+    for (size_t i = 0; i < registry_modules.capacity; i++) {
+        ImportModule* module = registry_modules.slots[i].value;
+        if (module) {
+            free(module->functions);
+            free(module);
+        }
+    }
+    
+    for (size_t i = 0; i < registry_user_modules.capacity; i++) {
+        UserModule* module = registry_user_modules.slots[i].value;
+        if (module) {
+            for (int j = 0; j < module->function_count; j++) {
+                free((void*)module->functions[j].param_types);
+            }
+            free(module->functions);
+            free(module);
+        }
+    }
+    
+    free(registry_modules.slots);
+    free(registry_functions.slots);
+    free(registry_user_modules.slots);
+    memset(&registry_modules, 0, sizeof(registry_modules));
+    memset(&registry_functions, 0, sizeof(registry_functions));
+    memset(&registry_user_modules, 0, sizeof(registry_user_modules));
+    registry_initialized = false;
+}
+
+// Release the index and forget the native tables; the next lookup rebuilds
+// it from BUILTIN_FUNCTIONS
+void import_registry_clear(void) {
+    registry_release();
+    free(registry_native);
+    registry_native = NULL;
+    registry_native_count = 0;
+    registry_native_capacity = 0;
+}
+
+// Drop the user modules; the next lookup rebuilds the index from
+// BUILTIN_FUNCTIONS and the native tables
+void import_registry_clear_user_modules(void) {
+    registry_release();
+}
+
+// ================== USER MODULES ==================
+
+// C name of a user module's function
+const char* import_module_c_name(const char* module_path, const char* name) {
+    if (!module_path || !name) return NULL;
+    
+    char c_name[256];
+    size_t length = 0;
+    for (const char* c = module_path; *c && length < sizeof(c_name) - 1; c++) {
+        if (c[0] == ':' && c[1] == ':') c++;
+        c_name[length++] = *c == ':' ? '_' : *c;
+    }
+    snprintf(c_name + length, sizeof(c_name) - length, "_%s", name);
+    return intern_string(c_name);
+}
+
+// Signature of an exported function in FunctionDefinition form
+static bool user_module_describe_function(const char* module_path, ASTNode* function,
+                                          FunctionDefinition* definition) {
+    char qualified_name[256];
+    snprintf(qualified_name, sizeof(qualified_name), "%s::%s", module_path, function->value);
+    definition->qualified_name = intern_string(qualified_name);
+    definition->c_function = import_module_c_name(module_path, function->value);
+    definition->return_type = "void";
+    
+    ASTNode* params = NULL;
+    for (int i = 0; i < function->child_count; i++) {
+        ASTNode* child = function->children[i];
+        if (child->type == AST_TYPE && child->value) {
+            definition->return_type = child->value;
+        } else if (child->type == AST_PARAMETER && !params) {
+            params = child;
+        }
+    }
+    
+    int count = params ? params->child_count : 0;
+    const char** param_types = calloc(count + 1, sizeof(const char*));
+    if (!definition->qualified_name || !definition->c_function || !param_types) {
+        free(param_types);
+        return false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        ASTNode* param = params->children[i];
+        param_types[i] = param->child_count > 0 && param->children[0]->value ?
+                         param->children[0]->value : "i32";
+    }
+    
+    definition->param_types = param_types;
+    definition->param_count = count;
+    return true;
+}
+
+// Export the functions and structs of a parsed user module
+bool import_register_module(const char* module_path, ASTNode* program) {
+    if (!module_path || !program || program->type != AST_PROGRAM) return false;
+    
+    registry_ensure_initialized();
+    
+    const char* key = intern_string(module_path);
+    if (!key || registry_get(&registry_user_modules, key)) return false;
+    
+    int count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        if (child->type == AST_FUNCTION && child->value && strcmp(child->value, "main") != 0) {
+            count++;
+        }
+    }
+    
+    UserModule* module = calloc(1, sizeof(UserModule));
+    if (!module) return false;
+    
+    module->program = program;
+    module->functions = calloc(count > 0 ? count : 1, sizeof(FunctionDefinition));
+    if (!module->functions || !registry_put(&registry_user_modules, key, module)) {
+        free(module->functions);
+        free(module);
+        return false;
+    }
+    
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        if (child->type != AST_FUNCTION || !child->value || strcmp(child->value, "main") == 0) continue;
+        
+        if (!user_module_describe_function(key, child, &module->functions[module->function_count])) {
+            return false;
+        }
+        module->function_count++;
+    }
+    
+    LOG_DEBUG(LOG_CAT_SEMANTIC, "Registered module %s (%d functions)\n", key, module->function_count);
+    return registry_add_functions(module->functions, module->function_count);
+}
+
+// Check if module_path names a registered user module
+bool import_is_user_module(const char* module_path) {
     if (!module_path) return false;
+    return registry_get(&registry_user_modules, intern_lookup(module_path)) != NULL;
+}
+
+// Add the structs of a user module to the importing symbol table
+static void import_add_module_structs(ImportContext* context, const char* module_path) {
+    UserModule* module = registry_get(&registry_user_modules, intern_lookup(module_path));
+    if (!module) return;
+    
+    for (int i = 0; i < module->program->child_count; i++) {
+        ASTNode* child = module->program->children[i];
+        if (child->type != AST_STRUCT || !child->value) continue;
+        
+        Symbol* symbol = symbol_create(child->value, SYMBOL_STRUCT, child, NULL);
+        if (!symbol) continue;
+        
+        symbol->layout = struct_layout_create(child, context->symbol_table);
+        if (symbol_table_add_symbol(context->symbol_table, symbol)) {
+            LOG_DEBUG(LOG_CAT_SEMANTIC, "    + struct %s\n", child->value);
+        } else {
+            symbol_destroy(symbol);
+        }
+    }
+}
+
+// Source file of a user module in the search path
+char* import_resolve_module(const char* module_path, const char* const* search_paths, int count) {
+    if (!module_path || !*module_path) return NULL;
+    
+    // Only identifiers separated by "::", so a path cannot leave the search directory
+    size_t length = strlen(module_path);
+    char* relative = malloc(length + 4);
+    if (!relative) return NULL;
+    
+    size_t out = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = module_path[i];
+        if (c == ':' && module_path[i + 1] == ':' && i > 0 && module_path[i + 2] && module_path[i + 2] != ':') {
+            relative[out++] = '/';
+            i++;
+        } else if (isalnum((unsigned char)c) || c == '_') {
+            relative[out++] = c;
+        } else {
+            free(relative);
+            return NULL;
+        }
+    }
+    strcpy(relative + out, ".ec");
     
-    // Check if any builtin function starts with this module path
-    for (int i = 0; i < BUILTIN_FUNCTION_COUNT; i++) {
-        if (strncmp(BUILTIN_FUNCTIONS[i].qualified_name, module_path, strlen(module_path)) == 0 &&
-            BUILTIN_FUNCTIONS[i].qualified_name[strlen(module_path)] == ':' &&
-            BUILTIN_FUNCTIONS[i].qualified_name[strlen(module_path)+1] == ':') {
-            return true;
+    for (int i = 0; i < count; i++) {
+        size_t dir_length = strlen(search_paths[i]);
+        char* path = malloc(dir_length + out + 5);
+        if (!path) break;
+        
+        sprintf(path, "%s/%s", search_paths[i], relative);
+        FILE* file = fopen(path, "r");
+        if (file) {
+            fclose(file);
+            free(relative);
+            return path;
         }
+        free(path);
     }
     
-    return false;
+    free(relative);
+    return NULL;
 }
 
-// Check if function exists in module by looking at BUILTIN_FUNCTIONS
+// Find function by qualified name
+const FunctionDefinition* import_find_function(const char* qualified_name) {
+    if (!qualified_name) return NULL;
+    
+    registry_ensure_initialized();
+    
+    // A name that was never interned cannot be registered
+    return registry_get(&registry_functions, intern_lookup(qualified_name));
+}
+
+// Functions registered under module_path (NULL if the module is unknown)
+const FunctionDefinition** import_module_functions(const char* module_path, int* count) {
+    if (count) *count = 0;
+    if (!module_path) return NULL;
+    
+    registry_ensure_initialized();
+    
+    ImportModule* module = registry_get(&registry_modules, intern_lookup(module_path));
+    if (!module) return NULL;
+    
+    if (count) *count = module->function_count;
+    return module->functions;
+}
+
+// Check if module is builtin (some registered function lives under it)
+bool import_is_builtin_module(const char* module_path) {
+    return import_module_functions(module_path, NULL) != NULL;
+}
+
+// Check if function exists in module
 bool import_function_exists_in_module(const char* module_path, const char* function_name) {
     if (!module_path || !function_name) return false;
     
     char full_name[256];
     snprintf(full_name, sizeof(full_name), "%s::%s", module_path, function_name);
     
-    return find_function(full_name) != NULL;
+    return import_find_function(full_name) != NULL;
 }
 
 // Helper function to create type node
 ASTNode* create_type_node(const char* type_name) {
     if (!type_name) return NULL;
     
-    ASTNode* type_node = malloc(sizeof(ASTNode));
-    if (!type_node) return NULL;
-    
-    type_node->type = AST_TYPE;
-    type_node->value = strdup(type_name);
-    type_node->child_count = 0;
-    type_node->children = NULL;
-    type_node->line = 0;
-    type_node->column = 0;
-    type_node->data_type = NULL;
-    
-    return type_node;
+    return ast_create_node(AST_TYPE, type_name);
 }
 
 // Create import context
@@ -174,12 +586,12 @@ bool import_process_include(ImportContext* context, ASTNode* preprocessor) {
     // Extract include line
     const char* include_line = preprocessor->value + 9; // Skip "#include "
     
-    printf("Processing include: %s\n", include_line);
+    LOG_DEBUG(LOG_CAT_SEMANTIC, "Processing include: %s\n", include_line);
     
     // Parse import statement
     Import* import = import_parse_statement(include_line);
     if (!import) {
-        printf("Failed to parse import: %s\n", include_line);
+        LOG_ERROR(LOG_CAT_SEMANTIC, "Failed to parse import: %s\n", include_line);
         return false;
     }
     
@@ -190,7 +602,7 @@ bool import_process_include(ImportContext* context, ASTNode* preprocessor) {
     // Add symbols to symbol table
     bool success = import_add_symbols(context, import);
     
-    printf("Import processed: %s (type: %d, success: %s)\n", 
+    LOG_DEBUG(LOG_CAT_SEMANTIC, "Import processed: %s (type: %d, success: %s)\n", 
            import->module_path, import->type, success ? "yes" : "no");
     
     return success;
@@ -270,7 +682,7 @@ bool import_add_symbols(ImportContext* context, Import* import) {
     switch (import->type) {
         case IMPORT_MODULE: {
             // Import all functions from module with module:: prefix
-            printf("  Adding module: %s\n", import->module_path);
+            LOG_DEBUG(LOG_CAT_SEMANTIC, "  Adding module: %s\n", import->module_path);
             
             // Extract short module name (e.g., "io" from "core::io")
             const char* short_name = strrchr(import->module_path, ':');
@@ -280,43 +692,41 @@ bool import_add_symbols(ImportContext* context, Import* import) {
                 short_name = import->module_path; // Use full name if no ::
             }
             
-            for (int i = 0; i < BUILTIN_FUNCTION_COUNT; i++) {
-                const FunctionDefinition* func = &BUILTIN_FUNCTIONS[i];
+            int function_count = 0;
+            const FunctionDefinition** functions = import_module_functions(import->module_path, &function_count);
+            
+            for (int i = 0; i < function_count; i++) {
+                const FunctionDefinition* func = functions[i];
+                
+                // Add with full qualified name (core::io::print)
+                ASTNode* return_type = create_type_node(func->return_type);
+                Symbol* symbol = symbol_create(func->qualified_name, SYMBOL_FUNCTION, NULL, return_type);
+                symbol->is_builtin = true;
+                symbol->c_function_name = strdup(func->c_function); // Store C function name
+                
+                if (symbol_table_add_symbol(context->symbol_table, symbol)) {
+                    LOG_DEBUG(LOG_CAT_SEMANTIC, "    + %s -> %s\n", func->qualified_name, func->c_function);
+                } else {
+                    symbol_destroy(symbol);
+                }
+                
+                // Also add with short module name (io::print)
+                const char* function_part = func->qualified_name + strlen(import->module_path) + 2;
+                char short_name_func[256];
+                snprintf(short_name_func, sizeof(short_name_func), "%s::%s", short_name, function_part);
+                
+                ASTNode* return_type2 = create_type_node(func->return_type);
+                Symbol* symbol2 = symbol_create(short_name_func, SYMBOL_FUNCTION, NULL, return_type2);
+                symbol2->is_builtin = true;
+                symbol2->c_function_name = strdup(func->c_function); // Store C function name
                 
-                // Check if function belongs to this module
-                if (strncmp(func->qualified_name, import->module_path, strlen(import->module_path)) == 0 &&
-                    func->qualified_name[strlen(import->module_path)] == ':' &&
-                    func->qualified_name[strlen(import->module_path)+1] == ':') {
-                    
-                    // Add with full qualified name (core::io::print)
-                    ASTNode* return_type = create_type_node(func->return_type);
-                    Symbol* symbol = symbol_create(func->qualified_name, SYMBOL_FUNCTION, NULL, return_type);
-                    symbol->is_builtin = true;
-                    symbol->c_function_name = strdup(func->c_function); // Store C function name
-                    
-                    if (symbol_table_add_symbol(context->symbol_table, symbol)) {
-                        printf("    + %s -> %s\n", func->qualified_name, func->c_function);
-                    } else {
-                        symbol_destroy(symbol);
-                    }
-                    
-                    // Also add with short module name (io::print)
-                    const char* function_part = func->qualified_name + strlen(import->module_path) + 2;
-                    char short_name_func[256];
-                    snprintf(short_name_func, sizeof(short_name_func), "%s::%s", short_name, function_part);
-                    
-                    ASTNode* return_type2 = create_type_node(func->return_type);
-                    Symbol* symbol2 = symbol_create(short_name_func, SYMBOL_FUNCTION, NULL, return_type2);
-                    symbol2->is_builtin = true;
-                    symbol2->c_function_name = strdup(func->c_function); // Store C function name
-                    
-                    if (symbol_table_add_symbol(context->symbol_table, symbol2)) {
-                        printf("    + %s -> %s\n", short_name_func, func->c_function);
-                    } else {
-                        symbol_destroy(symbol2);
-                    }
+                if (symbol_table_add_symbol(context->symbol_table, symbol2)) {
+                    LOG_DEBUG(LOG_CAT_SEMANTIC, "    + %s -> %s\n", short_name_func, func->c_function);
+                } else {
+                    symbol_destroy(symbol2);
                 }
             }
+            import_add_module_structs(context, import->module_path);
             return true;
         }
         
@@ -326,9 +736,9 @@ bool import_add_symbols(ImportContext* context, Import* import) {
             snprintf(qualified_name, sizeof(qualified_name), "%s::%s", 
                     import->module_path, import->function_name);
             
-            printf("  Adding function: %s as %s\n", qualified_name, import->function_name);
+            LOG_DEBUG(LOG_CAT_SEMANTIC, "  Adding function: %s as %s\n", qualified_name, import->function_name);
             
-            const FunctionDefinition* func = find_function(qualified_name);
+            const FunctionDefinition* func = import_find_function(qualified_name);
             if (func) {
                 ASTNode* return_type = create_type_node(func->return_type);
                 Symbol* symbol = symbol_create(import->function_name, SYMBOL_FUNCTION, NULL, return_type);
@@ -346,9 +756,9 @@ bool import_add_symbols(ImportContext* context, Import* import) {
             snprintf(qualified_name, sizeof(qualified_name), "%s::%s", 
                     import->module_path, import->function_name);
             
-            printf("  Adding function: %s as %s\n", qualified_name, import->alias);
+            LOG_DEBUG(LOG_CAT_SEMANTIC, "  Adding function: %s as %s\n", qualified_name, import->alias);
             
-            const FunctionDefinition* func = find_function(qualified_name);
+            const FunctionDefinition* func = import_find_function(qualified_name);
             if (func) {
                 ASTNode* return_type = create_type_node(func->return_type);
                 Symbol* symbol = symbol_create(import->alias, SYMBOL_FUNCTION, NULL, return_type);
@@ -362,33 +772,31 @@ bool import_add_symbols(ImportContext* context, Import* import) {
         
         case IMPORT_MODULE_ALIAS: {
             // Import module with alias (module functions accessible as alias::function)
-            printf("  Adding module: %s as %s\n", import->module_path, import->alias);
+            LOG_DEBUG(LOG_CAT_SEMANTIC, "  Adding module: %s as %s\n", import->module_path, import->alias);
             
-            for (int i = 0; i < BUILTIN_FUNCTION_COUNT; i++) {
-                const FunctionDefinition* func = &BUILTIN_FUNCTIONS[i];
+            int function_count = 0;
+            const FunctionDefinition** functions = import_module_functions(import->module_path, &function_count);
+            
+            for (int i = 0; i < function_count; i++) {
+                const FunctionDefinition* func = functions[i];
+                
+                // Create aliased name (alias::function instead of module::function)
+                const char* function_part = func->qualified_name + strlen(import->module_path) + 2;
+                char aliased_name[256];
+                snprintf(aliased_name, sizeof(aliased_name), "%s::%s", import->alias, function_part);
+                
+                ASTNode* return_type = create_type_node(func->return_type);
+                Symbol* symbol = symbol_create(aliased_name, SYMBOL_FUNCTION, NULL, return_type);
+                symbol->is_builtin = true;
+                symbol->c_function_name = strdup(func->c_function); // Store C function name
                 
-                // Check if function belongs to this module
-                if (strncmp(func->qualified_name, import->module_path, strlen(import->module_path)) == 0 &&
-                    func->qualified_name[strlen(import->module_path)] == ':' &&
-                    func->qualified_name[strlen(import->module_path)+1] == ':') {
-                    
-                    // Create aliased name (alias::function instead of module::function)
-                    const char* function_part = func->qualified_name + strlen(import->module_path) + 2;
-                    char aliased_name[256];
-                    snprintf(aliased_name, sizeof(aliased_name), "%s::%s", import->alias, function_part);
-                    
-                    ASTNode* return_type = create_type_node(func->return_type);
-                    Symbol* symbol = symbol_create(aliased_name, SYMBOL_FUNCTION, NULL, return_type);
-                    symbol->is_builtin = true;
-                    symbol->c_function_name = strdup(func->c_function); // Store C function name
-                    
-                    if (symbol_table_add_symbol(context->symbol_table, symbol)) {
-                        printf("    + %s -> %s\n", aliased_name, func->c_function);
-                    } else {
-                        symbol_destroy(symbol);
-                    }
+                if (symbol_table_add_symbol(context->symbol_table, symbol)) {
+                    LOG_DEBUG(LOG_CAT_SEMANTIC, "    + %s -> %s\n", aliased_name, func->c_function);
+                } else {
+                    symbol_destroy(symbol);
                 }
             }
+            import_add_module_structs(context, import->module_path);
             return true;
         }
     }
@@ -55,10 +55,38 @@ bool import_add_symbols(ImportContext* context, Import* import);
 extern const FunctionDefinition BUILTIN_FUNCTIONS[];
 extern const int BUILTIN_FUNCTION_COUNT;
 
+// Function registry: indexed by qualified name and by module path, built
+// from BUILTIN_FUNCTIONS on first use. Native modules can add their own
+// tables (which must stay alive); a later definition of the same qualified
+// name replaces the earlier one. Clearing the user modules keeps the native
+// tables; clearing the registry drops both.
+// Lookups may run on several threads at once, but not while functions or
+// modules are being registered.
+bool import_register_functions(const FunctionDefinition* functions, int count);
+void import_registry_clear(void);
+void import_registry_clear_user_modules(void);
+
+// User modules: Echo source files imported by module path. Registering a
+// parsed module exports its non-generic functions (except main) under
+// "module_path::name", and its structs to modules that import the whole
+// module. The AST must outlive the registry.
+bool import_register_module(const char* module_path, ASTNode* program);
+bool import_is_user_module(const char* module_path);
+
+// C name of a user module's function: the module path and the name joined
+// by '_' ("app::util" and "add" give app_util_add), so that modules and the
+// roots importing them can define functions of the same name (interned)
+const char* import_module_c_name(const char* module_path, const char* name);
+
+// Source file of a user module: "app::util" is "app/util.ec" in the first
+// search directory that has it (caller frees; NULL if none does)
+char* import_resolve_module(const char* module_path, const char* const* search_paths, int count);
+
 // Smart helper functions (no more hardcoded modules!)
 bool import_is_builtin_module(const char* module_path);
 bool import_function_exists_in_module(const char* module_path, const char* function_name);
 const FunctionDefinition* import_find_function(const char* qualified_name);
+const FunctionDefinition** import_module_functions(const char* module_path, int* count);
 char* import_extract_module_path(const char* include_line);
 char* import_extract_function_name(const char* include_line);
 char* import_extract_alias(const char* include_line);
@@ -0,0 +1,381 @@
+#define _GNU_SOURCE
+#include "module_interface.h"
+#include "../utils/string_builder.h"
+#include "../utils/string_intern.h"
+#include "../utils/log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INTERFACE_MAGIC "ECHOIFC\0"
+#define INTERFACE_BYTE_ORDER 0x01020304u  // Reads differently on a foreign byte order
+#define INTERFACE_NONE 0xFFFFFFFFu        // No string / no type node
+
+typedef struct InterfaceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t source_hash;
+    uint32_t struct_count;
+    uint32_t function_count;
+    uint32_t member_count;
+    uint32_t string_count;
+    uint32_t string_bytes;
+    uint32_t reserved;
+} InterfaceHeader;
+
+typedef struct InterfaceType {
+    uint32_t name;                 // String index, INTERFACE_NONE without a type node
+    uint32_t flags;                // AST_FLAG_POINTER / AST_FLAG_OPTIONAL
+} InterfaceType;
+
+typedef struct InterfaceStruct {
+    uint32_t name;
+    uint32_t member_count;         // Fields
+} InterfaceStruct;
+
+typedef struct InterfaceFunction {
+    uint32_t name;
+    uint32_t member_count;         // Parameters
+    InterfaceType return_type;     // Name INTERFACE_NONE without "-> type"
+} InterfaceFunction;
+
+typedef struct InterfaceMember {
+    uint32_t name;
+    InterfaceType type;
+} InterfaceMember;
+
+// ================== WRITING ==================
+
+// Distinct strings of an interface, keyed by interned pointer
+typedef struct InterfaceStrings {
+    const char** keys;
+    uint32_t* ids;
+    size_t capacity;               // Power of two
+    uint32_t count;
+    StringBuilder offsets;         // uint32_t per string
+    StringBuilder bytes;           // NUL-terminated strings
+} InterfaceStrings;
+
+static bool interface_strings_init(InterfaceStrings* strings, size_t bound) {
+    memset(strings, 0, sizeof(InterfaceStrings));
+    strings->capacity = 16;
+    while (strings->capacity < bound * 2) strings->capacity *= 2;
+    
+    strings->keys = calloc(strings->capacity, sizeof(const char*));
+    strings->ids = calloc(strings->capacity, sizeof(uint32_t));
+    string_builder_init(&strings->offsets);
+    string_builder_init(&strings->bytes);
+    return strings->keys && strings->ids;
+}
+
+static void interface_strings_free(InterfaceStrings* strings) {
+    free(strings->keys);
+    free(strings->ids);
+    string_builder_free(&strings->offsets);
+    string_builder_free(&strings->bytes);
+}
+
+// Index of a string, adding it on first use (INTERFACE_NONE for NULL)
+static uint32_t interface_string(InterfaceStrings* strings, const char* text, bool* ok) {
+    const char* key = intern_string(text);
+    if (!key) return INTERFACE_NONE;
+    
+    size_t mask = strings->capacity - 1;
+    size_t slot = (size_t)(((uintptr_t)key >> 3) * 0x9E3779B97F4A7C15ULL) & mask;
+    while (strings->keys[slot] && strings->keys[slot] != key) {
+        slot = (slot + 1) & mask;
+    }
+    if (strings->keys[slot]) return strings->ids[slot];
+    
+    uint32_t offset = (uint32_t)strings->bytes.length;
+    if (!string_builder_append_n(&strings->offsets, (const char*)&offset, sizeof(offset)) ||
+        !string_builder_append_n(&strings->bytes, key, strlen(key) + 1)) {
+        *ok = false;
+        return INTERFACE_NONE;
+    }
+    
+    strings->keys[slot] = key;
+    strings->ids[slot] = strings->count;
+    return strings->count++;
+}
+
+// Type of a declared type node (or of a missing one)
+static InterfaceType interface_type(InterfaceStrings* strings, ASTNode* type_node, bool* ok) {
+    InterfaceType type = { INTERFACE_NONE, 0 };
+    if (type_node && type_node->value) {
+        type.name = interface_string(strings, type_node->value, ok);
+        type.flags = type_node->flags & (AST_FLAG_POINTER | AST_FLAG_OPTIONAL);
+    }
+    return type;
+}
+
+static bool interface_append(StringBuilder* section, const void* record, size_t size) {
+    return string_builder_append_n(section, record, size);
+}
+
+// Exported functions: non-generic, except main (as in import_register_module)
+static bool interface_exports_function(ASTNode* node) {
+    return node->type == AST_FUNCTION && node->value && strcmp(node->value, "main") != 0;
+}
+
+// Write the interface of a parsed module
+bool module_interface_write(const char* path, ASTNode* program, uint64_t source_hash) {
+    if (!path || !program || program->type != AST_PROGRAM) return false;
+    
+    // Every name and type may be distinct
+    size_t bound = 1;
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        for (int j = 0; j < child->child_count; j++) {
+            bound += 2 + (size_t)child->children[j]->child_count * 2;
+        }
+        bound += 2;
+    }
+    
+    InterfaceStrings strings;
+    StringBuilder structs, functions, fields, params;
+    string_builder_init(&structs);
+    string_builder_init(&functions);
+    string_builder_init(&fields);
+    string_builder_init(&params);
+    bool ok = interface_strings_init(&strings, bound);
+    
+    InterfaceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INTERFACE_MAGIC, sizeof(header.magic));
+    header.version = MODULE_INTERFACE_VERSION;
+    header.byte_order = INTERFACE_BYTE_ORDER;
+    header.source_hash = source_hash;
+    
+    for (int i = 0; ok && i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        
+        if (child->type == AST_STRUCT && child->value) {
+            InterfaceStruct record = { interface_string(&strings, child->value, &ok), 0 };
+            for (int j = 0; j < child->child_count; j++) {
+                ASTNode* field = child->children[j];
+                if (field->type != AST_VARIABLE_DECL || !field->value) continue;
+                
+                InterfaceMember member = { interface_string(&strings, field->value, &ok),
+                                           interface_type(&strings, field->child_count > 0 ?
+                                                          field->children[0] : NULL, &ok) };
+                ok = interface_append(&fields, &member, sizeof(member)) && ok;
+                record.member_count++;
+            }
+            ok = interface_append(&structs, &record, sizeof(record)) && ok;
+            header.struct_count++;
+        } else if (interface_exports_function(child)) {
+            InterfaceFunction record = { interface_string(&strings, child->value, &ok), 0,
+                                         { INTERFACE_NONE, 0 } };
+            for (int j = 0; j < child->child_count; j++) {
+                ASTNode* part = child->children[j];
+                if (part->type == AST_TYPE && part->value) {
+                    record.return_type = interface_type(&strings, part, &ok);
+                } else if (part->type == AST_PARAMETER && !part->value && record.member_count == 0) {
+                    for (int k = 0; k < part->child_count; k++) {
+                        ASTNode* param = part->children[k];
+                        InterfaceMember member = { interface_string(&strings, param->value, &ok),
+                                                   interface_type(&strings, param->child_count > 0 ?
+                                                                  param->children[0] : NULL, &ok) };
+                        ok = interface_append(&params, &member, sizeof(member)) && ok;
+                        record.member_count++;
+                    }
+                }
+            }
+            ok = interface_append(&functions, &record, sizeof(record)) && ok;
+            header.function_count++;
+        }
+    }
+    
+    header.member_count = (uint32_t)((fields.length + params.length) / sizeof(InterfaceMember));
+    header.string_count = strings.count;
+    header.string_bytes = (uint32_t)strings.bytes.length;
+    
+    // Written next to the final name, then moved over it
+    size_t path_length = strlen(path);
+    char* temporary = malloc(path_length + 5);
+    FILE* file = NULL;
+    if (ok && temporary) {
+        memcpy(temporary, path, path_length);
+        strcpy(temporary + path_length, ".tmp");
+        file = fopen(temporary, "wb");
+    }
+    
+    if (file) {
+        StringBuilder* sections[] = { &structs, &functions, &fields, &params,
+                                      &strings.offsets, &strings.bytes };
+        ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        for (size_t i = 0; ok && i < sizeof(sections) / sizeof(sections[0]); i++) {
+            ok = sections[i]->length == 0 ||
+                 fwrite(sections[i]->data, 1, sections[i]->length, file) == sections[i]->length;
+        }
+        ok = fclose(file) == 0 && ok;
+        ok = ok && rename(temporary, path) == 0;
+        if (!ok) remove(temporary);
+    } else {
+        ok = false;
+    }
+    
+    free(temporary);
+    interface_strings_free(&strings);
+    string_builder_free(&structs);
+    string_builder_free(&functions);
+    string_builder_free(&fields);
+    string_builder_free(&params);
+    return ok;
+}
+
+// ================== READING ==================
+
+// Sections of a mapped interface file
+typedef struct InterfaceView {
+    const InterfaceHeader* header;
+    const InterfaceStruct* structs;
+    const InterfaceFunction* functions;
+    const InterfaceMember* members;
+    const uint32_t* string_offsets;
+    const char* strings;
+} InterfaceView;
+
+// Locate the sections; false unless the file is exactly as long as they are
+static bool interface_view(const char* data, size_t size, InterfaceView* view) {
+    if (size < sizeof(InterfaceHeader)) return false;
+    
+    const InterfaceHeader* header = (const InterfaceHeader*)data;
+    if (memcmp(header->magic, INTERFACE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != MODULE_INTERFACE_VERSION || header->byte_order != INTERFACE_BYTE_ORDER) {
+        return false;
+    }
+    
+    // 64-bit sums cannot overflow with 32-bit counts
+    uint64_t expected = sizeof(InterfaceHeader) +
+                        (uint64_t)header->struct_count * sizeof(InterfaceStruct) +
+                        (uint64_t)header->function_count * sizeof(InterfaceFunction) +
+                        (uint64_t)header->member_count * sizeof(InterfaceMember) +
+                        (uint64_t)header->string_count * sizeof(uint32_t) +
+                        header->string_bytes;
+    if (expected != size) return false;
+    
+    const char* cursor = data + sizeof(InterfaceHeader);
+    view->header = header;
+    view->structs = (const InterfaceStruct*)cursor;
+    cursor += (size_t)header->struct_count * sizeof(InterfaceStruct);
+    view->functions = (const InterfaceFunction*)cursor;
+    cursor += (size_t)header->function_count * sizeof(InterfaceFunction);
+    view->members = (const InterfaceMember*)cursor;
+    cursor += (size_t)header->member_count * sizeof(InterfaceMember);
+    view->string_offsets = (const uint32_t*)cursor;
+    cursor += (size_t)header->string_count * sizeof(uint32_t);
+    view->strings = cursor;
+    
+    // The last string must be terminated inside the table
+    return header->string_bytes == 0 || view->strings[header->string_bytes - 1] == '\0';
+}
+
+// String by index (NULL for INTERFACE_NONE or an invalid index)
+static const char* interface_view_string(const InterfaceView* view, uint32_t index, bool* ok) {
+    if (index == INTERFACE_NONE) return NULL;
+    if (index >= view->header->string_count ||
+        view->string_offsets[index] >= view->header->string_bytes) {
+        *ok = false;
+        return NULL;
+    }
+    return view->strings + view->string_offsets[index];
+}
+
+// Type node of a member or return type (NULL without one)
+static ASTNode* interface_type_node(const InterfaceView* view, InterfaceType type, bool* ok) {
+    const char* name = interface_view_string(view, type.name, ok);
+    if (!name) return NULL;
+    
+    ASTNode* node = ast_create_node(AST_TYPE, name);
+    if (!node) {
+        *ok = false;
+        return NULL;
+    }
+    ast_set_flag(node, AST_FLAG_POINTER, (type.flags & AST_FLAG_POINTER) != 0);
+    ast_set_flag(node, AST_FLAG_OPTIONAL, (type.flags & AST_FLAG_OPTIONAL) != 0);
+    return node;
+}
+
+// Member node (field or parameter) with its type
+static ASTNode* interface_member_node(const InterfaceView* view, ASTNodeType type,
+                                      const InterfaceMember* member, bool* ok) {
+    const char* name = interface_view_string(view, member->name, ok);
+    ASTNode* node = name ? ast_create_node(type, name) : NULL;
+    if (!node) {
+        *ok = false;
+        return NULL;
+    }
+    
+    ASTNode* type_node = interface_type_node(view, member->type, ok);
+    if (type_node) ast_add_child(node, type_node);
+    return node;
+}
+
+// Declarations of an interface file as an AST_PROGRAM
+ASTNode* module_interface_read(const char* path, uint64_t source_hash) {
+    int fd = path ? open(path, O_RDONLY) : -1;
+    if (fd < 0) return NULL;
+    
+    struct stat info;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+    
+    InterfaceView view;
+    bool ok = interface_view(data, (size_t)info.st_size, &view) &&
+              view.header->source_hash == source_hash;
+    
+    ASTNode* program = ok ? ast_create_node(AST_PROGRAM, NULL) : NULL;
+    ok = ok && program;
+    
+    uint32_t member = 0;
+    for (uint32_t i = 0; ok && i < view.header->struct_count; i++) {
+        const InterfaceStruct* record = &view.structs[i];
+        const char* name = interface_view_string(&view, record->name, &ok);
+        ASTNode* node = name ? ast_create_node(AST_STRUCT, name) : NULL;
+        ok = node && record->member_count <= view.header->member_count - member;
+        
+        for (uint32_t j = 0; ok && j < record->member_count; j++) {
+            ASTNode* field = interface_member_node(&view, AST_VARIABLE_DECL, &view.members[member++], &ok);
+            if (field) ast_add_child(node, field);
+        }
+        if (ok) ast_add_child(program, node);
+    }
+    
+    for (uint32_t i = 0; ok && i < view.header->function_count; i++) {
+        const InterfaceFunction* record = &view.functions[i];
+        const char* name = interface_view_string(&view, record->name, &ok);
+        ASTNode* node = name ? ast_create_node(AST_FUNCTION, name) : NULL;
+        ASTNode* params = node ? ast_create_node(AST_PARAMETER, NULL) : NULL;
+        ok = params && record->member_count <= view.header->member_count - member;
+        
+        for (uint32_t j = 0; ok && j < record->member_count; j++) {
+            ASTNode* param = interface_member_node(&view, AST_PARAMETER, &view.members[member++], &ok);
+            if (param) ast_add_child(params, param);
+        }
+        if (!ok) break;
+        
+        // Same shape as a parsed function, without the body
+        ast_add_child(node, params);
+        ASTNode* return_type = interface_type_node(&view, record->return_type, &ok);
+        if (return_type) ast_add_child(node, return_type);
+        ast_add_child(program, node);
+    }
+    
+    munmap(data, (size_t)info.st_size);
+    if (!ok) {
+        LOG_DEBUG(LOG_CAT_SEMANTIC, "Ignoring interface file %s\n", path);
+        return NULL;
+    }
+    return program;
+}
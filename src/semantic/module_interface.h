@@ -0,0 +1,30 @@
+#ifndef MODULE_INTERFACE_H
+#define MODULE_INTERFACE_H
+
+#include "../ast/ast.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Binary interface files (.ei) of user modules.
+// An interface holds what importers see of a module: its structs (field
+// names and types) and the signatures of its exported functions, the same
+// declarations import_register_module takes from the AST. Names are indices
+// into a table of distinct strings. All records are 4-byte aligned and the
+// file is read with mmap, so loading an interface costs a few page faults
+// and one node per declaration instead of lexing and parsing the source.
+//
+// Layout: header, structs, functions, members (the fields of every struct,
+// then the parameters of every function), string offsets, string bytes.
+
+#define MODULE_INTERFACE_VERSION 1
+
+// Write the interface of a parsed module; source_hash identifies the source
+// it describes
+bool module_interface_write(const char* path, ASTNode* program, uint64_t source_hash);
+
+// Declarations of an interface file as an AST_PROGRAM of AST_STRUCT and
+// body-less AST_FUNCTION nodes. NULL if the file is missing, malformed or
+// describes another source.
+ASTNode* module_interface_read(const char* path, uint64_t source_hash);
+
+#endif // MODULE_INTERFACE_H
@@ -3,6 +3,11 @@
 #include "semantic_errors.h"
 #include "import_system.h"
 #include "type_inference.h"
+#include "types.h"
+#include "struct_layout.h"
+#include "../utils/log.h"
+#include "../utils/timing.h"
+#include "../utils/thread_pool.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -19,7 +24,7 @@ void semantic_add_builtin_modules(SemanticContext* context) {
     // Store import context in semantic context for later use
     context->import_context = import_context;
     
-    printf("✓ Import system initialized\n");
+    LOG_DEBUG(LOG_CAT_SEMANTIC, "✓ Import system initialized\n");
 }
 
 // Create semantic context
@@ -42,11 +47,15 @@ SemanticContext* semantic_create(void) {
     }
     
     context->current_function = NULL;
+    context->import_context = NULL;
     context->errors = NULL;
     context->error_count = 0;
     context->warning_count = 0;
     context->has_fatal_error = false;
     context->current_filename = NULL;
+    context->lines = NULL;
+    context->jobs = 1;
+    context->call_order = 0;
     
     return context;
 }
@@ -74,10 +83,13 @@ void semantic_destroy(SemanticContext* context) {
 
 // Add error to context
 void semantic_add_error(SemanticContext* context, SemanticErrorType type, 
-                       SemanticSeverity severity, int line, int column, 
+                       SemanticSeverity severity, uint32_t location, 
                        const char* format, ...) {
     if (!context) return;
     
+    int line, column;
+    line_index_position(context->lines, location, &line, &column);
+    
     // Format message
     char message[512];
     va_list args;
@@ -106,24 +118,27 @@ void semantic_add_error(SemanticContext* context, SemanticErrorType type,
     }
 }
 
-// Print all errors
+// Print all errors (each diagnostic is logged at its own severity)
 void semantic_print_errors(SemanticContext* context) {
     if (!context || !context->errors) return;
     
-    printf("\n=== Semantic Analysis Results ===\n");
+    LogLevel summary_level = context->error_count > 0 ? LOG_LEVEL_ERROR : LOG_LEVEL_WARN;
+    LOG(LOG_CAT_SEMANTIC, summary_level, "\n=== Semantic Analysis Results ===\n");
     
     SemanticError* error = context->errors;
     while (error) {
-        printf("%s:%d:%d: %s: %s\n",
-               context->current_filename ? context->current_filename : "<unknown>",
-               error->line, error->column,
-               semantic_severity_to_string(error->severity),
-               error->message);
+        LogLevel level = error->severity == SEMANTIC_SEVERITY_ERROR ? LOG_LEVEL_ERROR :
+                         error->severity == SEMANTIC_SEVERITY_WARNING ? LOG_LEVEL_WARN : LOG_LEVEL_INFO;
+        LOG(LOG_CAT_SEMANTIC, level, "%s:%d:%d: %s: %s\n",
+            context->current_filename ? context->current_filename : "<unknown>",
+            error->line, error->column,
+            semantic_severity_to_string(error->severity),
+            error->message);
         error = error->next;
     }
     
-    printf("\nSummary: %d errors, %d warnings\n", 
-           context->error_count, context->warning_count);
+    LOG(LOG_CAT_SEMANTIC, summary_level, "\nSummary: %d errors, %d warnings\n", 
+        context->error_count, context->warning_count);
 }
 
 // Check if context has errors
@@ -135,29 +150,166 @@ bool semantic_has_errors(SemanticContext* context) {
 bool semantic_analyze(SemanticContext* context, ASTNode* ast) {
     if (!context || !ast) return false;
     
-    printf("Starting semantic analysis...\n");
+    LOG_INFO(LOG_CAT_SEMANTIC, "Starting semantic analysis...\n");
     
     bool success = semantic_analyze_program(context, ast);
+    return semantic_report(context, success);
+}
+
+// Print the diagnostics and outcome of an analysis; returns whether it succeeded
+bool semantic_report(SemanticContext* context, bool success) {
+    if (!context) return false;
     
     if (context->error_count > 0 || context->warning_count > 0) {
         semantic_print_errors(context);
     }
     
     if (success && context->error_count == 0) {
-        printf("✓ Semantic analysis completed successfully!\n");
+        LOG_INFO(LOG_CAT_SEMANTIC, "✓ Semantic analysis completed successfully!\n");
         
         // Print type inference statistics
-        if (context->type_inference) {
+        if (context->type_inference && log_enabled(LOG_CAT_INFERENCE, LOG_LEVEL_DEBUG)) {
             type_inference_print_instantiations(context->type_inference);
         }
         
         return true;
     } else {
-        printf("✗ Semantic analysis failed with %d errors\n", context->error_count);
+        LOG_ERROR(LOG_CAT_SEMANTIC, "✗ Semantic analysis failed with %d errors\n", context->error_count);
         return false;
     }
 }
 
+// Function body analyzed by a worker thread, with the diagnostics it produced
+typedef struct SemanticBody {
+    ASTNode* function;
+    int position;                  // Index among the program's children
+    bool success;
+    SemanticError* errors;         // Newest first, like SemanticContext.errors
+    int error_count;
+    int warning_count;
+    bool has_fatal_error;
+} SemanticBody;
+
+typedef struct SemanticBodyPass {
+    SemanticBody* bodies;
+    SemanticContext* workers;      // Per-thread contexts, each with a symbol table layer
+} SemanticBodyPass;
+
+static void semantic_analyze_body_job(void* arg, int index, int worker) {
+    SemanticBodyPass* pass = arg;
+    SemanticBody* body = &pass->bodies[index];
+    SemanticContext* context = &pass->workers[worker];
+    
+    context->errors = NULL;
+    context->error_count = 0;
+    context->warning_count = 0;
+    context->has_fatal_error = false;
+    context->call_order = (uint64_t)body->position << 32;
+    
+    body->success = semantic_analyze_function(context, body->function);
+    body->errors = context->errors;
+    body->error_count = context->error_count;
+    body->warning_count = context->warning_count;
+    body->has_fatal_error = context->has_fatal_error;
+}
+
+// Analyze function bodies on context->jobs threads. Bodies only read the
+// global scope, which is complete by now; each worker declares locals in its
+// own layer over the global symbol table. Diagnostics are merged in program
+// order, so they come out as if the bodies had been analyzed one by one.
+// Returns false (without analyzing anything) if the workers cannot be set up.
+static bool semantic_analyze_bodies_parallel(SemanticContext* context, ASTNode* program,
+                                             int count, bool* success) {
+    SemanticBody* bodies = calloc(count, sizeof(SemanticBody));
+    int worker_count = context->jobs < count ? context->jobs : count;
+    SemanticContext* workers = calloc(worker_count, sizeof(SemanticContext));
+    
+    int layers = 0;
+    while (bodies && workers && layers < worker_count) {
+        SymbolTable* layer = symbol_table_create_layer(context->symbol_table);
+        if (!layer) break;
+        
+        workers[layers] = *context;
+        workers[layers].symbol_table = layer;
+        workers[layers].current_filename = NULL;
+        layers++;
+    }
+    
+    bool ready = bodies && workers && layers == worker_count;
+    if (ready) {
+        int index = 0;
+        for (int i = 0; i < program->child_count; i++) {
+            ASTNode* child = program->children[i];
+            if (child->type == AST_FUNCTION) {
+                bodies[index].function = child;
+                bodies[index].position = i;
+                index++;
+            } else if (child->type == AST_GENERIC_FUNCTION) {
+                // Only registered for inference, nothing to analyze in parallel
+                if (!semantic_analyze_function(context, child)) {
+                    *success = false;
+                }
+            }
+        }
+        
+        SemanticBodyPass pass = { bodies, workers };
+        thread_pool_run(worker_count, count, semantic_analyze_body_job, &pass);
+        
+        for (int i = 0; i < count; i++) {
+            SemanticBody* body = &bodies[i];
+            if (body->errors) {
+                SemanticError* tail = body->errors;
+                while (tail->next) tail = tail->next;
+                tail->next = context->errors;
+                context->errors = body->errors;
+            }
+            context->error_count += body->error_count;
+            context->warning_count += body->warning_count;
+            context->has_fatal_error |= body->has_fatal_error;
+            if (!body->success) {
+                *success = false;
+            }
+        }
+        
+        // Threads created instantiations in whatever order they got there
+        type_inference_order_instantiations(context->type_inference);
+    }
+    
+    for (int i = 0; i < layers; i++) {
+        symbol_table_destroy(workers[i].symbol_table);
+    }
+    free(workers);
+    free(bodies);
+    return ready;
+}
+
+// Analyze all function bodies, in parallel when context->jobs > 1
+static bool semantic_analyze_function_bodies(SemanticContext* context, ASTNode* program) {
+    bool success = true;
+    
+    int count = 0;
+    for (int i = 0; i < program->child_count; i++) {
+        if (program->children[i]->type == AST_FUNCTION) count++;
+    }
+    
+    if (context->jobs > 1 && count > 1 &&
+        semantic_analyze_bodies_parallel(context, program, count, &success)) {
+        return success;
+    }
+    
+    for (int i = 0; i < program->child_count; i++) {
+        ASTNode* child = program->children[i];
+        if (child->type == AST_FUNCTION || child->type == AST_GENERIC_FUNCTION) {
+            context->call_order = (uint64_t)i << 32;
+            if (!semantic_analyze_function(context, child)) {
+                success = false;
+            }
+        }
+    }
+    
+    return success;
+}
+
 // Analyze program (top level)
 bool semantic_analyze_program(SemanticContext* context, ASTNode* node) {
     if (!context || !node || node->type != AST_PROGRAM) return false;
@@ -165,40 +317,36 @@ bool semantic_analyze_program(SemanticContext* context, ASTNode* node) {
     bool success = true;
     
     // First pass: process #include directives
+    int phase = timing_begin("imports");
     for (int i = 0; i < node->child_count; i++) {
         ASTNode* child = node->children[i];
         if (child->type == AST_PREPROCESSOR) {
             if (context->import_context) {
                 if (!import_process_include(context->import_context, child)) {
-                    printf("Failed to process include: %s\n", child->value);
+                    LOG_ERROR(LOG_CAT_SEMANTIC, "Failed to process include: %s\n", child->value);
                     success = false;
                 }
             }
         }
     }
     
+    timing_end(phase);
+    
     // Second pass: collect and analyze struct declarations
+    phase = timing_begin("structs");
     for (int i = 0; i < node->child_count; i++) {
         ASTNode* child = node->children[i];
         if (child->type == AST_STRUCT) {
-            // Analyze struct first
             if (!semantic_analyze_struct(context, child)) {
                 success = false;
             }
-            
-            // Add struct to global scope as a type
-            Symbol* struct_symbol = symbol_create(child->value, SYMBOL_STRUCT, child, NULL);
-            if (!symbol_table_add_symbol(context->symbol_table, struct_symbol)) {
-                semantic_add_error(context, SEMANTIC_ERROR_REDEFINED_SYMBOL, 
-                                 SEMANTIC_SEVERITY_ERROR, child->line, child->column,
-                                 "Struct '%s' already defined", child->value);
-                symbol_destroy(struct_symbol);
-                success = false;
-            }
         }
     }
     
+    timing_end(phase);
+    
     // Third pass: collect function declarations
+    phase = timing_begin("declarations");
     for (int i = 0; i < node->child_count; i++) {
         ASTNode* child = node->children[i];
         if (child->type == AST_FUNCTION || child->type == AST_GENERIC_FUNCTION) {
@@ -206,7 +354,7 @@ bool semantic_analyze_program(SemanticContext* context, ASTNode* node) {
             Symbol* func_symbol = symbol_create(child->value, SYMBOL_FUNCTION, child, NULL);
             if (!symbol_table_add_symbol(context->symbol_table, func_symbol)) {
                 semantic_add_error(context, SEMANTIC_ERROR_REDEFINED_SYMBOL, 
-                                 SEMANTIC_SEVERITY_ERROR, child->line, child->column,
+                                 SEMANTIC_SEVERITY_ERROR, child->location,
                                  "Function '%s' already defined", child->value);
                 symbol_destroy(func_symbol);
                 success = false;
@@ -214,31 +362,42 @@ bool semantic_analyze_program(SemanticContext* context, ASTNode* node) {
         }
     }
     
+    timing_end(phase);
+    
     // Fourth pass: analyze function bodies
-    for (int i = 0; i < node->child_count; i++) {
-        ASTNode* child = node->children[i];
-        if (child->type == AST_FUNCTION || child->type == AST_GENERIC_FUNCTION) {
-            if (!semantic_analyze_function(context, child)) {
-                success = false;
-            }
-        }
+    phase = timing_begin("function bodies");
+    if (!semantic_analyze_function_bodies(context, node)) {
+        success = false;
     }
+    timing_end(phase);
     
     return success;
 }
 
-// Analyze struct declaration
+// Analyze struct declaration, build its field index and add it to the
+// global scope as a type
 bool semantic_analyze_struct(SemanticContext* context, ASTNode* node) {
     if (!context || !node || node->type != AST_STRUCT) return false;
     
     bool success = true;
     
-    printf("✓ Analyzing struct: %s\n", node->value);
+    LOG_DEBUG(LOG_CAT_SEMANTIC, "✓ Analyzing struct: %s\n", node->value);
+    
+    StructLayout* layout = struct_layout_create(node, context->symbol_table);
     
     // Check all fields in the struct
     for (int i = 0; i < node->child_count; i++) {
         ASTNode* field = node->children[i];
         if (field->type == AST_VARIABLE_DECL) {
+            // Field names must be unique (the index keeps the first declaration)
+            const StructField* indexed = struct_layout_find(layout, field->value);
+            if (indexed && indexed->declaration != field) {
+                semantic_add_error(context, SEMANTIC_ERROR_REDEFINED_SYMBOL,
+                                 SEMANTIC_SEVERITY_ERROR, field->location,
+                                 "Field '%s' already defined in struct '%s'", field->value, node->value);
+                success = false;
+            }
+            
             // Check if field type is valid
             if (field->child_count > 0) {
                 ASTNode* field_type = field->children[0];
@@ -246,7 +405,7 @@ bool semantic_analyze_struct(SemanticContext* context, ASTNode* node) {
                 // Rule 1: auto is NOT allowed in struct fields
                 if (field_type->type == AST_AUTO_TYPE) {
                     semantic_add_error(context, SEMANTIC_ERROR_INVALID_AUTO_USAGE,
-                                     SEMANTIC_SEVERITY_ERROR, field->line, field->column,
+                                     SEMANTIC_SEVERITY_ERROR, field->location,
                                      "Auto type is not allowed in struct field '%s'. "
                                      "Struct fields must have concrete types", field->value);
                     success = false;
@@ -255,32 +414,27 @@ bool semantic_analyze_struct(SemanticContext* context, ASTNode* node) {
                 
                 // Rule 2: Check if field type is a valid concrete type
                 if (field_type->value) {
-                    // Check built-in types
-                    bool is_valid_type = (
-                        strcmp(field_type->value, "i8") == 0 ||
-                        strcmp(field_type->value, "i16") == 0 ||
-                        strcmp(field_type->value, "i32") == 0 ||
-                        strcmp(field_type->value, "i64") == 0 ||
-                        strcmp(field_type->value, "f32") == 0 ||
-                        strcmp(field_type->value, "f64") == 0 ||
-                        strcmp(field_type->value, "bool") == 0 ||
-                        strcmp(field_type->value, "string") == 0 ||
-                        strcmp(field_type->value, "char") == 0
-                    );
+                    // Check built-in types (any type keyword except void)
+                    const Type* type = type_parse(field_type->value);
+                    bool is_valid_type = type_has_trait(type, TYPE_TRAIT_KEYWORD) &&
+                                         !type_has_trait(type, TYPE_TRAIT_VOID);
                     
-                    // TODO: Also check user-defined types (other structs)
-                    // For now, assume any non-builtin type might be valid
+                    // Structs declared earlier are valid too
+                    if (!is_valid_type && type_is_kind(type, TYPE_STRUCT)) {
+                        Symbol* type_symbol = symbol_table_lookup(context->symbol_table, type->name);
+                        is_valid_type = type_symbol && type_symbol->type == SYMBOL_STRUCT;
+                    }
                     
                     if (!is_valid_type) {
                         // For now, just warn about unknown types
                         semantic_add_error(context, SEMANTIC_ERROR_UNDEFINED_TYPE,
-                                         SEMANTIC_SEVERITY_WARNING, field->line, field->column,
+                                         SEMANTIC_SEVERITY_WARNING, field->location,
                                          "Unknown type '%s' for field '%s'", 
                                          field_type->value, field->value);
                     }
                 } else {
                     semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                                     SEMANTIC_SEVERITY_ERROR, field->line, field->column,
+                                     SEMANTIC_SEVERITY_ERROR, field->location,
                                      "Field '%s' has no type", field->value);
                     success = false;
                 }
@@ -288,6 +442,21 @@ bool semantic_analyze_struct(SemanticContext* context, ASTNode* node) {
         }
     }
     
+    // Add struct to global scope as a type; the symbol owns the layout
+    Symbol* struct_symbol = symbol_create(node->value, SYMBOL_STRUCT, node, NULL);
+    if (struct_symbol) {
+        struct_symbol->layout = layout;
+        layout = NULL;
+    }
+    if (!symbol_table_add_symbol(context->symbol_table, struct_symbol)) {
+        semantic_add_error(context, SEMANTIC_ERROR_REDEFINED_SYMBOL, 
+                         SEMANTIC_SEVERITY_ERROR, node->location,
+                         "Struct '%s' already defined", node->value);
+        symbol_destroy(struct_symbol);
+        success = false;
+    }
+    struct_layout_destroy(layout);
+    
     return success;
 }
 
@@ -299,11 +468,11 @@ bool semantic_analyze_function(SemanticContext* context, ASTNode* node) {
     
     // Handle generic functions
     if (node->type == AST_GENERIC_FUNCTION) {
-        printf("✓ Analyzing generic function: %s\n", node->value);
+        LOG_DEBUG(LOG_CAT_SEMANTIC, "✓ Analyzing generic function: %s\n", node->value);
         
         // Analyze generic function for type inference
         if (!type_inference_analyze_function(context->type_inference, node)) {
-            printf("Failed to analyze generic function for type inference\n");
+            LOG_ERROR(LOG_CAT_SEMANTIC, "Failed to analyze generic function for type inference\n");
             return false;
         }
         
@@ -330,7 +499,7 @@ bool semantic_analyze_function(SemanticContext* context, ASTNode* node) {
                 
                 if (!symbol_table_add_symbol(context->symbol_table, param_symbol)) {
                     semantic_add_error(context, SEMANTIC_ERROR_REDEFINED_SYMBOL,
-                                     SEMANTIC_SEVERITY_ERROR, param->line, param->column,
+                                     SEMANTIC_SEVERITY_ERROR, param->location,
                                      "Parameter '%s' already defined", param->value);
                     symbol_destroy(param_symbol);
                     success = false;
@@ -362,7 +531,7 @@ bool semantic_analyze_function(SemanticContext* context, ASTNode* node) {
             }
         }
         
-        if (return_type && return_type->value && strcmp(return_type->value, "void") != 0) {
+        if (return_type && return_type->value && !type_has_trait(type_parse(return_type->value), TYPE_TRAIT_VOID)) {
             // TODO: Check if all paths return a value
             // For now, just check if there's at least one return statement
             bool has_return = false;
@@ -375,7 +544,7 @@ bool semantic_analyze_function(SemanticContext* context, ASTNode* node) {
             
             if (!has_return) {
                 semantic_add_error(context, SEMANTIC_ERROR_MISSING_RETURN,
-                                 SEMANTIC_SEVERITY_WARNING, node->line, node->column,
+                                 SEMANTIC_SEVERITY_WARNING, node->location,
                                  "Function '%s' may not return a value on all paths", node->value);
             }
         }
@@ -456,7 +625,7 @@ bool semantic_analyze_variable_decl(SemanticContext* context, ASTNode* node) {
     ASTNode* type_node = node->child_count > 0 ? node->children[0] : NULL;
     if (!type_node) {
         semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                         SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                         SEMANTIC_SEVERITY_ERROR, node->location,
                          "Variable '%s' has no type", node->value);
         return false;
     }
@@ -473,37 +642,34 @@ bool semantic_analyze_variable_decl(SemanticContext* context, ASTNode* node) {
         
         // Now use type inference to determine the actual type
         if (context->type_inference) {
-            char* inferred_type = type_inference_infer_expression_type_with_symbols(
+            const char* inferred_type = type_inference_infer_expression_type_with_symbols(
                 context->type_inference, initializer, context->symbol_table);
             if (inferred_type) {
-                printf("✓ Inferred type '%s' for variable '%s'\n", inferred_type, node->value);
+                LOG_DEBUG(LOG_CAT_INFERENCE, "✓ Inferred type '%s' for variable '%s'\n", inferred_type, node->value);
                 
                 // Create a new concrete type node
                 ASTNode* concrete_type = ast_create_node(AST_TYPE, inferred_type);
-                concrete_type->line = type_node->line;
-                concrete_type->column = type_node->column;
+                ast_set_location(concrete_type, type_node->location);
                 
                 // Replace the auto type with the concrete type
                 node->children[0] = concrete_type;
                 ast_destroy(type_node);
                 type_node = concrete_type;
-                
-                free(inferred_type);
             } else {
                 semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                                 SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                                 SEMANTIC_SEVERITY_ERROR, node->location,
                                  "Could not infer type for auto variable '%s'", node->value);
                 return false;
             }
         } else {
             semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                             SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                             SEMANTIC_SEVERITY_ERROR, node->location,
                              "Type inference not available for auto variable '%s'", node->value);
             return false;
         }
     } else if (type_node->type == AST_AUTO_TYPE) {
         semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                         SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                         SEMANTIC_SEVERITY_ERROR, node->location,
                          "Auto variable '%s' must have an initializer", node->value);
         return false;
     }
@@ -526,7 +692,7 @@ bool semantic_analyze_variable_decl(SemanticContext* context, ASTNode* node) {
     // Add to current scope
     if (!symbol_table_add_symbol(context->symbol_table, var_symbol)) {
         semantic_add_error(context, SEMANTIC_ERROR_REDEFINED_SYMBOL,
-                         SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                         SEMANTIC_SEVERITY_ERROR, node->location,
                          "Variable '%s' already defined in this scope", node->value);
         symbol_destroy(var_symbol);
         return false;
@@ -535,17 +701,15 @@ bool semantic_analyze_variable_decl(SemanticContext* context, ASTNode* node) {
     return true;
 }
 
-// Analyze expression
-bool semantic_analyze_expression(SemanticContext* context, ASTNode* node) {
-    if (!context || !node) return false;
-    
+// Validate expression (operands are analyzed, and thereby typed, first)
+static bool semantic_check_expression(SemanticContext* context, ASTNode* node) {
     switch (node->type) {
         case AST_IDENTIFIER: {
             // Check if identifier is defined
             Symbol* symbol = symbol_table_lookup(context->symbol_table, node->value);
             if (!symbol) {
                 semantic_add_error(context, SEMANTIC_ERROR_UNDEFINED_SYMBOL,
-                                 SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                                 SEMANTIC_SEVERITY_ERROR, node->location,
                                  "Undefined symbol '%s'", node->value);
                 return false;
             }
@@ -553,7 +717,7 @@ bool semantic_analyze_expression(SemanticContext* context, ASTNode* node) {
             // Check if variable is initialized
             if (symbol->type == SYMBOL_VARIABLE && !symbol->is_initialized) {
                 semantic_add_error(context, SEMANTIC_ERROR_UNINITIALIZED_VARIABLE,
-                                 SEMANTIC_SEVERITY_WARNING, node->line, node->column,
+                                 SEMANTIC_SEVERITY_WARNING, node->location,
                                  "Variable '%s' used before initialization", node->value);
             }
             
@@ -576,7 +740,7 @@ bool semantic_analyze_expression(SemanticContext* context, ASTNode* node) {
                 Symbol* symbol = symbol_table_lookup(context->symbol_table, full_name);
                 if (!symbol) {
                     semantic_add_error(context, SEMANTIC_ERROR_UNDEFINED_SYMBOL,
-                                     SEMANTIC_SEVERITY_ERROR, node->line, node->column,
+                                     SEMANTIC_SEVERITY_ERROR, node->location,
                                      "Undefined symbol '%s'", full_name);
                     return false;
                 }
@@ -624,6 +788,19 @@ bool semantic_analyze_expression(SemanticContext* context, ASTNode* node) {
     }
 }
 
+// Analyze expression and annotate it with its inferred type. Children are
+// annotated before their parent, so typing a whole expression is linear.
+bool semantic_analyze_expression(SemanticContext* context, ASTNode* node) {
+    if (!context || !node) return false;
+    
+    if (!semantic_check_expression(context, node)) return false;
+    
+    if (context->type_inference) {
+        type_inference_infer_expression_type_with_symbols(context->type_inference, node, context->symbol_table);
+    }
+    return true;
+}
+
 // Validate function call
 bool semantic_validate_function_call(SemanticContext* context, ASTNode* call) {
     if (!context || !call || call->type != AST_CALL) return false;
@@ -665,12 +842,13 @@ bool semantic_validate_function_call(SemanticContext* context, ASTNode* call) {
     if (func_symbol && func_symbol->ast_node && 
         func_symbol->ast_node->type == AST_GENERIC_FUNCTION) {
         
-        printf("✓ Found call to generic function: %s\n", func_symbol->name);
+        LOG_DEBUG(LOG_CAT_INFERENCE, "✓ Found call to generic function: %s\n", func_symbol->name);
         
         // Perform type inference for this call
-        if (!type_inference_infer_call(context->type_inference, call, func_symbol->ast_node, context->symbol_table)) {
+        if (!type_inference_infer_call(context->type_inference, call, func_symbol->ast_node,
+                                       context->symbol_table, context->call_order++)) {
             semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                             SEMANTIC_SEVERITY_ERROR, call->line, call->column,
+                             SEMANTIC_SEVERITY_ERROR, call->location,
                              "Failed to infer types for generic function call '%s'", 
                              func_symbol->name);
             success = false;
@@ -686,7 +864,7 @@ bool semantic_validate_function_call(SemanticContext* context, ASTNode* call) {
 bool semantic_check_types_compatible(ASTNode* type1, ASTNode* type2) {
     if (!type1 || !type2) return false;
     if (!type1->value || !type2->value) return false;
-    return strcmp(type1->value, type2->value) == 0;
+    return type1->value == type2->value; // interned
 }
 
 ASTNode* semantic_get_expression_type(SemanticContext* context, ASTNode* expr) {
@@ -704,16 +882,10 @@ ASTNode* semantic_get_expression_type(SemanticContext* context, ASTNode* expr) {
         
         case AST_LITERAL: {
             // Create type node based on literal type
-            if (expr->data_type) {
-                ASTNode* type_node = malloc(sizeof(ASTNode));
+            if (ast_data_type(expr)) {
+                ASTNode* type_node = ast_create_node(AST_TYPE, ast_data_type(expr));
                 if (type_node) {
-                    type_node->type = AST_TYPE;
-                    type_node->value = strdup(expr->data_type);
-                    type_node->child_count = 0;
-                    type_node->children = NULL;
-                    type_node->line = expr->line;
-                    type_node->column = expr->column;
-                    type_node->data_type = NULL;
+                    ast_set_location(type_node, expr->location);
                     return type_node;
                 }
             }
@@ -736,7 +908,7 @@ ASTNode* semantic_get_expression_type(SemanticContext* context, ASTNode* expr) {
             if (!struct_symbol || struct_symbol->type != SYMBOL_STRUCT) return NULL;
             
             // Get the field type from struct declaration
-            return semantic_get_struct_field_type(struct_symbol->declaration, field_expr->value);
+            return semantic_get_struct_field_type(struct_symbol, field_expr->value);
         }
         
         default:
@@ -773,45 +945,23 @@ bool semantic_check_memory_management(SemanticContext* context, ASTNode* node) {
     return true;
 }
 
-// Check if struct has a specific field
-bool semantic_struct_has_field(ASTNode* struct_decl, const char* field_name) {
-    if (!struct_decl || struct_decl->type != AST_STRUCT || !field_name) {
+// Check if struct has a specific field (field_name is interned)
+bool semantic_struct_has_field(Symbol* struct_symbol, const char* field_name) {
+    if (!struct_symbol || struct_symbol->type != SYMBOL_STRUCT || !field_name) {
         return false;
     }
     
-    // Check all fields in the struct
-    for (int i = 0; i < struct_decl->child_count; i++) {
-        ASTNode* field = struct_decl->children[i];
-        if (field->type == AST_VARIABLE_DECL && field->value) {
-            if (strcmp(field->value, field_name) == 0) {
-                return true;
-            }
-        }
-    }
-    
-    return false;
+    return struct_layout_find(struct_symbol->layout, field_name) != NULL;
 }
 
-// Get the type of a specific field in a struct
-ASTNode* semantic_get_struct_field_type(ASTNode* struct_decl, const char* field_name) {
-    if (!struct_decl || struct_decl->type != AST_STRUCT || !field_name) {
+// Get the type of a specific field in a struct (field_name is interned)
+ASTNode* semantic_get_struct_field_type(Symbol* struct_symbol, const char* field_name) {
+    if (!struct_symbol || struct_symbol->type != SYMBOL_STRUCT || !field_name) {
         return NULL;
     }
     
-    // Find the field and return its type
-    for (int i = 0; i < struct_decl->child_count; i++) {
-        ASTNode* field = struct_decl->children[i];
-        if (field->type == AST_VARIABLE_DECL && field->value) {
-            if (strcmp(field->value, field_name) == 0) {
-                // Return the type node (first child of variable declaration)
-                if (field->child_count > 0) {
-                    return field->children[0];
-                }
-            }
-        }
-    }
-    
-    return NULL;
+    const StructField* field = struct_layout_find(struct_symbol->layout, field_name);
+    return field ? field->type_node : NULL;
 }
 
 // Validate member access expressions
@@ -822,7 +972,7 @@ bool semantic_validate_member_access(SemanticContext* context, ASTNode* member_a
     
     if (member_access->child_count < 2) {
         semantic_add_error(context, SEMANTIC_ERROR_INVALID_OPERATION,
-                         SEMANTIC_SEVERITY_ERROR, member_access->line, member_access->column,
+                         SEMANTIC_SEVERITY_ERROR, member_access->location,
                          "Invalid member access expression");
         return false;
     }
@@ -839,7 +989,7 @@ bool semantic_validate_member_access(SemanticContext* context, ASTNode* member_a
     ASTNode* obj_type = semantic_get_expression_type(context, obj_expr);
     if (!obj_type || !obj_type->value) {
         semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                         SEMANTIC_SEVERITY_ERROR, member_access->line, member_access->column,
+                         SEMANTIC_SEVERITY_ERROR, member_access->location,
                          "Cannot determine type of object in member access");
         return false;
     }
@@ -848,15 +998,15 @@ bool semantic_validate_member_access(SemanticContext* context, ASTNode* member_a
     Symbol* struct_symbol = symbol_table_lookup(context->symbol_table, obj_type->value);
     if (!struct_symbol || struct_symbol->type != SYMBOL_STRUCT) {
         semantic_add_error(context, SEMANTIC_ERROR_TYPE_MISMATCH,
-                         SEMANTIC_SEVERITY_ERROR, member_access->line, member_access->column,
+                         SEMANTIC_SEVERITY_ERROR, member_access->location,
                          "Member access on non-struct type '%s'", obj_type->value);
         return false;
     }
     
     // Check if the field exists in the struct
-    if (!semantic_struct_has_field(struct_symbol->declaration, field_expr->value)) {
+    if (!semantic_struct_has_field(struct_symbol, field_expr->value)) {
         semantic_add_error(context, SEMANTIC_ERROR_UNDEFINED_FIELD,
-                         SEMANTIC_SEVERITY_ERROR, member_access->line, member_access->column,
+                         SEMANTIC_SEVERITY_ERROR, member_access->location,
                          "Struct '%s' has no field named '%s'", obj_type->value, field_expr->value);
         return false;
     }
@@ -870,17 +1020,32 @@ bool semantic_validate_struct_literal(SemanticContext* context, ASTNode* struct_
         return false;
     }
     
-    // For now, just validate that all field values are valid expressions
-    // In a full implementation, we would:
-    // 1. Determine the target struct type from context
+    // Validate field values, and field names when the literal names its struct.
+    // Still missing:
+    // 1. Determine the target struct type of anonymous literals from context
     // 2. Check that all required fields are initialized
-    // 3. Check that no unknown fields are provided
-    // 4. Validate field value types match field declarations
+    // 3. Validate field value types match field declarations
+    
+    Symbol* struct_symbol = struct_literal->value
+        ? symbol_table_lookup(context->symbol_table, struct_literal->value)
+        : NULL;
+    if (struct_symbol && struct_symbol->type != SYMBOL_STRUCT) {
+        struct_symbol = NULL;
+    }
     
     bool success = true;
     for (int i = 0; i < struct_literal->child_count; i++) {
         ASTNode* field_init = struct_literal->children[i];
         if (field_init->type == AST_ASSIGNMENT && field_init->child_count >= 2) {
+            ASTNode* field_name = field_init->children[0];
+            if (struct_symbol && field_name->value &&
+                !semantic_struct_has_field(struct_symbol, field_name->value)) {
+                semantic_add_error(context, SEMANTIC_ERROR_UNDEFINED_FIELD,
+                                 SEMANTIC_SEVERITY_ERROR, field_name->location,
+                                 "Struct '%s' has no field named '%s'", struct_literal->value, field_name->value);
+                success = false;
+            }
+            
             // Validate the field value expression
             ASTNode* field_value = field_init->children[1];
             if (!semantic_analyze_expression(context, field_value)) {
@@ -5,6 +5,7 @@
 #include "symbol_table.h"
 #include "semantic_errors.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 // Forward declarations
 struct ImportContext;
@@ -19,8 +20,11 @@ typedef struct SemanticContext {
     int warning_count;
     bool has_fatal_error;
     char* current_filename;
+    const LineIndex* lines;        // Line starts of that file (not owned), for error positions
     struct ImportContext* import_context; // Import system context
     struct TypeInferenceContext* type_inference; // Type inference system
+    int jobs;                      // Threads analyzing function bodies (-j)
+    uint64_t call_order;           // Rank of the next generic call: function position << 32 | call number
 } SemanticContext;
 
 // Main semantic analysis functions
@@ -28,10 +32,11 @@ SemanticContext* semantic_create(void);
 void semantic_destroy(SemanticContext* context);
 void semantic_add_builtin_modules(SemanticContext* context);
 bool semantic_analyze(SemanticContext* context, ASTNode* ast);
+bool semantic_report(SemanticContext* context, bool success);
 
 // Error handling
 void semantic_add_error(SemanticContext* context, SemanticErrorType type, 
-                       SemanticSeverity severity, int line, int column, 
+                       SemanticSeverity severity, uint32_t location, 
                        const char* format, ...);
 void semantic_print_errors(SemanticContext* context);
 bool semantic_has_errors(SemanticContext* context);
@@ -54,8 +59,8 @@ bool semantic_validate_member_access(SemanticContext* context, ASTNode* member_a
 bool semantic_validate_struct_literal(SemanticContext* context, ASTNode* struct_literal);
 
 // Struct validation
-bool semantic_struct_has_field(ASTNode* struct_decl, const char* field_name);
-ASTNode* semantic_get_struct_field_type(ASTNode* struct_decl, const char* field_name);
+bool semantic_struct_has_field(Symbol* struct_symbol, const char* field_name);
+ASTNode* semantic_get_struct_field_type(Symbol* struct_symbol, const char* field_name);
 
 // Control flow analysis
 bool semantic_check_return_paths(SemanticContext* context, ASTNode* function);
@@ -0,0 +1,140 @@
+#include "struct_layout.h"
+#include "symbol_table.h"
+#include "../utils/string_intern.h"
+#include <stdlib.h>
+#include <string.h>
+
+static size_t layout_align_up(size_t value, size_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+// C size and alignment of a field type
+static void layout_type_size(const Type* type, SymbolTable* symbol_table, size_t* size, size_t* alignment) {
+    *size = sizeof(void*);
+    *alignment = sizeof(void*);
+    if (!type) return;
+    
+    switch (type->kind) {
+        case TYPE_PRIMITIVE:
+            *size = type->size;
+            *alignment = type->size > 0 ? type->size : 1;
+            return;
+        
+        case TYPE_STRUCT: {
+            // Structs declared earlier have a layout; anything else is opaque
+            Symbol* symbol = symbol_table ? symbol_table_lookup(symbol_table, type->name) : NULL;
+            if (symbol && symbol->type == SYMBOL_STRUCT && symbol->layout) {
+                *size = symbol->layout->size;
+                *alignment = symbol->layout->alignment;
+            }
+            return;
+        }
+        
+        case TYPE_OPTIONAL: {
+            // struct { bool has_value; T value; }
+            size_t base_size, base_alignment;
+            layout_type_size(type->base, symbol_table, &base_size, &base_alignment);
+            *alignment = base_alignment > 1 ? base_alignment : 1;
+            *size = layout_align_up(layout_align_up(1, *alignment) + base_size, *alignment);
+            return;
+        }
+        
+        case TYPE_ARRAY:
+            if (type->array_size >= 0) {
+                size_t base_size;
+                layout_type_size(type->base, symbol_table, &base_size, alignment);
+                *size = base_size * (size_t)type->array_size;
+            }
+            return;
+        
+        default:
+            // Pointers, smart pointers, functions and unsized arrays
+            return;
+    }
+}
+
+// Structured type of a field's type node
+static const Type* layout_field_type(ASTNode* type_node) {
+    if (!type_node || !type_node->value) return NULL;
+    
+    const Type* type = type_parse(type_node->value);
+    if (ast_has_flag(type_node, AST_FLAG_POINTER)) type = type_pointer(type);
+    if (ast_has_flag(type_node, AST_FLAG_OPTIONAL)) type = type_optional(type);
+    return type;
+}
+
+// Build the index for a struct declaration
+StructLayout* struct_layout_create(ASTNode* struct_decl, SymbolTable* symbol_table) {
+    if (!struct_decl || struct_decl->type != AST_STRUCT) return NULL;
+    
+    StructLayout* layout = calloc(1, sizeof(StructLayout));
+    if (!layout) return NULL;
+    
+    int count = 0;
+    for (int i = 0; i < struct_decl->child_count; i++) {
+        ASTNode* field = struct_decl->children[i];
+        if (field->type == AST_VARIABLE_DECL && field->value) count++;
+    }
+    
+    // Index at a load factor of at most 1/2
+    int capacity = 8;
+    while (capacity < count * 2) capacity *= 2;
+    
+    layout->fields = calloc(count > 0 ? count : 1, sizeof(StructField));
+    layout->index = calloc(capacity, sizeof(int));
+    if (!layout->fields || !layout->index) {
+        struct_layout_destroy(layout);
+        return NULL;
+    }
+    layout->index_capacity = capacity;
+    layout->alignment = 1;
+    
+    for (int i = 0; i < struct_decl->child_count; i++) {
+        ASTNode* declaration = struct_decl->children[i];
+        if (declaration->type != AST_VARIABLE_DECL || !declaration->value) continue;
+        
+        StructField* field = &layout->fields[layout->field_count];
+        field->name = intern_string(declaration->value);
+        field->declaration = declaration;
+        field->type_node = declaration->child_count > 0 ? declaration->children[0] : NULL;
+        field->type = layout_field_type(field->type_node);
+        field->ordinal = layout->field_count++;
+        
+        size_t size, alignment;
+        layout_type_size(field->type, symbol_table, &size, &alignment);
+        field->offset = layout_align_up(layout->size, alignment);
+        layout->size = field->offset + size;
+        if (alignment > layout->alignment) layout->alignment = alignment;
+        
+        // Keep the first declaration of a duplicated name
+        size_t slot = intern_hash(field->name) & (capacity - 1);
+        while (layout->index[slot] && layout->fields[layout->index[slot] - 1].name != field->name) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (!layout->index[slot]) layout->index[slot] = field->ordinal + 1;
+    }
+    
+    layout->size = layout_align_up(layout->size, layout->alignment);
+    return layout;
+}
+
+void struct_layout_destroy(StructLayout* layout) {
+    if (!layout) return;
+    
+    free(layout->fields);
+    free(layout->index);
+    free(layout);
+}
+
+// Field by interned name
+const StructField* struct_layout_find(const StructLayout* layout, const char* name) {
+    if (!layout || !name) return NULL;
+    
+    size_t slot = intern_hash(name) & (layout->index_capacity - 1);
+    while (layout->index[slot]) {
+        const StructField* field = &layout->fields[layout->index[slot] - 1];
+        if (field->name == name) return field;
+        slot = (slot + 1) & (layout->index_capacity - 1);
+    }
+    return NULL;
+}
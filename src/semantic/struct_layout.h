@@ -0,0 +1,41 @@
+#ifndef STRUCT_LAYOUT_H
+#define STRUCT_LAYOUT_H
+
+#include "../ast/ast.h"
+#include "types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+struct SymbolTable;
+
+// Field of a struct, in declaration order
+typedef struct StructField {
+    const char* name;          // Interned
+    ASTNode* declaration;      // AST_VARIABLE_DECL of the field
+    ASTNode* type_node;        // Declared type
+    const Type* type;          // Structured type (pointer/optional flags applied)
+    int ordinal;               // Position in the struct
+    size_t offset;             // Byte offset in the generated C struct
+} StructField;
+
+// Field index of a struct declaration, built once by semantic analysis and
+// owned by the struct's symbol. Lookup by name is one hash probe.
+typedef struct StructLayout {
+    StructField* fields;
+    int field_count;
+    int* index;                // Open addressing: ordinal + 1, 0 marks an empty slot
+    int index_capacity;        // Power of two
+    size_t size;               // sizeof the generated C struct
+    size_t alignment;
+} StructLayout;
+
+// Build the index for an AST_STRUCT; nested struct sizes come from the
+// layouts of structs already in symbol_table. If a name is declared twice,
+// lookups find the first declaration.
+StructLayout* struct_layout_create(ASTNode* struct_decl, struct SymbolTable* symbol_table);
+void struct_layout_destroy(StructLayout* layout);
+
+// Field by interned name (NULL if the struct has no such field)
+const StructField* struct_layout_find(const StructLayout* layout, const char* name);
+
+#endif // STRUCT_LAYOUT_H
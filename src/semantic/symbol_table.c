@@ -1,21 +1,82 @@
 #define _GNU_SOURCE
 #include "symbol_table.h"
+#include "struct_layout.h"
+#include "../utils/string_intern.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// Hash table size for symbols
-#define SYMBOL_HASH_SIZE 64
+// Initial size of the name table (power of two)
+#define SYMBOL_TABLE_INITIAL_CAPACITY 64
 
-// Simple hash function for symbol names
-static unsigned int hash_symbol_name(const char* name) {
-    if (!name) return 0;
+// Find the slot for an interned name: either its slot or the empty one where
+// it would go (hash is precomputed by the intern table)
+static SymbolSlot* symbol_table_find_slot(SymbolTable* table, const char* name) {
+    size_t mask = table->slot_capacity - 1;
+    size_t index = intern_hash(name) & mask;
+    
+    while (table->slots[index].name && table->slots[index].name != name) {
+        index = (index + 1) & mask;
+    }
+    return &table->slots[index];
+}
+
+// Double the name table and reinsert every used slot
+static bool symbol_table_grow(SymbolTable* table) {
+    size_t old_capacity = table->slot_capacity;
+    SymbolSlot* old_slots = table->slots;
+    
+    size_t new_capacity = old_capacity ? old_capacity * 2 : SYMBOL_TABLE_INITIAL_CAPACITY;
+    SymbolSlot* new_slots = calloc(new_capacity, sizeof(SymbolSlot));
+    if (!new_slots) return false;
+    
+    table->slots = new_slots;
+    table->slot_capacity = new_capacity;
+    
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].name) {
+            *symbol_table_find_slot(table, old_slots[i].name) = old_slots[i];
+        }
+    }
+    
+    free(old_slots);
+    return true;
+}
+
+// Get a scope record, reusing one from the free list when possible
+static Scope* scope_acquire(SymbolTable* table, Scope* parent, bool is_function_scope) {
+    Scope* scope = table->free_scopes;
+    if (scope) {
+        table->free_scopes = scope->next;
+    } else {
+        scope = malloc(sizeof(Scope));
+        if (!scope) return NULL;
+    }
+    
+    scope->symbols = NULL;
+    scope->parent = parent;
+    scope->level = parent ? parent->level + 1 : 0;
+    scope->is_function_scope = is_function_scope;
+    scope->function_node = NULL;
+    scope->next = NULL;
     
-    unsigned int hash = 5381;
-    for (const char* p = name; *p; p++) {
-        hash = ((hash << 5) + hash) + *p;
+    return scope;
+}
+
+// Remove the symbols of a scope from the name table and destroy them
+static void scope_release_symbols(SymbolTable* table, Scope* scope) {
+    Symbol* symbol = scope->symbols;
+    while (symbol) {
+        Symbol* next = symbol->scope_next;
+        
+        // Declarations are popped newest first, so symbol is the innermost one
+        SymbolSlot* slot = symbol_table_find_slot(table, symbol->name);
+        slot->symbol = symbol->next;
+        
+        symbol_destroy(symbol);
+        symbol = next;
     }
-    return hash % SYMBOL_HASH_SIZE;
+    scope->symbols = NULL;
 }
 
 // Create symbol table
@@ -23,81 +84,74 @@ SymbolTable* symbol_table_create(void) {
     SymbolTable* table = malloc(sizeof(SymbolTable));
     if (!table) return NULL;
     
-    table->global_scope = scope_create(NULL, false);
+    table->slots = NULL;
+    table->slot_capacity = 0;
+    table->slot_count = 0;
+    table->free_scopes = NULL;
+    table->scope_counter = 0;
+    table->base = NULL;
+    
+    if (!symbol_table_grow(table)) {
+        free(table);
+        return NULL;
+    }
+    
+    table->global_scope = scope_acquire(table, NULL, false);
     if (!table->global_scope) {
+        free(table->slots);
         free(table);
         return NULL;
     }
     
     table->current_scope = table->global_scope;
-    table->scope_counter = 0;
     
     return table;
 }
 
-// Destroy symbol table
+// Create a layer over base (which must outlive it and stay unchanged while
+// the layer is in use)
+SymbolTable* symbol_table_create_layer(SymbolTable* base) {
+    SymbolTable* table = symbol_table_create();
+    if (table) {
+        table->base = base;
+    }
+    return table;
+}
+
+// Destroy symbol table (a layer leaves its base alone)
 void symbol_table_destroy(SymbolTable* table) {
     if (!table) return;
     
-    scope_destroy(table->global_scope);
-    free(table);
-}
-
-// Create scope
-Scope* scope_create(Scope* parent, bool is_function_scope) {
-    Scope* scope = malloc(sizeof(Scope));
-    if (!scope) return NULL;
-    
-    // Initialize hash table
-    scope->symbols = calloc(SYMBOL_HASH_SIZE, sizeof(Symbol*));
-    if (!scope->symbols) {
-        free(scope);
-        return NULL;
+    // Unwind any scopes still open, then the global scope
+    while (table->current_scope != table->global_scope) {
+        symbol_table_exit_scope(table);
     }
+    scope_release_symbols(table, table->global_scope);
+    free(table->global_scope);
     
-    scope->parent = parent;
-    scope->level = parent ? parent->level + 1 : 0;
-    scope->is_function_scope = is_function_scope;
-    scope->function_node = NULL;
-    scope->next = NULL;
-    
-    return scope;
-}
-
-// Destroy scope
-void scope_destroy(Scope* scope) {
-    if (!scope) return;
-    
-    // Destroy all symbols in hash table
-    for (int i = 0; i < SYMBOL_HASH_SIZE; i++) {
-        Symbol* symbol = ((Symbol**)scope->symbols)[i];
-        while (symbol) {
-            Symbol* next = symbol->next;
-            symbol_destroy(symbol);
-            symbol = next;
-        }
+    Scope* scope = table->free_scopes;
+    while (scope) {
+        Scope* next = scope->next;
+        free(scope);
+        scope = next;
     }
     
-    free(scope->symbols);
-    
-    // Don't recursively destroy child scopes to avoid issues
-    // In a full implementation, we'd need proper scope lifetime management
-    
-    free(scope);
+    free(table->slots);
+    free(table);
 }
 
 // Enter new scope
 void symbol_table_enter_scope(SymbolTable* table, bool is_function_scope) {
     if (!table) return;
     
-    Scope* new_scope = scope_create(table->current_scope, is_function_scope);
+    Scope* new_scope = scope_acquire(table, table->current_scope, is_function_scope);
     if (!new_scope) return;
     
     table->current_scope = new_scope;
     table->scope_counter++;
 }
 
-// Exit current scope
+// Exit current scope: its symbols go out of view and the record is recycled
 void symbol_table_exit_scope(SymbolTable* table) {
     if (!table || !table->current_scope || table->current_scope == table->global_scope) {
         return;
@@ -106,8 +160,9 @@ void symbol_table_exit_scope(SymbolTable* table) {
     Scope* old_scope = table->current_scope;
     table->current_scope = old_scope->parent;
     
-    // For now, don't destroy the scope immediately to avoid memory issues
-    // In a full implementation, we'd need proper scope lifetime management
+    scope_release_symbols(table, old_scope);
+    old_scope->next = table->free_scopes;
+    table->free_scopes = old_scope;
 }
 
 // Create symbol
@@ -117,7 +172,7 @@ Symbol* symbol_create(const char* name, SymbolType type, ASTNode* declaration, A
     Symbol* symbol = malloc(sizeof(Symbol));
     if (!symbol) return NULL;
     
-    symbol->name = strdup(name);
+    symbol->name = intern_string(name);
     symbol->type = type;
     symbol->declaration = declaration;
     symbol->ast_node = declaration;  // Alias for declaration
@@ -128,7 +183,9 @@ Symbol* symbol_create(const char* name, SymbolType type, ASTNode* declaration, A
     symbol->is_used = false;
     symbol->is_parameter = (type == SYMBOL_PARAMETER);
     symbol->is_builtin = false;
+    symbol->layout = NULL;
     symbol->next = NULL;
+    symbol->scope_next = NULL;
     
     return symbol;
 }
@@ -137,8 +194,8 @@ Symbol* symbol_create(const char* name, SymbolType type, ASTNode* declaration, A
 void symbol_destroy(Symbol* symbol) {
     if (!symbol) return;
     
-    free(symbol->name);
     free(symbol->c_function_name);
+    struct_layout_destroy(symbol->layout);
     // Note: We don't destroy AST nodes here as they're owned by the AST
     free(symbol);
 }
@@ -147,35 +204,50 @@ void symbol_destroy(Symbol* symbol) {
 bool symbol_table_add_symbol(SymbolTable* table, Symbol* symbol) {
     if (!table || !symbol || !table->current_scope) return false;
     
+    // Keep the load factor under 3/4 so probe sequences stay short
+    if ((table->slot_count + 1) * 4 > table->slot_capacity * 3 && !symbol_table_grow(table)) {
+        return false;
+    }
+    
+    SymbolSlot* slot = symbol_table_find_slot(table, symbol->name);
+    
     // Check if symbol already exists in current scope
-    Symbol* existing = symbol_table_lookup_current_scope(table, symbol->name);
-    if (existing) {
+    if (slot->symbol && slot->symbol->scope_level == table->current_scope->level) {
         return false; // Symbol already exists
     }
     
-    // Add to hash table
-    unsigned int hash = hash_symbol_name(symbol->name);
-    Symbol** bucket = &((Symbol**)table->current_scope->symbols)[hash];
+    if (!slot->name) {
+        slot->name = symbol->name;
+        table->slot_count++;
+    }
     
+    // Shadow any outer declaration and record the symbol in its scope
     symbol->scope_level = table->current_scope->level;
-    symbol->next = *bucket;
-    *bucket = symbol;
+    symbol->next = slot->symbol;
+    slot->symbol = symbol;
+    
+    symbol->scope_next = table->current_scope->symbols;
+    table->current_scope->symbols = symbol;
     
     return true;
 }
 
+// Find the innermost visible declaration of name
+static Symbol* symbol_table_find(SymbolTable* table, const char* name) {
+    // A name that was never interned cannot have been declared
+    const char* interned = intern_lookup(name);
+    if (!interned) return NULL;
+    
+    return symbol_table_find_slot(table, interned)->symbol;
+}
+
 // Lookup symbol in current scope only
 Symbol* symbol_table_lookup_current_scope(SymbolTable* table, const char* name) {
     if (!table || !name || !table->current_scope) return NULL;
     
-    unsigned int hash = hash_symbol_name(name);
-    Symbol* symbol = ((Symbol**)table->current_scope->symbols)[hash];
-    
-    while (symbol) {
-        if (strcmp(symbol->name, name) == 0) {
-            return symbol;
-        }
-        symbol = symbol->next;
+    Symbol* symbol = symbol_table_find(table, name);
+    if (symbol && symbol->scope_level == table->current_scope->level) {
+        return symbol;
     }
     
     return NULL;
@@ -185,23 +257,14 @@ Symbol* symbol_table_lookup_current_scope(SymbolTable* table, const char* name)
 Symbol* symbol_table_lookup(SymbolTable* table, const char* name) {
     if (!table || !name) return NULL;
     
-    Scope* scope = table->current_scope;
-    while (scope) {
-        unsigned int hash = hash_symbol_name(name);
-        Symbol* symbol = ((Symbol**)scope->symbols)[hash];
-        
-        while (symbol) {
-            if (strcmp(symbol->name, name) == 0) {
-                symbol->is_used = true; // Mark as used
-                return symbol;
-            }
-            symbol = symbol->next;
-        }
-        
-        scope = scope->parent;
+    Symbol* symbol = symbol_table_find(table, name);
+    if (symbol) {
+        symbol->is_used = true; // Mark as used
+        return symbol;
     }
     
-    return NULL;
+    // Symbols of a base table are shared by other layers and left unmarked
+    return table->base ? symbol_table_find(table->base, name) : NULL;
 }
 
 // Check if currently in function scope
@@ -261,18 +324,14 @@ void symbol_table_print(SymbolTable* table) {
                scope_num++, scope->level, 
                scope->is_function_scope ? "function" : "block");
         
-        for (int i = 0; i < SYMBOL_HASH_SIZE; i++) {
-            Symbol* symbol = ((Symbol**)scope->symbols)[i];
-            while (symbol) {
-                printf("  %s: %s", symbol->name, symbol_type_to_string(symbol->type));
-                if (symbol->type_node && symbol->type_node->value) {
-                    printf(" (%s)", symbol->type_node->value);
-                }
-                if (symbol->is_initialized) printf(" [initialized]");
-                if (symbol->is_used) printf(" [used]");
-                printf("\n");
-                symbol = symbol->next;
+        for (Symbol* symbol = scope->symbols; symbol; symbol = symbol->scope_next) {
+            printf("  %s: %s", symbol->name, symbol_type_to_string(symbol->type));
+            if (symbol->type_node && symbol->type_node->value) {
+                printf(" (%s)", symbol->type_node->value);
             }
+            if (symbol->is_initialized) printf(" [initialized]");
+            if (symbol->is_used) printf(" [used]");
+            printf("\n");
         }
         
         scope = scope->parent;
@@ -16,7 +16,7 @@ typedef enum {
 
 // Symbol structure
 typedef struct Symbol {
-    char* name;
+    const char* name;          // Interned
     SymbolType type;
     ASTNode* declaration;      // AST node where symbol is declared
     ASTNode* ast_node;         // Alias for declaration (for generics compatibility)
@@ -27,35 +27,54 @@ typedef struct Symbol {
     bool is_used;
     bool is_parameter;
     bool is_builtin;           // True if this is a builtin symbol
-    struct Symbol* next;       // For hash table chaining
+    struct StructLayout* layout; // Field index of a SYMBOL_STRUCT (owned)
+    struct Symbol* next;       // Shadowed declaration of the same name in an outer scope
+    struct Symbol* scope_next; // Next symbol declared in the same scope
 } Symbol;
 
 // Scope structure
 typedef struct Scope {
-    Symbol* symbols;           // Hash table of symbols
+    Symbol* symbols;           // Symbols declared in this scope (newest first)
     struct Scope* parent;      // Parent scope
     int level;                 // Scope nesting level
     bool is_function_scope;    // True if this is a function scope
     ASTNode* function_node;    // Function AST node (if function scope)
-    struct Scope* next;        // For scope stack
+    struct Scope* next;        // Free list of exited scopes (reused by enter_scope)
 } Scope;
 
-// Symbol table structure
+// Slot of the name table: innermost visible declaration of an interned name
+typedef struct SymbolSlot {
+    const char* name;          // Interned; NULL marks an empty slot
+    Symbol* symbol;            // NULL once every declaration went out of scope
+} SymbolSlot;
+
+// Symbol table structure.
+// All scopes share one open-addressing table keyed by interned name; each slot
+// holds the innermost declaration and declarations it shadows hang off
+// Symbol.next. Exiting a scope pops its symbols from their slots, so a lookup
+// is a single probe sequence regardless of nesting depth.
+// A layer (symbol_table_create_layer) has its own scopes over a shared base
+// table: names it does not declare are looked up in the base, which the
+// layer never modifies, so several threads can each use a layer at once.
 typedef struct SymbolTable {
     Scope* current_scope;      // Current active scope
     Scope* global_scope;       // Global scope
     int scope_counter;         // For generating unique scope IDs
+    SymbolSlot* slots;
+    size_t slot_capacity;      // Power of two
+    size_t slot_count;         // Used slots (names ever declared)
+    Scope* free_scopes;        // Recycled scope records
+    struct SymbolTable* base;  // Read-only outer table of a layer (NULL otherwise)
 } SymbolTable;
 
 // Function declarations
 
 // Symbol table management
 SymbolTable* symbol_table_create(void);
+SymbolTable* symbol_table_create_layer(SymbolTable* base);
 void symbol_table_destroy(SymbolTable* table);
 
 // Scope management
-Scope* scope_create(Scope* parent, bool is_function_scope);
-void scope_destroy(Scope* scope);
 void symbol_table_enter_scope(SymbolTable* table, bool is_function_scope);
 void symbol_table_exit_scope(SymbolTable* table);
 
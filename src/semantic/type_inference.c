@@ -1,5 +1,8 @@
 #define _GNU_SOURCE
 #include "type_inference.h"
+#include "../utils/string_intern.h"
+#include "../utils/log.h"
+#include "../utils/timing.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -13,6 +16,14 @@ TypeInferenceContext* type_inference_create(void) {
     ctx->constraint_count = 0;
     ctx->constraint_capacity = 0;
     ctx->instantiations = NULL;
+    ctx->instantiation_count = 0;
+    pthread_mutex_init(&ctx->instantiation_lock, NULL);
+    for (int i = 0; i < INSTANTIATION_SHARD_COUNT; i++) {
+        pthread_mutex_init(&ctx->shards[i].lock, NULL);
+        ctx->shards[i].buckets = NULL;
+        ctx->shards[i].bucket_count = 0;
+        ctx->shards[i].count = 0;
+    }
     ctx->current_function = NULL;
     ctx->inference_enabled = true;
     
@@ -23,11 +34,7 @@ TypeInferenceContext* type_inference_create(void) {
 void type_inference_destroy(TypeInferenceContext* ctx) {
     if (!ctx) return;
     
-    // Free constraints
-    for (int i = 0; i < ctx->constraint_count; i++) {
-        free(ctx->constraints[i].variable);
-        free(ctx->constraints[i].inferred_type);
-    }
+    // Free constraints (type names are interned)
     free(ctx->constraints);
     
     // Free instantiations
@@ -35,19 +42,16 @@ void type_inference_destroy(TypeInferenceContext* ctx) {
     while (inst) {
         GenericInstantiation* next = inst->next;
         
-        for (int i = 0; i < inst->type_arg_count; i++) {
-            free(inst->type_arguments[i]);
-        }
+        // instantiated_function is owned by the AST arena
         free(inst->type_arguments);
-        free(inst->mangled_name);
-        
-        if (inst->instantiated_function) {
-            ast_destroy(inst->instantiated_function);
-        }
-        
         free(inst);
         inst = next;
     }
+    pthread_mutex_destroy(&ctx->instantiation_lock);
+    for (int i = 0; i < INSTANTIATION_SHARD_COUNT; i++) {
+        free(ctx->shards[i].buckets);
+        pthread_mutex_destroy(&ctx->shards[i].lock);
+    }
     
     free(ctx);
 }
@@ -57,19 +61,19 @@ void type_inference_add_constraint(TypeInferenceContext* ctx, const char* variab
                                   const char* concrete_type, ASTNode* context) {
     if (!ctx || !variable || !concrete_type) return;
     
+    variable = intern_string(variable);
+    const Type* type = type_parse(concrete_type);
+    if (!type) return;
+    
     // Check if constraint already exists for this variable
     for (int i = 0; i < ctx->constraint_count; i++) {
-        if (strcmp(ctx->constraints[i].variable, variable) == 0) {
-            // Update existing constraint if types are compatible
-            if (type_inference_types_compatible(ctx->constraints[i].inferred_type, concrete_type)) {
-                free(ctx->constraints[i].inferred_type);
-                ctx->constraints[i].inferred_type = strdup(concrete_type);
-                return;
-            } else {
-                printf("Type conflict for variable %s: %s vs %s\n", 
-                       variable, ctx->constraints[i].inferred_type, concrete_type);
-                return;
+        if (ctx->constraints[i].variable == variable) {
+            // Only identical types are compatible for now
+            if (ctx->constraints[i].inferred_type != type) {
+                LOG_WARN(LOG_CAT_INFERENCE, "Type conflict for variable %s: %s vs %s\n", 
+                       variable, ctx->constraints[i].inferred_type->name, type->name);
             }
+            return;
         }
     }
     
@@ -86,11 +90,11 @@ void type_inference_add_constraint(TypeInferenceContext* ctx, const char* variab
     
     // Add new constraint
     TypeConstraint* constraint = &ctx->constraints[ctx->constraint_count++];
-    constraint->variable = strdup(variable);
-    constraint->inferred_type = strdup(concrete_type);
+    constraint->variable = variable;
+    constraint->inferred_type = type;
     constraint->context_node = context;
     
-    printf("✓ Added type constraint: %s -> %s\n", variable, concrete_type);
+    LOG_DEBUG(LOG_CAT_INFERENCE, "✓ Added type constraint: %s -> %s\n", variable, type->name);
 }
 
 // Resolve type variable to concrete type
@@ -102,10 +106,11 @@ const char* type_inference_resolve_type(TypeInferenceContext* ctx, const char* t
         return type_var;
     }
     
-    // Look up in constraints
-    for (int i = 0; i < ctx->constraint_count; i++) {
-        if (strcmp(ctx->constraints[i].variable, type_var) == 0) {
-            return ctx->constraints[i].inferred_type;
+    // Look up in constraints (a never-interned name has no constraint)
+    const char* interned = intern_lookup(type_var);
+    for (int i = 0; interned && i < ctx->constraint_count; i++) {
+        if (ctx->constraints[i].variable == interned) {
+            return ctx->constraints[i].inferred_type->name;
         }
     }
     
@@ -116,12 +121,8 @@ const char* type_inference_resolve_type(TypeInferenceContext* ctx, const char* t
 bool type_inference_is_concrete_type(const char* type_name) {
     if (!type_name) return false;
     
-    // Built-in types
-    if (strcmp(type_name, "i8") == 0 || strcmp(type_name, "i16") == 0 ||
-        strcmp(type_name, "i32") == 0 || strcmp(type_name, "i64") == 0 ||
-        strcmp(type_name, "f32") == 0 || strcmp(type_name, "f64") == 0 ||
-        strcmp(type_name, "bool") == 0 || strcmp(type_name, "string") == 0 ||
-        strcmp(type_name, "char") == 0 || strcmp(type_name, "void") == 0) {
+    // Built-in types (spelled by a type keyword)
+    if (type_has_trait(type_parse(type_name), TYPE_TRAIT_KEYWORD)) {
         return true;
     }
     
@@ -134,8 +135,8 @@ bool type_inference_is_concrete_type(const char* type_name) {
 bool type_inference_types_compatible(const char* type1, const char* type2) {
     if (!type1 || !type2) return false;
     
-    // Exact match
-    if (strcmp(type1, type2) == 0) return true;
+    // Exact match (types are hash-consed, so equal types are the same object)
+    if (type1 == type2 || type_parse(type1) == type_parse(type2)) return true;
     
     // TODO: Add more sophisticated compatibility rules
     // For now, only exact matches are compatible
@@ -143,24 +144,19 @@ bool type_inference_types_compatible(const char* type1, const char* type2) {
     return false;
 }
 
-// Infer type of expression with symbol table access
-char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ctx, ASTNode* expr, struct SymbolTable* symbol_table) {
-    if (!ctx || !expr) return NULL;
-    
+// Infer type of expression with symbol table access (not memoized)
+static const char* infer_expression_type_uncached(TypeInferenceContext* ctx, ASTNode* expr, struct SymbolTable* symbol_table) {
     switch (expr->type) {
         case AST_LITERAL:
-            if (expr->data_type) {
-                return strdup(expr->data_type);
-            }
             // Try to infer from literal value
             if (strstr(expr->value, ".") != NULL) {
-                return strdup("f64"); // Default float type
+                return intern_string("f64"); // Default float type
             } else if (strcmp(expr->value, "true") == 0 || strcmp(expr->value, "false") == 0) {
-                return strdup("bool");
+                return intern_string("bool");
             } else if (expr->value[0] == '"') {
-                return strdup("string");
+                return intern_string("string");
             } else {
-                return strdup("i32"); // Default integer type
+                return intern_string("i32"); // Default integer type
             }
             
         case AST_IDENTIFIER: {
@@ -168,24 +164,32 @@ char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ct
             if (symbol_table) {
                 Symbol* symbol = symbol_table_lookup(symbol_table, expr->value);
                 if (symbol && symbol->type_node && symbol->type_node->value) {
-                    printf("✓ Found variable '%s' with type '%s' in symbol table\n", 
+                    LOG_TRACE(LOG_CAT_INFERENCE, "✓ Found variable '%s' with type '%s' in symbol table\n", 
                            expr->value, symbol->type_node->value);
-                    return strdup(symbol->type_node->value);
+                    return intern_string(symbol->type_node->value);
                 } else {
-                    printf("⚠️ Variable '%s' not found in symbol table or has no type\n", expr->value);
+                    LOG_DEBUG(LOG_CAT_INFERENCE, "⚠️ Variable '%s' not found in symbol table or has no type\n", expr->value);
                 }
             } else {
-                printf("⚠️ No symbol table provided for variable '%s'\n", expr->value);
+                LOG_DEBUG(LOG_CAT_INFERENCE, "⚠️ No symbol table provided for variable '%s'\n", expr->value);
             }
-            return strdup("i32"); // Fallback
+            return intern_string("i32"); // Fallback
         }
         
         case AST_CALL: {
             // Handle function calls - this is crucial for generic functions!
-            if (expr->child_count == 0) return strdup("i32");
+            if (expr->child_count == 0) return intern_string("i32");
             
             ASTNode* callee = expr->children[0];
             if (callee->type == AST_IDENTIFIER) {
+                // Calls resolved by the semantic pass carry their instantiation
+                ASTNode* target = type_inference_call_target(expr);
+                for (int i = 0; target && i < target->child_count; i++) {
+                    if (target->children[i]->type == AST_TYPE && target->children[i]->value) {
+                        return intern_string(target->children[i]->value);
+                    }
+                }
+                
                 // Look for generic instantiation that matches this call
                 GenericInstantiation* inst = ctx->instantiations;
                 while (inst) {
@@ -204,9 +208,9 @@ char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ct
                                 }
                             }
                             if (return_type && return_type->value) {
-                                printf("✓ Found return type '%s' for call to %s\n", 
+                                LOG_TRACE(LOG_CAT_INFERENCE, "✓ Found return type '%s' for call to %s\n", 
                                        return_type->value, inst->mangled_name);
-                                return strdup(return_type->value);
+                                return intern_string(return_type->value);
                             }
                         }
                     }
@@ -215,65 +219,81 @@ char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ct
                 
                 // If no instantiation found, try to infer from original generic function
                 // This is a fallback - in practice, instantiation should happen first
-                return strdup("i32"); // Fallback
+                return intern_string("i32"); // Fallback
             }
-            return strdup("i32");
+            return intern_string("i32");
         }
             
         case AST_STRUCT_LITERAL:
             // For struct literals, the type is the struct name stored in the value
             if (expr->value) {
-                return strdup(expr->value);
+                return intern_string(expr->value);
             }
-            return strdup("unknown_struct");
+            return intern_string("unknown_struct");
             
         case AST_BINARY_OP:
             // For binary operations, infer from operands
-            char* left_type = type_inference_infer_expression_type_with_symbols(ctx, expr->children[0], symbol_table);
-            char* right_type = type_inference_infer_expression_type_with_symbols(ctx, expr->children[1], symbol_table);
+            const char* left_type = type_inference_infer_expression_type_with_symbols(ctx, expr->children[0], symbol_table);
+            const char* right_type = type_inference_infer_expression_type_with_symbols(ctx, expr->children[1], symbol_table);
             
-            if (left_type && right_type && strcmp(left_type, right_type) == 0) {
-                free(right_type);
+            if (left_type && left_type == right_type) {
                 return left_type;
             }
             
-            free(left_type);
-            free(right_type);
-            return strdup("i32"); // Default fallback
+            return intern_string("i32"); // Default fallback
             
         default:
-            return strdup("i32"); // Default fallback
+            return intern_string("i32"); // Default fallback
+    }
+}
+
+// Infer type of expression with symbol table access.
+// The result is stored as the node's type annotation, so every expression is
+// typed once (in its own scope, during semantic analysis) and later queries
+// from semantic analysis or codegen are a side table lookup.
+const char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ctx, ASTNode* expr, struct SymbolTable* symbol_table) {
+    if (!ctx || !expr) return NULL;
+    
+    const char* type = ast_data_type(expr);
+    if (type) return type;
+    
+    type = infer_expression_type_uncached(ctx, expr, symbol_table);
+    if (type) {
+        ast_set_data_type(expr, type);
     }
+    return type;
 }
 
 // Infer type of expression
-char* type_inference_infer_expression_type(TypeInferenceContext* ctx, ASTNode* expr) {
+const char* type_inference_infer_expression_type(TypeInferenceContext* ctx, ASTNode* expr) {
     if (!ctx || !expr) return NULL;
     
+    // Expressions typed during semantic analysis already carry their type
+    if (ast_data_type(expr)) {
+        return ast_data_type(expr);
+    }
+    
     switch (expr->type) {
         case AST_LITERAL:
-            if (expr->data_type) {
-                return strdup(expr->data_type);
-            }
             // Try to infer from literal value
             if (strstr(expr->value, ".") != NULL) {
-                return strdup("f64"); // Default float type
+                return intern_string("f64"); // Default float type
             } else if (strcmp(expr->value, "true") == 0 || strcmp(expr->value, "false") == 0) {
-                return strdup("bool");
+                return intern_string("bool");
             } else if (expr->value[0] == '"') {
-                return strdup("string");
+                return intern_string("string");
             } else {
-                return strdup("i32"); // Default integer type
+                return intern_string("i32"); // Default integer type
             }
             
         case AST_IDENTIFIER:
             // TODO: Look up variable type in symbol table
             // For now, return placeholder
-            return strdup("i32"); // Placeholder
+            return intern_string("i32"); // Placeholder
             
         case AST_CALL: {
             // Handle function calls - this is crucial for generic functions!
-            if (expr->child_count == 0) return strdup("i32");
+            if (expr->child_count == 0) return intern_string("i32");
             
             ASTNode* callee = expr->children[0];
             if (callee->type == AST_IDENTIFIER) {
@@ -295,7 +315,7 @@ char* type_inference_infer_expression_type(TypeInferenceContext* ctx, ASTNode* e
                                 }
                             }
                             if (return_type && return_type->value) {
-                                return strdup(return_type->value);
+                                return intern_string(return_type->value);
                             }
                         }
                     }
@@ -304,34 +324,31 @@ char* type_inference_infer_expression_type(TypeInferenceContext* ctx, ASTNode* e
                 
                 // If no instantiation found, try to infer from original generic function
                 // This is a fallback - in practice, instantiation should happen first
-                return strdup("i32"); // Fallback
+                return intern_string("i32"); // Fallback
             }
-            return strdup("i32");
+            return intern_string("i32");
         }
             
         case AST_STRUCT_LITERAL:
             // For struct literals, the type is the struct name stored in the value
             if (expr->value) {
-                return strdup(expr->value);
+                return intern_string(expr->value);
             }
-            return strdup("unknown_struct");
+            return intern_string("unknown_struct");
             
         case AST_BINARY_OP:
             // For binary operations, infer from operands
-            char* left_type = type_inference_infer_expression_type(ctx, expr->children[0]);
-            char* right_type = type_inference_infer_expression_type(ctx, expr->children[1]);
+            const char* left_type = type_inference_infer_expression_type(ctx, expr->children[0]);
+            const char* right_type = type_inference_infer_expression_type(ctx, expr->children[1]);
             
-            if (left_type && right_type && strcmp(left_type, right_type) == 0) {
-                free(right_type);
+            if (left_type && left_type == right_type) {
                 return left_type;
             }
             
-            free(left_type);
-            free(right_type);
-            return strdup("i32"); // Default fallback
+            return intern_string("i32"); // Default fallback
             
         default:
-            return strdup("i32"); // Default fallback
+            return intern_string("i32"); // Default fallback
     }
 }
 
@@ -345,7 +362,7 @@ bool type_inference_analyze_function(TypeInferenceContext* ctx, ASTNode* functio
     
     ctx->current_function = function;
     
-    printf("✓ Analyzing generic function: %s\n", function->value);
+    LOG_DEBUG(LOG_CAT_INFERENCE, "✓ Analyzing generic function: %s\n", function->value);
     
     // For generic functions, we collect type parameters but don't instantiate yet
     // Instantiation happens when the function is called
@@ -353,16 +370,188 @@ bool type_inference_analyze_function(TypeInferenceContext* ctx, ASTNode* functio
     return true;
 }
 
+#define INSTANTIATION_INITIAL_BUCKETS 16
+
+// Hash of an instantiation key. Type names are interned, so the tuple of
+// pointers is a canonical key and no string needs to be compared.
+static uint32_t instantiation_hash(const ASTNode* generic_function, const char** type_args, int type_count) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = (hash ^ (uintptr_t)generic_function) * 1099511628211ull;
+    for (int i = 0; i < type_count; i++) {
+        hash = (hash ^ (uintptr_t)type_args[i]) * 1099511628211ull;
+    }
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// Shard of a key; the low hash bits pick the bucket inside the shard
+static InstantiationShard* instantiation_shard(TypeInferenceContext* ctx, uint32_t hash) {
+    return &ctx->shards[(hash >> 24) % INSTANTIATION_SHARD_COUNT];
+}
+
+// Double the bucket array of a shard and rehash its entries (shard locked)
+static bool shard_grow(InstantiationShard* shard) {
+    int new_count = shard->bucket_count ? shard->bucket_count * 2 : INSTANTIATION_INITIAL_BUCKETS;
+    GenericInstantiation** buckets = calloc(new_count, sizeof(GenericInstantiation*));
+    if (!buckets) return false;
+    
+    for (int i = 0; i < shard->bucket_count; i++) {
+        GenericInstantiation* inst = shard->buckets[i];
+        while (inst) {
+            GenericInstantiation* next = inst->bucket_next;
+            GenericInstantiation** bucket = &buckets[inst->key_hash & (new_count - 1)];
+            inst->bucket_next = *bucket;
+            *bucket = inst;
+            inst = next;
+        }
+    }
+    
+    free(shard->buckets);
+    shard->buckets = buckets;
+    shard->bucket_count = new_count;
+    return true;
+}
+
+// Find an instantiation in a shard (shard locked, type_args interned)
+static GenericInstantiation* shard_find(InstantiationShard* shard, uint32_t hash, ASTNode* generic_function,
+                                        const char** type_args, int type_count) {
+    if (shard->bucket_count == 0) return NULL;
+    
+    GenericInstantiation* inst = shard->buckets[hash & (shard->bucket_count - 1)];
+    for (; inst; inst = inst->bucket_next) {
+        if (inst->key_hash != hash || inst->original_function != generic_function ||
+            inst->type_arg_count != type_count) {
+            continue;
+        }
+        
+        // Both sides are interned
+        bool match = true;
+        for (int i = 0; i < type_count; i++) {
+            if (inst->type_arguments[i] != type_args[i]) {
+                match = false;
+                break;
+            }
+        }
+        
+        if (match) {
+            return inst;
+        }
+    }
+    
+    return NULL;
+}
+
+// Build an instantiation and its concrete function node (not yet cached)
+static GenericInstantiation* instantiation_create(ASTNode* generic_function, const char** type_args, int type_count) {
+    GenericInstantiation* inst = malloc(sizeof(GenericInstantiation));
+    if (!inst) return NULL;
+    
+    inst->original_function = generic_function;
+    inst->type_arg_count = type_count;
+    inst->type_arguments = malloc(type_count * sizeof(const char*));
+    
+    if (!inst->type_arguments) {
+        free(inst);
+        return NULL;
+    }
+    
+    for (int i = 0; i < type_count; i++) {
+        inst->type_arguments[i] = intern_string(type_args[i]);
+    }
+    inst->key_hash = instantiation_hash(generic_function, inst->type_arguments, type_count);
+    inst->first_use = UINT64_MAX;
+    inst->next = NULL;
+    inst->bucket_next = NULL;
+    
+    inst->mangled_name = type_inference_mangle_name(generic_function->value, 
+                                                   type_args, type_count);
+    
+    // Create proper instantiated function AST with correct return type
+    inst->instantiated_function = ast_create_node(AST_FUNCTION, inst->mangled_name);
+    
+    // Find return type from original function
+    ASTNode* original_return_type = NULL;
+    for (int i = 0; i < generic_function->child_count; i++) {
+        if (generic_function->children[i]->type == AST_TYPE || 
+            generic_function->children[i]->type == AST_AUTO_TYPE) {
+            original_return_type = generic_function->children[i];
+            break;
+        }
+    }
+    
+    // Create concrete return type
+    if (original_return_type) {
+        ASTNode* concrete_return_type = NULL;
+        
+        if (original_return_type->type == AST_AUTO_TYPE) {
+            // For auto return type, infer from the first parameter type
+            // This is a simple heuristic - in practice, we'd need more sophisticated analysis
+            if (type_count > 0) {
+                concrete_return_type = ast_create_node(AST_TYPE, type_args[0]);
+            } else {
+                concrete_return_type = ast_create_node(AST_TYPE, "i32");
+            }
+        } else {
+            // Copy concrete return type
+            concrete_return_type = ast_create_node(AST_TYPE, original_return_type->value);
+        }
+        
+        if (concrete_return_type) {
+            ast_add_child(inst->instantiated_function, concrete_return_type);
+        }
+    }
+    
+    if (log_enabled(LOG_CAT_INFERENCE, LOG_LEVEL_DEBUG)) {
+        char types[256] = "";
+        int length = 0;
+        for (int i = 0; i < type_count && length < (int)sizeof(types); i++) {
+            length += snprintf(types + length, sizeof(types) - length, "%s%s", i > 0 ? ", " : "", type_args[i]);
+        }
+        
+        // Print return type info
+        const char* returns = NULL;
+        if (inst->instantiated_function->child_count > 0) {
+            ASTNode* ret_type = inst->instantiated_function->children[0];
+            if (ret_type && ret_type->value) returns = ret_type->value;
+        }
+        
+        log_write(LOG_CAT_INFERENCE, LOG_LEVEL_DEBUG, "✓ Instantiated %s with types: %s -> %s%s%s%s\n",
+                  generic_function->value, types, inst->mangled_name,
+                  returns ? " (returns " : "", returns ? returns : "", returns ? ")" : "");
+    }
+    
+    return inst;
+}
+
+// Add an instantiation to the list and to its shard (shard locked), keeping
+// the shard at a load factor of at most 3/4
+static void instantiation_add(TypeInferenceContext* ctx, InstantiationShard* shard, GenericInstantiation* inst) {
+    pthread_mutex_lock(&ctx->instantiation_lock);
+    inst->next = ctx->instantiations;
+    ctx->instantiations = inst;
+    ctx->instantiation_count++;
+    pthread_mutex_unlock(&ctx->instantiation_lock);
+    
+    shard->count++;
+    if (shard->count * 4 > shard->bucket_count * 3) {
+        shard_grow(shard);
+    }
+    if (shard->bucket_count > 0) {
+        GenericInstantiation** bucket = &shard->buckets[inst->key_hash & (shard->bucket_count - 1)];
+        inst->bucket_next = *bucket;
+        *bucket = inst;
+    }
+}
+
 // Infer types for function call and potentially instantiate generic
-bool type_inference_infer_call(TypeInferenceContext* ctx, ASTNode* call_node, 
-                              ASTNode* target_function, struct SymbolTable* symbol_table) {
+bool type_inference_infer_call(TypeInferenceContext* ctx, ASTNode* call_node, ASTNode* target_function,
+                               struct SymbolTable* symbol_table, uint64_t call_order) {
     if (!ctx || !call_node || !target_function) return false;
     
     if (target_function->type != AST_GENERIC_FUNCTION) {
         return true; // Not a generic function call
     }
     
-    printf("✓ Inferring types for call to generic function: %s\n", target_function->value);
+    LOG_DEBUG(LOG_CAT_INFERENCE, "✓ Inferring types for call to generic function: %s\n", target_function->value);
     
     // Get function parameters (first child after function name)
     ASTNode* params = NULL;
@@ -378,79 +567,85 @@ bool type_inference_infer_call(TypeInferenceContext* ctx, ASTNode* call_node,
     // Collect type arguments from call arguments
     int arg_count = call_node->child_count - 1; // First child is function name
     if (arg_count != params->child_count) {
-        printf("Argument count mismatch in generic call\n");
+        LOG_WARN(LOG_CAT_INFERENCE, "Argument count mismatch in generic call\n");
         return false;
     }
     
-    char** type_args = malloc(arg_count * sizeof(char*));
+    const char** type_args = malloc(arg_count * sizeof(const char*));
     if (!type_args) return false;
     
     for (int i = 0; i < arg_count; i++) {
         ASTNode* arg = call_node->children[i + 1];
         type_args[i] = type_inference_infer_expression_type_with_symbols(ctx, arg, symbol_table);
         if (!type_args[i]) {
-            // Free allocated types on error
-            for (int j = 0; j < i; j++) {
-                free(type_args[j]);
-            }
             free(type_args);
             return false;
         }
     }
     
-    // Find or create instantiation
-    GenericInstantiation* inst = type_inference_find_instantiation(ctx, target_function, 
-                                                                   type_args, arg_count);
+    // Find or create instantiation; the shard stays locked in between so
+    // two threads never instantiate the same key
+    uint32_t hash = instantiation_hash(target_function, type_args, arg_count);
+    InstantiationShard* shard = instantiation_shard(ctx, hash);
+    pthread_mutex_lock(&shard->lock);
+    
+    GenericInstantiation* inst = shard_find(shard, hash, target_function, type_args, arg_count);
     if (!inst) {
-        // Create new instantiation
-        ASTNode* instantiated = type_inference_instantiate_generic(ctx, target_function, 
-                                                                  type_args, arg_count);
-        if (instantiated) {
-            printf("✓ Created new instantiation: %s\n", instantiated->value);
+        int phase = timing_begin("generic instantiation");
+        inst = instantiation_create(target_function, type_args, arg_count);
+        if (inst) {
+            instantiation_add(ctx, shard, inst);
+        }
+        timing_end(phase);
+        if (inst) {
+            LOG_DEBUG(LOG_CAT_INFERENCE, "✓ Created new instantiation: %s\n", inst->mangled_name);
         }
     }
+    if (inst && call_order < inst->first_use) {
+        inst->first_use = call_order;
+    }
     
-    // Free type arguments
-    for (int i = 0; i < arg_count; i++) {
-        free(type_args[i]);
+    pthread_mutex_unlock(&shard->lock);
+    ASTNode* instantiated = inst ? inst->instantiated_function : NULL;
+    
+    // Remember the resolution so later passes do not search again
+    if (instantiated) {
+        ASTGenericInfo* info = ast_generic_info_create(call_node);
+        if (info) {
+            info->generic_template = instantiated;
+            info->instantiation_key = instantiated->value;
+        }
     }
+    
     free(type_args);
     
     return true;
 }
 
-// Find existing instantiation
+// Find existing instantiation (type_args must be interned)
 GenericInstantiation* type_inference_find_instantiation(TypeInferenceContext* ctx, 
                                                        ASTNode* generic_function,
-                                                       char** type_args, int type_count) {
+                                                       const char** type_args, int type_count) {
     if (!ctx) return NULL;
     
-    GenericInstantiation* inst = ctx->instantiations;
-    while (inst) {
-        if (inst->original_function == generic_function && 
-            inst->type_arg_count == type_count) {
-            
-            // Check if type arguments match
-            bool match = true;
-            for (int i = 0; i < type_count; i++) {
-                if (strcmp(inst->type_arguments[i], type_args[i]) != 0) {
-                    match = false;
-                    break;
-                }
-            }
-            
-            if (match) {
-                return inst;
-            }
-        }
-        inst = inst->next;
-    }
+    uint32_t hash = instantiation_hash(generic_function, type_args, type_count);
+    InstantiationShard* shard = instantiation_shard(ctx, hash);
     
-    return NULL;
+    pthread_mutex_lock(&shard->lock);
+    GenericInstantiation* inst = shard_find(shard, hash, generic_function, type_args, type_count);
+    pthread_mutex_unlock(&shard->lock);
+    
+    return inst;
+}
+
+// Instantiated function recorded on a generic call
+ASTNode* type_inference_call_target(const ASTNode* call_node) {
+    ASTGenericInfo* info = ast_generic_info(call_node);
+    return info ? info->generic_template : NULL;
 }
 
 // Generate mangled name for instantiation
-char* type_inference_mangle_name(const char* base_name, char** type_args, int type_count) {
+const char* type_inference_mangle_name(const char* base_name, const char** type_args, int type_count) {
     if (!base_name) return NULL;
     
     // Calculate required size
@@ -478,91 +673,57 @@ char* type_inference_mangle_name(const char* base_name, char** type_args, int ty
         }
     }
     
-    return mangled;
+    const char* interned = intern_string(mangled);
+    free(mangled);
+    return interned;
 }
 
 // Instantiate generic function with concrete types
 ASTNode* type_inference_instantiate_generic(TypeInferenceContext* ctx, 
                                            ASTNode* generic_function, 
-                                           char** type_args, int type_count) {
+                                           const char** type_args, int type_count) {
     if (!ctx || !generic_function || !type_args) return NULL;
     
-    // Create new instantiation entry
-    GenericInstantiation* inst = malloc(sizeof(GenericInstantiation));
+    GenericInstantiation* inst = instantiation_create(generic_function, type_args, type_count);
     if (!inst) return NULL;
     
-    inst->original_function = generic_function;
-    inst->type_arg_count = type_count;
-    inst->type_arguments = malloc(type_count * sizeof(char*));
-    
-    if (!inst->type_arguments) {
-        free(inst);
-        return NULL;
-    }
+    InstantiationShard* shard = instantiation_shard(ctx, inst->key_hash);
+    pthread_mutex_lock(&shard->lock);
+    instantiation_add(ctx, shard, inst);
+    pthread_mutex_unlock(&shard->lock);
     
-    for (int i = 0; i < type_count; i++) {
-        inst->type_arguments[i] = strdup(type_args[i]);
-    }
-    
-    inst->mangled_name = type_inference_mangle_name(generic_function->value, 
-                                                   type_args, type_count);
-    
-    // Create proper instantiated function AST with correct return type
-    inst->instantiated_function = ast_create_node(AST_FUNCTION, inst->mangled_name);
-    
-    // Find return type from original function
-    ASTNode* original_return_type = NULL;
-    for (int i = 0; i < generic_function->child_count; i++) {
-        if (generic_function->children[i]->type == AST_TYPE || 
-            generic_function->children[i]->type == AST_AUTO_TYPE) {
-            original_return_type = generic_function->children[i];
-            break;
-        }
-    }
-    
-    // Create concrete return type
-    if (original_return_type) {
-        ASTNode* concrete_return_type = NULL;
-        
-        if (original_return_type->type == AST_AUTO_TYPE) {
-            // For auto return type, infer from the first parameter type
-            // This is a simple heuristic - in practice, we'd need more sophisticated analysis
-            if (type_count > 0) {
-                concrete_return_type = ast_create_node(AST_TYPE, type_args[0]);
-            } else {
-                concrete_return_type = ast_create_node(AST_TYPE, "i32");
-            }
-        } else {
-            // Copy concrete return type
-            concrete_return_type = ast_create_node(AST_TYPE, original_return_type->value);
-        }
-        
-        if (concrete_return_type) {
-            ast_add_child(inst->instantiated_function, concrete_return_type);
-        }
+    return inst->instantiated_function;
+}
+
+// Newest (largest first use) first
+static int instantiation_compare(const void* a, const void* b) {
+    const GenericInstantiation* left = *(const GenericInstantiation* const*)a;
+    const GenericInstantiation* right = *(const GenericInstantiation* const*)b;
+    if (left->first_use != right->first_use) {
+        return left->first_use > right->first_use ? -1 : 1;
     }
+    return 0;
+}
+
+// Sort the list by first use (call orders are unique, so the result does not
+// depend on which thread created an instantiation first)
+void type_inference_order_instantiations(TypeInferenceContext* ctx) {
+    if (!ctx || ctx->instantiation_count < 2) return;
     
-    // Add to instantiation list
-    inst->next = ctx->instantiations;
-    ctx->instantiations = inst;
+    GenericInstantiation** list = malloc(ctx->instantiation_count * sizeof(GenericInstantiation*));
+    if (!list) return;
     
-    printf("✓ Instantiated %s with types: ", generic_function->value);
-    for (int i = 0; i < type_count; i++) {
-        printf("%s", type_args[i]);
-        if (i < type_count - 1) printf(", ");
+    int count = 0;
+    for (GenericInstantiation* inst = ctx->instantiations; inst; inst = inst->next) {
+        list[count++] = inst;
     }
-    printf(" -> %s", inst->mangled_name);
+    qsort(list, count, sizeof(GenericInstantiation*), instantiation_compare);
     
-    // Print return type info
-    if (inst->instantiated_function->child_count > 0) {
-        ASTNode* ret_type = inst->instantiated_function->children[0];
-        if (ret_type && ret_type->value) {
-            printf(" (returns %s)", ret_type->value);
-        }
+    for (int i = 0; i < count; i++) {
+        list[i]->next = i + 1 < count ? list[i + 1] : NULL;
     }
-    printf("\n");
-    
-    return inst->instantiated_function;
+    ctx->instantiations = list[0];
+    free(list);
 }
 
 // Debug: Print type constraints
@@ -571,7 +732,7 @@ void type_inference_print_constraints(TypeInferenceContext* ctx) {
     
     printf("\n=== Type Constraints ===\n");
     for (int i = 0; i < ctx->constraint_count; i++) {
-        printf("%s -> %s\n", ctx->constraints[i].variable, ctx->constraints[i].inferred_type);
+        printf("%s -> %s\n", ctx->constraints[i].variable, ctx->constraints[i].inferred_type->name);
     }
     printf("========================\n\n");
 }
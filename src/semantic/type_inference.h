@@ -3,7 +3,10 @@
 
 #include "../ast/ast.h"
 #include "semantic.h"
+#include "types.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
 
 // Forward declarations
 typedef struct TypeInferenceContext TypeInferenceContext;
@@ -11,27 +14,45 @@ typedef struct GenericInstantiation GenericInstantiation;
 
 // Type constraint for inference
 typedef struct TypeConstraint {
-    char* variable;     // Type variable name (e.g., "T")
-    char* inferred_type; // Inferred concrete type (e.g., "i32")
+    const char* variable;      // Type variable name, interned (e.g., "T")
+    const Type* inferred_type; // Inferred concrete type (e.g., i32)
     ASTNode* context_node; // AST node where constraint was generated
 } TypeConstraint;
 
 // Generic function instantiation
 struct GenericInstantiation {
     ASTNode* original_function;    // Original generic function
-    char** type_arguments;         // Concrete types for each type parameter
+    const char** type_arguments;   // Concrete types for each type parameter (interned)
     int type_arg_count;            // Number of type arguments
     ASTNode* instantiated_function; // Generated concrete function
-    char* mangled_name;            // Unique name for this instantiation
+    const char* mangled_name;      // Unique name for this instantiation (interned)
+    uint32_t key_hash;             // Hash of (original_function, type_arguments)
+    uint64_t first_use;            // Smallest call order that requested it
     GenericInstantiation* next;    // Linked list of instantiations
+    GenericInstantiation* bucket_next; // Next entry in the same cache bucket
 };
 
-// Type inference context
+// One shard of the instantiation cache
+#define INSTANTIATION_SHARD_COUNT 16
+
+typedef struct InstantiationShard {
+    pthread_mutex_t lock;
+    GenericInstantiation** buckets;
+    int bucket_count;                // Power of two (0 until the first instantiation)
+    int count;
+} InstantiationShard;
+
+// Type inference context.
+// Calls may be inferred from several analysis threads at once: the cache of
+// instantiations is split into shards by key hash, each with its own lock.
 struct TypeInferenceContext {
     TypeConstraint* constraints;     // Array of type constraints
     int constraint_count;            // Number of constraints
     int constraint_capacity;         // Capacity of constraints array
-    GenericInstantiation* instantiations; // List of function instantiations
+    GenericInstantiation* instantiations; // List of function instantiations (newest first)
+    int instantiation_count;         // Number of instantiations
+    pthread_mutex_t instantiation_lock; // Guards the list and count
+    InstantiationShard shards[INSTANTIATION_SHARD_COUNT]; // Cache keyed by (function, type tuple)
     ASTNode* current_function;       // Currently analyzed function
     bool inference_enabled;          // Whether type inference is active
 };
@@ -42,10 +63,13 @@ void type_inference_destroy(TypeInferenceContext* ctx);
 
 // Type inference workflow
 bool type_inference_analyze_function(TypeInferenceContext* ctx, ASTNode* function);
-bool type_inference_infer_call(TypeInferenceContext* ctx, ASTNode* call_node, ASTNode* target_function, struct SymbolTable* symbol_table);
+// call_order ranks the call among all calls analyzed (see
+// type_inference_order_instantiations)
+bool type_inference_infer_call(TypeInferenceContext* ctx, ASTNode* call_node, ASTNode* target_function,
+                               struct SymbolTable* symbol_table, uint64_t call_order);
 ASTNode* type_inference_instantiate_generic(TypeInferenceContext* ctx, 
                                            ASTNode* generic_function, 
-                                           char** type_args, int type_count);
+                                           const char** type_args, int type_count);
 
 // Type constraint management
 void type_inference_add_constraint(TypeInferenceContext* ctx, const char* variable, 
@@ -56,12 +80,22 @@ bool type_inference_unify_types(TypeInferenceContext* ctx, const char* type1, co
 // Generic instantiation management
 GenericInstantiation* type_inference_find_instantiation(TypeInferenceContext* ctx, 
                                                        ASTNode* generic_function,
-                                                       char** type_args, int type_count);
-char* type_inference_mangle_name(const char* base_name, char** type_args, int type_count);
+                                                       const char** type_args, int type_count);
+const char* type_inference_mangle_name(const char* base_name, const char** type_args, int type_count);
+
+// Sort the instantiation list as if calls had been inferred one at a time in
+// increasing call order (newest first), whatever order threads created them in
+void type_inference_order_instantiations(TypeInferenceContext* ctx);
+
+// Instantiated function resolved for a generic call by type_inference_infer_call
+// (NULL if the call was not resolved); its value is the mangled name
+ASTNode* type_inference_call_target(const ASTNode* call_node);
 
-// Type analysis utilities
-char* type_inference_infer_expression_type(TypeInferenceContext* ctx, ASTNode* expr);
-char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ctx, ASTNode* expr, struct SymbolTable* symbol_table);
+// Type analysis utilities (returned type names are interned, do not free).
+// The _with_symbols variant memoizes its result as the node's ast_data_type();
+// semantic analysis types every expression it visits this way.
+const char* type_inference_infer_expression_type(TypeInferenceContext* ctx, ASTNode* expr);
+const char* type_inference_infer_expression_type_with_symbols(TypeInferenceContext* ctx, ASTNode* expr, struct SymbolTable* symbol_table);
 bool type_inference_is_concrete_type(const char* type_name);
 bool type_inference_types_compatible(const char* type1, const char* type2);
 
@@ -0,0 +1,450 @@
+#include "types.h"
+#include "../utils/arena.h"
+#include "../utils/string_intern.h"
+#include "../utils/string_builder.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Built-in primitive types
+typedef struct {
+    const char* name;
+    const char* c_name;
+    uint8_t traits;
+    unsigned int size;         // C sizeof (alignment is the same)
+    const char* family;        // Name used for instantiation matching (NULL = itself)
+} PrimitiveInfo;
+
+static const PrimitiveInfo primitive_types[] = {
+    { "i8",      "int8_t",  TYPE_TRAIT_INTEGER | TYPE_TRAIT_SIGNED | TYPE_TRAIT_KEYWORD, 1, NULL },
+    { "i16",     "int16_t", TYPE_TRAIT_INTEGER | TYPE_TRAIT_SIGNED | TYPE_TRAIT_KEYWORD, 2, NULL },
+    { "i32",     "int32_t", TYPE_TRAIT_INTEGER | TYPE_TRAIT_SIGNED | TYPE_TRAIT_KEYWORD, 4, "integer" },
+    { "i64",     "int64_t", TYPE_TRAIT_INTEGER | TYPE_TRAIT_SIGNED | TYPE_TRAIT_KEYWORD, 8, "integer" },
+    { "f32",     "float",   TYPE_TRAIT_FLOATING | TYPE_TRAIT_SIGNED | TYPE_TRAIT_KEYWORD, 4, "float" },
+    { "f64",     "double",  TYPE_TRAIT_FLOATING | TYPE_TRAIT_SIGNED | TYPE_TRAIT_KEYWORD, 8, "float" },
+    { "bool",    "bool",    TYPE_TRAIT_BOOL | TYPE_TRAIT_KEYWORD, 1, NULL },
+    { "string",  "char*",   TYPE_TRAIT_STRING | TYPE_TRAIT_KEYWORD, sizeof(char*), NULL },
+    { "char",    "char",    TYPE_TRAIT_CHAR | TYPE_TRAIT_KEYWORD, 1, NULL },
+    { "void",    "void",    TYPE_TRAIT_VOID | TYPE_TRAIT_KEYWORD, 0, NULL },
+    // Names produced by type inference for untyped literals
+    { "integer", "int",     TYPE_TRAIT_INTEGER | TYPE_TRAIT_SIGNED, sizeof(int), NULL },
+    { "float",   "double",  TYPE_TRAIT_FLOATING | TYPE_TRAIT_SIGNED, 8, NULL }
+};
+
+#define PRIMITIVE_TYPE_COUNT (sizeof(primitive_types) / sizeof(primitive_types[0]))
+
+#define TYPES_INITIAL_BUCKETS 64
+
+// Memoized spelling -> type (open addressing on interned pointers)
+typedef struct {
+    const char* spelling;
+    const Type* type;
+} TypeSpelling;
+
+static Arena* types_arena = NULL;
+static Type** type_buckets = NULL;
+static size_t type_bucket_count = 0;
+static size_t type_count = 0;
+static TypeSpelling* spelling_slots = NULL;
+static size_t spelling_capacity = 0;
+static size_t spelling_count = 0;
+
+// Types are created and parsed on analysis worker threads too
+static pthread_mutex_t types_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const PrimitiveInfo* primitive_find(const char* name) {
+    for (size_t i = 0; i < PRIMITIVE_TYPE_COUNT; i++) {
+        if (strcmp(primitive_types[i].name, name) == 0) return &primitive_types[i];
+    }
+    return NULL;
+}
+
+// Structural hash: components are unique pointers, so mixing their bits suffices
+static unsigned int type_hash(TypeKind kind, const char* name, const Type* base, int size,
+                              const Type** params, int param_count) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = (hash ^ (uint64_t)kind) * 1099511628211ull;
+    hash = (hash ^ (uintptr_t)name) * 1099511628211ull;
+    hash = (hash ^ (uintptr_t)base) * 1099511628211ull;
+    hash = (hash ^ (uint64_t)(unsigned int)size) * 1099511628211ull;
+    for (int i = 0; i < param_count; i++) {
+        hash = (hash ^ (uintptr_t)params[i]) * 1099511628211ull;
+    }
+    return (unsigned int)(hash ^ (hash >> 32));
+}
+
+static bool types_grow(void) {
+    size_t new_count = type_bucket_count ? type_bucket_count * 2 : TYPES_INITIAL_BUCKETS;
+    Type** new_buckets = calloc(new_count, sizeof(Type*));
+    if (!new_buckets) return false;
+    
+    for (size_t i = 0; i < type_bucket_count; i++) {
+        Type* type = type_buckets[i];
+        while (type) {
+            Type* next = type->next;
+            size_t slot = type->hash & (new_count - 1);
+            type->next = new_buckets[slot];
+            new_buckets[slot] = type;
+            type = next;
+        }
+    }
+    
+    free(type_buckets);
+    type_buckets = new_buckets;
+    type_bucket_count = new_count;
+    return true;
+}
+
+// Canonical spelling and C spelling of a composite type
+static void type_set_names(Type* type) {
+    StringBuilder name;
+    StringBuilder c_name;
+    string_builder_init(&name);
+    string_builder_init(&c_name);
+    
+    switch (type->kind) {
+        case TYPE_POINTER:
+            string_builder_appendf(&name, "%s*", type->base->name);
+            string_builder_appendf(&c_name, "%s*", type->base->c_name);
+            break;
+        case TYPE_OPTIONAL:
+            // Runtime optionals are named after the Echo type (echo_optional_i32)
+            string_builder_appendf(&name, "%s?", type->base->name);
+            string_builder_appendf(&c_name, "echo_optional_%s", type->base->name);
+            break;
+        case TYPE_ARRAY:
+            string_builder_appendf(&name, "%s[", type->base->name);
+            if (type->array_size >= 0) string_builder_append_int(&name, type->array_size);
+            string_builder_append_char(&name, ']');
+            // The size belongs to the declarator; as a prefix the array decays
+            string_builder_appendf(&c_name, "%s*", type->base->c_name);
+            break;
+        case TYPE_FUNCTION:
+            string_builder_append(&name, "fn(");
+            for (int i = 0; i < type->param_count; i++) {
+                string_builder_appendf(&name, "%s%s", i > 0 ? ", " : "", type->params[i]->name);
+            }
+            string_builder_appendf(&name, ") -> %s", type->base->name);
+            string_builder_append(&c_name, "void*");
+            break;
+        case TYPE_UNIQUE_PTR:
+            string_builder_appendf(&name, "unique<%s>", type->base->name);
+            string_builder_append(&c_name, "echo_unique_ptr*");
+            break;
+        case TYPE_SHARED_PTR:
+            string_builder_appendf(&name, "shared<%s>", type->base->name);
+            string_builder_append(&c_name, "echo_shared_ptr*");
+            break;
+        default:
+            break;
+    }
+    
+    type->name = name.data ? intern_string(name.data) : NULL;
+    type->c_name = c_name.data ? intern_string(c_name.data) : NULL;
+    string_builder_free(&name);
+    string_builder_free(&c_name);
+}
+
+// Find the unique type with these components, creating it on first use
+// (types_lock held)
+static const Type* type_get_locked(TypeKind kind, const char* name, const Type* base, int size,
+                                   const Type** params, int param_count) {
+    unsigned int hash = type_hash(kind, name, base, size, params, param_count);
+    
+    if (type_bucket_count > 0) {
+        for (Type* type = type_buckets[hash & (type_bucket_count - 1)]; type; type = type->next) {
+            if (type->hash != hash || type->kind != kind || type->base != base ||
+                type->array_size != size || type->param_count != param_count) {
+                continue;
+            }
+            if ((kind == TYPE_PRIMITIVE || kind == TYPE_STRUCT) && type->name != name) continue;
+            if (param_count > 0 && memcmp(type->params, params, param_count * sizeof(Type*)) != 0) continue;
+            return type;
+        }
+    }
+    
+    if (!types_arena) {
+        types_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+        if (!types_arena) return NULL;
+    }
+    if (type_count >= type_bucket_count && !types_grow()) return NULL;
+    
+    Type* type = arena_calloc(types_arena, 1, sizeof(Type));
+    if (!type) return NULL;
+    
+    type->kind = kind;
+    type->base = base;
+    type->array_size = size;
+    type->param_count = param_count;
+    type->hash = hash;
+    type->family = type;
+    
+    if (param_count > 0) {
+        const Type** copy = arena_alloc(types_arena, param_count * sizeof(Type*));
+        if (!copy) return NULL;
+        memcpy(copy, params, param_count * sizeof(Type*));
+        type->params = copy;
+    }
+    
+    if (kind == TYPE_PRIMITIVE || kind == TYPE_STRUCT) {
+        type->name = name;
+        type->c_name = name;
+    } else {
+        type_set_names(type);
+    }
+    
+    size_t slot = hash & (type_bucket_count - 1);
+    type->next = type_buckets[slot];
+    type_buckets[slot] = type;
+    type_count++;
+    
+    if (kind == TYPE_PRIMITIVE) {
+        const PrimitiveInfo* info = primitive_find(name);
+        type->traits = info->traits;
+        type->size = info->size;
+        type->c_name = intern_string(info->c_name);
+        if (info->family) {
+            type->family = type_get_locked(TYPE_PRIMITIVE, intern_string(info->family), NULL, -1, NULL, 0);
+        }
+    }
+    
+    return type;
+}
+
+static const Type* type_get(TypeKind kind, const char* name, const Type* base, int size,
+                            const Type** params, int param_count) {
+    pthread_mutex_lock(&types_lock);
+    const Type* type = type_get_locked(kind, name, base, size, params, param_count);
+    pthread_mutex_unlock(&types_lock);
+    return type;
+}
+
+// Built-in type by name (NULL if the name is not a primitive)
+const Type* type_primitive(const char* name) {
+    if (!name || !primitive_find(name)) return NULL;
+    return type_get(TYPE_PRIMITIVE, intern_string(name), NULL, -1, NULL, 0);
+}
+
+// Named user type
+const Type* type_struct(const char* name) {
+    if (!name) return NULL;
+    return type_get(TYPE_STRUCT, intern_string(name), NULL, -1, NULL, 0);
+}
+
+const Type* type_pointer(const Type* base) {
+    return base ? type_get(TYPE_POINTER, NULL, base, -1, NULL, 0) : NULL;
+}
+
+const Type* type_optional(const Type* base) {
+    return base ? type_get(TYPE_OPTIONAL, NULL, base, -1, NULL, 0) : NULL;
+}
+
+const Type* type_array(const Type* base, int size) {
+    return base ? type_get(TYPE_ARRAY, NULL, base, size < 0 ? -1 : size, NULL, 0) : NULL;
+}
+
+const Type* type_function(const Type* return_type, const Type** params, int param_count) {
+    if (!return_type || param_count < 0 || (param_count > 0 && !params)) return NULL;
+    for (int i = 0; i < param_count; i++) {
+        if (!params[i]) return NULL;
+    }
+    return type_get(TYPE_FUNCTION, NULL, return_type, -1, params, param_count);
+}
+
+const Type* type_unique_ptr(const Type* base) {
+    return base ? type_get(TYPE_UNIQUE_PTR, NULL, base, -1, NULL, 0) : NULL;
+}
+
+const Type* type_shared_ptr(const Type* base) {
+    return base ? type_get(TYPE_SHARED_PTR, NULL, base, -1, NULL, 0) : NULL;
+}
+
+// ================== SPELLING PARSER ==================
+
+static bool spelling_starts_with(const char* text, size_t length, const char* prefix) {
+    size_t prefix_length = strlen(prefix);
+    return length >= prefix_length && memcmp(text, prefix, prefix_length) == 0;
+}
+
+// Index of the bracket closing text[open], or length if unbalanced
+static size_t spelling_match(const char* text, size_t length, size_t open) {
+    int depth = 0;
+    for (size_t i = open; i < length; i++) {
+        if (text[i] == '-' && i + 1 < length && text[i + 1] == '>') {
+            i++;
+        } else if (text[i] == '(' || text[i] == '<' || text[i] == '[') {
+            depth++;
+        } else if (text[i] == ')' || text[i] == '>' || text[i] == ']') {
+            if (--depth == 0) return i;
+        }
+    }
+    return length;
+}
+
+static const Type* parse_spelling(const char* text, size_t length) {
+    while (length > 0 && (*text == ' ' || *text == '\t')) {
+        text++;
+        length--;
+    }
+    while (length > 0 && (text[length - 1] == ' ' || text[length - 1] == '\t')) {
+        length--;
+    }
+    if (length == 0) return NULL;
+    
+    // fn(A, B) -> R
+    if (spelling_starts_with(text, length, "fn(")) {
+        size_t close = spelling_match(text, length, 2);
+        if (close == length) return NULL;
+        
+        const Type* params[32];
+        int param_count = 0;
+        size_t start = 3;
+        int depth = 0;
+        for (size_t i = 3; i <= close; i++) {
+            if (i < close && text[i] == '-' && i + 1 < close && text[i + 1] == '>') {
+                i++;
+            } else if (i < close && (text[i] == '(' || text[i] == '<' || text[i] == '[')) {
+                depth++;
+            } else if (i < close && (text[i] == ')' || text[i] == '>' || text[i] == ']')) {
+                depth--;
+            } else if (i == close || (depth == 0 && text[i] == ',')) {
+                if (i == close && param_count == 0 && i == start) break;  // fn()
+                if (param_count >= 32) return NULL;
+                params[param_count] = parse_spelling(text + start, i - start);
+                if (!params[param_count++]) return NULL;
+                start = i + 1;
+            }
+        }
+        
+        const char* rest = text + close + 1;
+        size_t rest_length = length - close - 1;
+        while (rest_length > 0 && *rest == ' ') {
+            rest++;
+            rest_length--;
+        }
+        const Type* return_type = spelling_starts_with(rest, rest_length, "->")
+            ? parse_spelling(rest + 2, rest_length - 2)
+            : type_primitive("void");
+        return type_function(return_type, params, param_count);
+    }
+    
+    char last = text[length - 1];
+    if (last == '?') return type_optional(parse_spelling(text, length - 1));
+    if (last == '*') return type_pointer(parse_spelling(text, length - 1));
+    
+    if (last == ']') {
+        size_t open = length - 1;
+        while (open > 0 && text[open] != '[') open--;
+        if (text[open] != '[') return NULL;
+        
+        int size = -1;
+        if (open + 1 < length - 1) {
+            size = 0;
+            for (size_t i = open + 1; i < length - 1; i++) {
+                if (text[i] < '0' || text[i] > '9') return NULL;
+                size = size * 10 + (text[i] - '0');
+            }
+        }
+        return type_array(parse_spelling(text, open), size);
+    }
+    
+    if (last == '>') {
+        if (spelling_starts_with(text, length, "unique<")) {
+            return type_unique_ptr(parse_spelling(text + 7, length - 8));
+        }
+        if (spelling_starts_with(text, length, "shared<")) {
+            return type_shared_ptr(parse_spelling(text + 7, length - 8));
+        }
+    }
+    
+    const char* name = intern_string_n(text, length);
+    const Type* primitive = type_primitive(name);
+    return primitive ? primitive : type_struct(name);
+}
+
+static bool spellings_grow(void) {
+    size_t new_capacity = spelling_capacity ? spelling_capacity * 2 : TYPES_INITIAL_BUCKETS;
+    TypeSpelling* new_slots = calloc(new_capacity, sizeof(TypeSpelling));
+    if (!new_slots) return false;
+    
+    for (size_t i = 0; i < spelling_capacity; i++) {
+        if (!spelling_slots[i].spelling) continue;
+        size_t slot = intern_hash(spelling_slots[i].spelling) & (new_capacity - 1);
+        while (new_slots[slot].spelling) slot = (slot + 1) & (new_capacity - 1);
+        new_slots[slot] = spelling_slots[i];
+    }
+    
+    free(spelling_slots);
+    spelling_slots = new_slots;
+    spelling_capacity = new_capacity;
+    return true;
+}
+
+// Memoized type of an interned spelling (types_lock held)
+static const Type* spelling_find(const char* interned) {
+    if (spelling_capacity == 0) return NULL;
+    
+    size_t slot = intern_hash(interned) & (spelling_capacity - 1);
+    while (spelling_slots[slot].spelling) {
+        if (spelling_slots[slot].spelling == interned) return spelling_slots[slot].type;
+        slot = (slot + 1) & (spelling_capacity - 1);
+    }
+    return NULL;
+}
+
+// Memoize a spelling that is not in the table yet (types_lock held)
+static void spelling_insert(const char* interned, const Type* type) {
+    // Keep the load factor at most 1/2
+    if ((spelling_count + 1) * 2 > spelling_capacity && !spellings_grow()) return;
+    
+    size_t slot = intern_hash(interned) & (spelling_capacity - 1);
+    while (spelling_slots[slot].spelling) slot = (slot + 1) & (spelling_capacity - 1);
+    
+    spelling_slots[slot].spelling = interned;
+    spelling_slots[slot].type = type;
+    spelling_count++;
+}
+
+// Type for a spelling, parsed on first use
+const Type* type_parse(const char* spelling) {
+    if (!spelling) return NULL;
+    
+    const char* interned = intern_string(spelling);
+    if (!interned) return NULL;
+    
+    pthread_mutex_lock(&types_lock);
+    const Type* type = spelling_find(interned);
+    pthread_mutex_unlock(&types_lock);
+    if (type) return type;
+    
+    // Parse without the lock (the constructors take it); another thread may
+    // memoize the same spelling meanwhile, and both get the same type
+    type = parse_spelling(interned, intern_length(interned));
+    if (!type) return NULL;
+    
+    pthread_mutex_lock(&types_lock);
+    if (!spelling_find(interned)) {
+        spelling_insert(interned, type);
+    }
+    pthread_mutex_unlock(&types_lock);
+    return type;
+}
+
+// Number of distinct types
+size_t types_count(void) {
+    return type_count;
+}
+
+// Release all types and spellings
+void types_clear(void) {
+    arena_destroy(types_arena);
+    types_arena = NULL;
+    free(type_buckets);
+    type_buckets = NULL;
+    type_bucket_count = 0;
+    type_count = 0;
+    free(spelling_slots);
+    spelling_slots = NULL;
+    spelling_capacity = 0;
+    spelling_count = 0;
+}
@@ -0,0 +1,81 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Structured, hash-consed types.
+// Every distinct type exists exactly once, so two types are equal iff their
+// pointers are equal. Types are immutable and stay valid until types_clear().
+// Type spellings ("i32*", "Node?", "f64[4]", "unique<Node>",
+// "fn(i32, i32) -> bool") are parsed once and memoized by interned string.
+// Constructors and type_parse are thread-safe; types_clear() is not.
+
+typedef enum {
+    TYPE_PRIMITIVE,            // Built-in scalar (i32, f64, bool, string, ...)
+    TYPE_STRUCT,               // Named user type (struct or type variable)
+    TYPE_POINTER,              // base*
+    TYPE_OPTIONAL,             // base?
+    TYPE_ARRAY,                // base[size], size -1 when unsized
+    TYPE_FUNCTION,             // fn(params) -> base
+    TYPE_UNIQUE_PTR,           // unique<base>
+    TYPE_SHARED_PTR            // shared<base>
+} TypeKind;
+
+// Properties of primitive types
+#define TYPE_TRAIT_INTEGER   0x01
+#define TYPE_TRAIT_FLOATING  0x02
+#define TYPE_TRAIT_SIGNED    0x04
+#define TYPE_TRAIT_BOOL      0x08
+#define TYPE_TRAIT_STRING    0x10
+#define TYPE_TRAIT_CHAR      0x20
+#define TYPE_TRAIT_VOID      0x40
+#define TYPE_TRAIT_KEYWORD   0x80  // Spelled by a type keyword (not "integer"/"float")
+
+typedef struct Type Type;
+
+struct Type {
+    TypeKind kind;
+    uint8_t traits;            // TYPE_TRAIT_* (primitives only)
+    unsigned int size;         // C sizeof of a primitive (alignment is the same), 0 otherwise
+    int array_size;            // TYPE_ARRAY element count (-1 if unsized)
+    int param_count;           // TYPE_FUNCTION parameter count
+    const char* name;          // Canonical spelling (interned)
+    const char* c_name;        // C spelling usable as a declaration prefix (interned)
+    const Type* base;          // Pointee, element, wrapped or return type
+    const Type** params;       // TYPE_FUNCTION parameter types
+    const Type* family;        // Type used when matching instantiations (i32 -> integer)
+    unsigned int hash;         // Structural hash
+    Type* next;                // Bucket chain
+};
+
+// Constructors (return the unique instance, NULL on allocation failure)
+const Type* type_primitive(const char* name);
+const Type* type_struct(const char* name);
+const Type* type_pointer(const Type* base);
+const Type* type_optional(const Type* base);
+const Type* type_array(const Type* base, int size);
+const Type* type_function(const Type* return_type, const Type** params, int param_count);
+const Type* type_unique_ptr(const Type* base);
+const Type* type_shared_ptr(const Type* base);
+
+// Type for a spelling; names that are not built-in become struct types
+const Type* type_parse(const char* spelling);
+
+// Queries
+static inline bool type_has_trait(const Type* type, uint8_t trait) {
+    return type && (type->traits & trait) != 0;
+}
+static inline bool type_is_numeric(const Type* type) {
+    return type_has_trait(type, TYPE_TRAIT_INTEGER | TYPE_TRAIT_FLOATING);
+}
+static inline bool type_is_kind(const Type* type, TypeKind kind) {
+    return type && type->kind == kind;
+}
+
+// Table management: number of distinct types; release all types and spellings
+size_t types_count(void);
+void types_clear(void);
+
+#endif // TYPES_H
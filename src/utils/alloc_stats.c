@@ -0,0 +1,107 @@
+#define _GNU_SOURCE
+#include "alloc_stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+static size_t stats_allocations = 0;
+static size_t stats_current = 0;
+static size_t stats_peak = 0;
+
+#ifdef ECHO_ALLOC_STATS
+
+#include <malloc.h>
+
+// The real allocator, resolved by the linker for --wrap=<symbol>
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+char* __real_strdup(const char* str);
+
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t count, size_t size);
+void* __wrap_realloc(void* ptr, size_t size);
+void __wrap_free(void* ptr);
+char* __wrap_strdup(const char* str);
+
+// Counters are updated atomically so phases running on worker threads are
+// still accounted for
+static void stats_add(void* ptr) {
+    if (!ptr) return;
+    
+    size_t size = malloc_usable_size(ptr);
+    __atomic_add_fetch(&stats_allocations, 1, __ATOMIC_RELAXED);
+    size_t current = __atomic_add_fetch(&stats_current, size, __ATOMIC_RELAXED);
+    
+    size_t peak = __atomic_load_n(&stats_peak, __ATOMIC_RELAXED);
+    while (current > peak &&
+           !__atomic_compare_exchange_n(&stats_peak, &peak, current, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void stats_remove(void* ptr) {
+    if (!ptr) return;
+    __atomic_sub_fetch(&stats_current, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+}
+
+void* __wrap_malloc(size_t size) {
+    void* ptr = __real_malloc(size);
+    stats_add(ptr);
+    return ptr;
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    void* ptr = __real_calloc(count, size);
+    stats_add(ptr);
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    size_t old_size = ptr ? malloc_usable_size(ptr) : 0;
+    void* new_ptr = __real_realloc(ptr, size);
+    
+    // On failure the old block is untouched
+    if (!new_ptr && size > 0) return NULL;
+    
+    __atomic_sub_fetch(&stats_current, old_size, __ATOMIC_RELAXED);
+    stats_add(new_ptr);
+    return new_ptr;
+}
+
+void __wrap_free(void* ptr) {
+    stats_remove(ptr);
+    __real_free(ptr);
+}
+
+char* __wrap_strdup(const char* str) {
+    char* copy = __real_strdup(str);
+    stats_add(copy);
+    return copy;
+}
+
+bool alloc_stats_available(void) {
+    return true;
+}
+
+#else
+
+bool alloc_stats_available(void) {
+    return false;
+}
+
+#endif // ECHO_ALLOC_STATS
+
+// Snapshot of the counters
+AllocStats alloc_stats_get(void) {
+    AllocStats stats;
+    stats.allocations = __atomic_load_n(&stats_allocations, __ATOMIC_RELAXED);
+    stats.current_bytes = __atomic_load_n(&stats_current, __ATOMIC_RELAXED);
+    stats.peak_bytes = __atomic_load_n(&stats_peak, __ATOMIC_RELAXED);
+    return stats;
+}
+
+// Restart peak tracking from the current usage
+void alloc_stats_reset_peak(void) {
+    __atomic_store_n(&stats_peak, __atomic_load_n(&stats_current, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
@@ -0,0 +1,22 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Heap allocation counters for the compiler's own malloc/calloc/realloc/
+// strdup/free calls. They are collected by link-time wrappers
+// (ld --wrap=malloc ...) that are only compiled with ECHO_ALLOC_STATS;
+// in other builds alloc_stats_available() is false and all counters stay 0.
+
+typedef struct AllocStats {
+    size_t allocations;        // Successful allocation calls
+    size_t current_bytes;      // Bytes currently allocated (usable size)
+    size_t peak_bytes;         // High-water mark of current_bytes since the last reset
+} AllocStats;
+
+bool alloc_stats_available(void);
+AllocStats alloc_stats_get(void);
+void alloc_stats_reset_peak(void);
+
+#endif // ALLOC_STATS_H
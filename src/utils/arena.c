@@ -0,0 +1,163 @@
+#define _GNU_SOURCE
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Every allocation is aligned for any scalar type
+#define ARENA_ALIGNMENT 16
+#define ARENA_ALIGN_UP(n) (((n) + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+struct ArenaChunk {
+    ArenaChunk* next;          // Previously filled chunk
+    size_t size;               // Usable bytes in data
+    size_t used;
+    // Keep data aligned regardless of the header layout
+    union {
+        char data[1];
+        long double align_ld;
+        void* align_ptr;
+        long long align_ll;
+    } payload;
+};
+
+// Allocate a new chunk with at least min_size usable bytes and make it current
+static ArenaChunk* arena_add_chunk(Arena* arena, size_t min_size) {
+    size_t size = arena->chunk_size;
+    if (size < min_size) size = min_size;
+    
+    ArenaChunk* chunk = malloc(offsetof(ArenaChunk, payload) + size);
+    if (!chunk) return NULL;
+    
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->next = arena->head;
+    arena->head = chunk;
+    arena->chunk_count++;
+    
+    return chunk;
+}
+
+// Create arena
+Arena* arena_create(size_t chunk_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) return NULL;
+    
+    arena->head = NULL;
+    arena->chunk_size = chunk_size ? ARENA_ALIGN_UP(chunk_size) : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->chunk_count = 0;
+    arena->bytes_used = 0;
+    arena->last = NULL;
+    
+    return arena;
+}
+
+// Free every chunk but keep the arena itself
+static void arena_free_chunks(Arena* arena) {
+    ArenaChunk* chunk = arena->head;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    
+    arena->head = NULL;
+    arena->chunk_count = 0;
+    arena->bytes_used = 0;
+    arena->last = NULL;
+}
+
+// Destroy arena and everything allocated from it
+void arena_destroy(Arena* arena) {
+    if (!arena) return;
+    
+    arena_free_chunks(arena);
+    free(arena);
+}
+
+// Release all allocations, the arena can be reused afterwards
+void arena_reset(Arena* arena) {
+    if (!arena) return;
+    arena_free_chunks(arena);
+}
+
+// Allocate size bytes (uninitialized)
+void* arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+    
+    size_t aligned = ARENA_ALIGN_UP(size ? size : 1);
+    ArenaChunk* chunk = arena->head;
+    
+    if (!chunk || chunk->size - chunk->used < aligned) {
+        chunk = arena_add_chunk(arena, aligned);
+        if (!chunk) return NULL;
+    }
+    
+    void* ptr = chunk->payload.data + chunk->used;
+    chunk->used += aligned;
+    arena->bytes_used += size;
+    arena->last = ptr;
+    
+    return ptr;
+}
+
+// Allocate zeroed memory for count elements
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    
+    void* ptr = arena_alloc(arena, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+// Grow an allocation; extends in place when ptr is the most recent allocation
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!arena) return NULL;
+    if (!ptr) return arena_alloc(arena, new_size);
+    if (new_size <= old_size) return ptr;
+    
+    ArenaChunk* chunk = arena->head;
+    if (ptr == arena->last && chunk) {
+        size_t offset = (size_t)((char*)ptr - chunk->payload.data);
+        size_t aligned = ARENA_ALIGN_UP(new_size);
+        if (offset + aligned <= chunk->size) {
+            chunk->used = offset + aligned;
+            arena->bytes_used += new_size - old_size;
+            return ptr;
+        }
+    }
+    
+    void* new_ptr = arena_alloc(arena, new_size);
+    if (!new_ptr) return NULL;
+    
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+// Copy length bytes of str into the arena as a NUL-terminated string
+char* arena_strndup(Arena* arena, const char* str, size_t length) {
+    if (!str) return NULL;
+    
+    char* copy = arena_alloc(arena, length + 1);
+    if (!copy) return NULL;
+    
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Bytes handed out to callers
+size_t arena_bytes_used(const Arena* arena) {
+    return arena ? arena->bytes_used : 0;
+}
+
+// Bytes obtained from malloc for chunk payloads
+size_t arena_bytes_reserved(const Arena* arena) {
+    size_t total = 0;
+    if (!arena) return 0;
+    
+    for (ArenaChunk* chunk = arena->head; chunk; chunk = chunk->next) {
+        total += chunk->size;
+    }
+    return total;
+}
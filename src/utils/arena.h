@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator with chunked growth.
+// Allocation is a pointer bump inside the current chunk; individual
+// allocations are never freed, the whole arena is released at once.
+
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena {
+    ArenaChunk* head;          // Current chunk (allocations bump from here)
+    size_t chunk_size;         // Default size of new chunks
+    size_t chunk_count;
+    size_t bytes_used;         // Sum of all allocation sizes
+    void* last;                // Most recent allocation (can grow in place)
+} Arena;
+
+// Arena lifetime
+Arena* arena_create(size_t chunk_size);
+void arena_destroy(Arena* arena);
+void arena_reset(Arena* arena);
+
+// Allocation
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+char* arena_strndup(Arena* arena, const char* str, size_t length);
+
+// Statistics
+size_t arena_bytes_used(const Arena* arena);
+size_t arena_bytes_reserved(const Arena* arena);
+
+#endif // ARENA_H
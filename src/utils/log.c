@@ -0,0 +1,110 @@
+#define _GNU_SOURCE
+#include "log.h"
+#include <stdarg.h>
+#include <string.h>
+
+LogLevel log_levels[LOG_CAT_COUNT] = {
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL
+};
+
+// NULL means stdout (resolved at write time, stdout is not a constant)
+static FILE* log_output = NULL;
+
+static const char* log_category_names[LOG_CAT_COUNT] = {
+    "driver", "lexer", "parser", "semantic", "inference", "codegen"
+};
+
+static const char* log_level_names[] = {
+    "silent", "error", "warn", "info", "debug", "trace"
+};
+
+#define LOG_LEVEL_COUNT ((int)(sizeof(log_level_names) / sizeof(log_level_names[0])))
+
+// Set the level of one category
+void log_set_level(LogCategory category, LogLevel level) {
+    if ((int)category < 0 || (int)category >= LOG_CAT_COUNT) return;
+    log_levels[category] = level;
+}
+
+// Set the level of every category
+void log_set_all_levels(LogLevel level) {
+    for (int i = 0; i < LOG_CAT_COUNT; i++) {
+        log_levels[i] = level;
+    }
+}
+
+// Find a name of the given length in a table, -1 if absent
+static int log_find_name(const char** names, int count, const char* name, size_t length) {
+    for (int i = 0; i < count; i++) {
+        if (strlen(names[i]) == length && strncmp(names[i], name, length) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Apply a comma-separated spec: "debug" sets every category,
+// "semantic=debug,codegen=info" sets individual ones.
+// Returns false if any item names an unknown category or level.
+bool log_configure(const char* spec) {
+    if (!spec) return false;
+    
+    bool ok = true;
+    const char* item = spec;
+    while (*item) {
+        const char* end = strchr(item, ',');
+        size_t length = end ? (size_t)(end - item) : strlen(item);
+        const char* equals = memchr(item, '=', length);
+        
+        if (equals) {
+            size_t name_length = (size_t)(equals - item);
+            int category = log_find_name(log_category_names, LOG_CAT_COUNT, item, name_length);
+            int level = log_find_name(log_level_names, LOG_LEVEL_COUNT, equals + 1, length - name_length - 1);
+            if (category < 0 || level < 0) {
+                ok = false;
+            } else {
+                log_set_level((LogCategory)category, (LogLevel)level);
+            }
+        } else {
+            int level = log_find_name(log_level_names, LOG_LEVEL_COUNT, item, length);
+            if (level < 0) {
+                ok = false;
+            } else {
+                log_set_all_levels((LogLevel)level);
+            }
+        }
+        
+        item = end ? end + 1 : item + length;
+    }
+    
+    return ok;
+}
+
+// Redirect log output (NULL restores stdout)
+void log_set_output(FILE* stream) {
+    log_output = stream;
+}
+
+// Write a message; the caller has already checked the level
+void log_write(LogCategory category, LogLevel level, const char* format, ...) {
+    (void)category;
+    (void)level;
+    
+    va_list args;
+    va_start(args, format);
+    vfprintf(log_output ? log_output : stdout, format, args);
+    va_end(args);
+}
+
+// Name of a category
+const char* log_category_name(LogCategory category) {
+    if ((int)category < 0 || (int)category >= LOG_CAT_COUNT) return "unknown";
+    return log_category_names[category];
+}
+
+// Name of a level
+const char* log_level_name(LogLevel level) {
+    if ((int)level < 0 || (int)level >= LOG_LEVEL_COUNT) return "unknown";
+    return log_level_names[level];
+}
@@ -0,0 +1,64 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Levelled logging with per-phase categories.
+// The LOG_* macros test the level before evaluating their arguments, so a
+// disabled message costs one comparison and no formatting.
+// Messages are written verbatim (callers supply the trailing newline).
+
+typedef enum {
+    LOG_LEVEL_SILENT,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_TRACE
+} LogLevel;
+
+typedef enum {
+    LOG_CAT_DRIVER,
+    LOG_CAT_LEXER,
+    LOG_CAT_PARSER,
+    LOG_CAT_SEMANTIC,
+    LOG_CAT_INFERENCE,
+    LOG_CAT_CODEGEN,
+    LOG_CAT_COUNT
+} LogCategory;
+
+// Default level: errors and warnings only
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_WARN
+
+// Highest enabled level per category (read directly by log_enabled)
+extern LogLevel log_levels[LOG_CAT_COUNT];
+
+#define log_enabled(category, level) ((level) <= log_levels[(category)])
+
+#define LOG(category, level, ...) \
+    do { \
+        if (log_enabled(category, level)) log_write((category), (level), __VA_ARGS__); \
+    } while (0)
+
+#define LOG_ERROR(category, ...) LOG(category, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(category, ...)  LOG(category, LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(category, ...)  LOG(category, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG(category, LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_TRACE(category, ...) LOG(category, LOG_LEVEL_TRACE, __VA_ARGS__)
+
+// Configuration
+void log_set_level(LogCategory category, LogLevel level);
+void log_set_all_levels(LogLevel level);
+bool log_configure(const char* spec);
+void log_set_output(FILE* stream);
+
+// Output (use the macros instead of calling this directly)
+void log_write(LogCategory category, LogLevel level, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Names
+const char* log_category_name(LogCategory category);
+const char* log_level_name(LogLevel level);
+
+#endif // LOG_H
@@ -0,0 +1,135 @@
+#define _GNU_SOURCE
+#include "string_builder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STRING_BUILDER_INITIAL_CAPACITY 256
+
+// Initialize an empty builder (no allocation until the first append)
+void string_builder_init(StringBuilder* builder) {
+    if (!builder) return;
+    
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+}
+
+// Release the buffer
+void string_builder_free(StringBuilder* builder) {
+    if (!builder) return;
+    
+    free(builder->data);
+    string_builder_init(builder);
+}
+
+// Drop the contents but keep the buffer for reuse
+void string_builder_clear(StringBuilder* builder) {
+    if (!builder) return;
+    
+    builder->length = 0;
+    if (builder->data) builder->data[0] = '\0';
+}
+
+// Make room for extra more bytes plus the terminator
+bool string_builder_reserve(StringBuilder* builder, size_t extra) {
+    if (!builder) return false;
+    
+    size_t needed = builder->length + extra + 1;
+    if (needed <= builder->capacity) return true;
+    
+    size_t new_capacity = builder->capacity ? builder->capacity : STRING_BUILDER_INITIAL_CAPACITY;
+    while (new_capacity < needed) new_capacity *= 2;
+    
+    char* new_data = realloc(builder->data, new_capacity);
+    if (!new_data) return false;
+    
+    builder->data = new_data;
+    builder->capacity = new_capacity;
+    return true;
+}
+
+// Append length bytes of text
+bool string_builder_append_n(StringBuilder* builder, const char* text, size_t length) {
+    if (!builder || !text) return false;
+    if (!string_builder_reserve(builder, length)) return false;
+    
+    memcpy(builder->data + builder->length, text, length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+    return true;
+}
+
+// Append a NUL-terminated string
+bool string_builder_append(StringBuilder* builder, const char* text) {
+    if (!text) return false;
+    return string_builder_append_n(builder, text, strlen(text));
+}
+
+// Append a single character
+bool string_builder_append_char(StringBuilder* builder, char c) {
+    if (!string_builder_reserve(builder, 1)) return false;
+    
+    builder->data[builder->length++] = c;
+    builder->data[builder->length] = '\0';
+    return true;
+}
+
+// Append a decimal integer without going through printf
+bool string_builder_append_int(StringBuilder* builder, long long value) {
+    char digits[24];
+    size_t count = 0;
+    
+    // Work with the magnitude as unsigned so LLONG_MIN is handled
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    
+    if (!string_builder_reserve(builder, count + 1)) return false;
+    
+    if (value < 0) builder->data[builder->length++] = '-';
+    while (count > 0) {
+        builder->data[builder->length++] = digits[--count];
+    }
+    builder->data[builder->length] = '\0';
+    return true;
+}
+
+// Append printf-formatted text
+bool string_builder_appendv(StringBuilder* builder, const char* format, va_list args) {
+    if (!builder || !format) return false;
+    
+    // Try to format into the space already available
+    va_list retry;
+    va_copy(retry, args);
+    
+    size_t available = builder->capacity > builder->length ? builder->capacity - builder->length : 0;
+    int written = vsnprintf(available ? builder->data + builder->length : NULL, available, format, args);
+    if (written < 0) {
+        va_end(retry);
+        return false;
+    }
+    
+    if ((size_t)written >= available) {
+        if (!string_builder_reserve(builder, (size_t)written)) {
+            va_end(retry);
+            return false;
+        }
+        vsnprintf(builder->data + builder->length, (size_t)written + 1, format, retry);
+    }
+    va_end(retry);
+    
+    builder->length += (size_t)written;
+    return true;
+}
+
+// Variadic form of string_builder_appendv
+bool string_builder_appendf(StringBuilder* builder, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool result = string_builder_appendv(builder, format, args);
+    va_end(args);
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Growable character buffer.
+// The contents are always NUL-terminated once anything has been appended;
+// appends return false only when memory allocation fails.
+
+typedef struct StringBuilder {
+    char* data;
+    size_t length;             // Bytes in use (excluding the terminator)
+    size_t capacity;           // Bytes allocated
+} StringBuilder;
+
+// Lifetime
+void string_builder_init(StringBuilder* builder);
+void string_builder_free(StringBuilder* builder);
+void string_builder_clear(StringBuilder* builder);
+bool string_builder_reserve(StringBuilder* builder, size_t extra);
+
+// Appending
+bool string_builder_append(StringBuilder* builder, const char* text);
+bool string_builder_append_n(StringBuilder* builder, const char* text, size_t length);
+bool string_builder_append_char(StringBuilder* builder, char c);
+bool string_builder_append_int(StringBuilder* builder, long long value);
+bool string_builder_appendf(StringBuilder* builder, const char* format, ...);
+bool string_builder_appendv(StringBuilder* builder, const char* format, va_list args);
+
+#endif // STRING_BUILDER_H
@@ -0,0 +1,182 @@
+#define _GNU_SOURCE
+#include "string_intern.h"
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// Interned string entry; the text is stored inline after the header so the
+// hash and length can be recovered from the string pointer alone.
+// Entries are bump-allocated from intern_arena and released together.
+typedef struct InternEntry {
+    unsigned int hash;
+    unsigned int length;
+    char text[];
+} InternEntry;
+
+// Open-addressing slot array. Lookups take no lock: an entry is complete
+// before its slot is set, and a grown array is filled before it is
+// published. Replaced arrays are kept (some reader may still be probing
+// one) and freed with the table.
+typedef struct InternTable {
+    InternEntry** slots;
+    size_t capacity;                // Power of two
+    struct InternTable* retired;    // The array this one replaced
+} InternTable;
+
+#define INTERN_INITIAL_CAPACITY 512
+
+static Arena* intern_arena = NULL;
+static InternTable* intern_table = NULL;
+static size_t intern_entry_count = 0;
+
+// Serializes insertions; interning may happen on analysis worker threads
+static pthread_mutex_t intern_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define INTERN_ENTRY(str) ((InternEntry*)((str) - offsetof(InternEntry, text)))
+
+// FNV-1a over the string bytes
+static unsigned int intern_hash_bytes(const char* str, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Store an entry in the first free slot of its probe sequence
+static void intern_table_store(InternTable* table, InternEntry* entry) {
+    size_t slot = entry->hash & (table->capacity - 1);
+    while (table->slots[slot]) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    __atomic_store_n(&table->slots[slot], entry, __ATOMIC_RELEASE);
+}
+
+// Publish a slot array twice the size (intern_lock held)
+static bool intern_grow(void) {
+    InternTable* table = malloc(sizeof(InternTable));
+    size_t capacity = intern_table ? intern_table->capacity * 2 : INTERN_INITIAL_CAPACITY;
+    InternEntry** slots = calloc(capacity, sizeof(InternEntry*));
+    if (!table || !slots) {
+        free(table);
+        free(slots);
+        return false;
+    }
+    
+    table->slots = slots;
+    table->capacity = capacity;
+    table->retired = intern_table;
+    for (size_t i = 0; intern_table && i < intern_table->capacity; i++) {
+        if (intern_table->slots[i]) {
+            intern_table_store(table, intern_table->slots[i]);
+        }
+    }
+    __atomic_store_n(&intern_table, table, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Find an existing entry for the given bytes; no lock needed
+static InternEntry* intern_find(const char* str, size_t length, unsigned int hash) {
+    const InternTable* table = __atomic_load_n(&intern_table, __ATOMIC_ACQUIRE);
+    if (!table) return NULL;
+    
+    size_t slot = hash & (table->capacity - 1);
+    InternEntry* entry;
+    while ((entry = __atomic_load_n(&table->slots[slot], __ATOMIC_ACQUIRE)) != NULL) {
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->text, str, length) == 0) {
+            return entry;
+        }
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    return NULL;
+}
+
+// Insert a new entry (intern_lock held)
+static InternEntry* intern_insert(const char* str, size_t length, unsigned int hash) {
+    // Grow at 1/2 load to keep probe sequences short
+    if ((!intern_table || (intern_entry_count + 1) * 2 > intern_table->capacity) && !intern_grow()) {
+        return NULL;
+    }
+    
+    if (!intern_arena) {
+        intern_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+        if (!intern_arena) return NULL;
+    }
+    
+    InternEntry* entry = arena_alloc(intern_arena, sizeof(InternEntry) + length + 1);
+    if (!entry) return NULL;
+    
+    entry->hash = hash;
+    entry->length = (unsigned int)length;
+    memcpy(entry->text, str, length);
+    entry->text[length] = '\0';
+    
+    intern_table_store(intern_table, entry);
+    intern_entry_count++;
+    return entry;
+}
+
+// Intern a (possibly non NUL-terminated) byte span
+const char* intern_string_n(const char* str, size_t length) {
+    if (!str) return NULL;
+    
+    unsigned int hash = intern_hash_bytes(str, length);
+    InternEntry* entry = intern_find(str, length, hash);
+    if (entry) return entry->text;
+    
+    // Look again under the lock: another thread may have inserted it
+    pthread_mutex_lock(&intern_lock);
+    entry = intern_find(str, length, hash);
+    if (!entry) entry = intern_insert(str, length, hash);
+    pthread_mutex_unlock(&intern_lock);
+    
+    return entry ? entry->text : NULL;
+}
+
+// Intern a NUL-terminated string
+const char* intern_string(const char* str) {
+    if (!str) return NULL;
+    return intern_string_n(str, strlen(str));
+}
+
+// Return the interned copy of str without inserting it (NULL if never interned)
+const char* intern_lookup(const char* str) {
+    if (!str) return NULL;
+    
+    size_t length = strlen(str);
+    InternEntry* entry = intern_find(str, length, intern_hash_bytes(str, length));
+    return entry ? entry->text : NULL;
+}
+
+// Precomputed hash of an interned string
+unsigned int intern_hash(const char* interned) {
+    return interned ? INTERN_ENTRY(interned)->hash : 0;
+}
+
+// Length of an interned string
+size_t intern_length(const char* interned) {
+    return interned ? INTERN_ENTRY(interned)->length : 0;
+}
+
+// Number of distinct interned strings
+size_t intern_count(void) {
+    return intern_entry_count;
+}
+
+// Release every interned string; all previously returned pointers become invalid
+void intern_clear(void) {
+    arena_destroy(intern_arena);
+    intern_arena = NULL;
+    
+    while (intern_table) {
+        InternTable* retired = intern_table->retired;
+        free(intern_table->slots);
+        free(intern_table);
+        intern_table = retired;
+    }
+    intern_entry_count = 0;
+}
@@ -0,0 +1,27 @@
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Global string interning table.
+// Every distinct string is stored exactly once, so two interned strings are
+// equal iff their pointers are equal, and each carries a precomputed hash.
+// Interned strings are immutable and stay valid until intern_clear().
+// Interning and lookup are thread-safe (finding an existing string takes no
+// lock); intern_clear() is not.
+
+// Interning
+const char* intern_string(const char* str);
+const char* intern_string_n(const char* str, size_t length);
+const char* intern_lookup(const char* str);
+
+// Properties of interned strings (argument must come from intern_*)
+unsigned int intern_hash(const char* interned);
+size_t intern_length(const char* interned);
+
+// Table management
+size_t intern_count(void);
+void intern_clear(void);
+
+#endif // STRING_INTERN_H
@@ -0,0 +1,59 @@
+#include "thread_pool.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+// State shared by the threads of one run
+typedef struct ThreadPoolRun {
+    ThreadPoolJob job;
+    void* arg;
+    int count;
+    int next;                  // Next job index (taken atomically)
+} ThreadPoolRun;
+
+typedef struct ThreadPoolWorker {
+    ThreadPoolRun* run;
+    int worker;
+    pthread_t thread;
+} ThreadPoolWorker;
+
+// Run jobs until none are left
+static void* thread_pool_work(void* arg) {
+    ThreadPoolWorker* worker = arg;
+    ThreadPoolRun* run = worker->run;
+    
+    for (;;) {
+        int index = __atomic_fetch_add(&run->next, 1, __ATOMIC_RELAXED);
+        if (index >= run->count) break;
+        run->job(run->arg, index, worker->worker);
+    }
+    return NULL;
+}
+
+// Run every job; falls back to the calling thread if no thread can be started
+void thread_pool_run(int workers, int count, ThreadPoolJob job, void* arg) {
+    if (!job || count <= 0) return;
+    if (workers > count) workers = count;
+    if (workers < 1) workers = 1;
+    
+    ThreadPoolRun run = { job, arg, count, 0 };
+    ThreadPoolWorker* pool = workers > 1 ? calloc(workers, sizeof(ThreadPoolWorker)) : NULL;
+    
+    int started = 0;
+    for (int i = 0; pool && i < workers; i++) {
+        pool[started].run = &run;
+        pool[started].worker = started;
+        if (pthread_create(&pool[started].thread, NULL, thread_pool_work, &pool[started]) == 0) {
+            started++;
+        }
+    }
+    
+    if (started == 0) {
+        ThreadPoolWorker self = { &run, 0, pthread_self() };
+        thread_pool_work(&self);
+    }
+    
+    for (int i = 0; i < started; i++) {
+        pthread_join(pool[i].thread, NULL);
+    }
+    free(pool);
+}
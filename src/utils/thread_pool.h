@@ -0,0 +1,14 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Fork-join pool for independent jobs.
+// thread_pool_run starts up to `workers` threads, hands out job indices
+// 0..count-1 in increasing order and returns when every job has finished.
+// The worker number passed to a job is in [0, workers) and stays the same
+// for all jobs run by one thread, so it can select per-thread state.
+
+typedef void (*ThreadPoolJob)(void* arg, int index, int worker);
+
+void thread_pool_run(int workers, int count, ThreadPoolJob job, void* arg);
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,242 @@
+#define _GNU_SOURCE
+#include "timing.h"
+#include "alloc_stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define TIMING_MAX_DEPTH 32
+
+// Accumulated measurements of one phase (under one parent)
+typedef struct TimingPhase {
+    const char* name;          // Caller-owned, usually a string literal
+    int parent;                // Index of the enclosing phase, -1 at top level
+    int calls;
+    double wall_seconds;
+    double cpu_seconds;
+    size_t allocations;
+    size_t peak_bytes;         // Highest heap usage while the phase was open
+    long long net_bytes;       // Heap growth between begin and end
+} TimingPhase;
+
+// Open phase on the stack
+typedef struct TimingFrame {
+    int phase;
+    double wall_start;
+    double cpu_start;
+    size_t allocations_start;
+    size_t bytes_start;
+    size_t peak_seen;          // Peak observed before a nested phase reset it
+} TimingFrame;
+
+static bool timing_on = false;
+static TimingPhase* timing_phases = NULL;
+static int timing_phase_count = 0;
+static int timing_phase_capacity = 0;
+static TimingFrame timing_stack[TIMING_MAX_DEPTH];
+static int timing_depth = 0;
+static pthread_t timing_thread;       // Thread that enabled timing
+
+static double timing_clock(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static size_t timing_max(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+// Turn measurement on or off
+void timing_enable(bool enabled) {
+    timing_on = enabled;
+    timing_thread = pthread_self();
+}
+
+bool timing_is_enabled(void) {
+    return timing_on;
+}
+
+// Phases are only recorded on the thread that enabled timing
+static bool timing_is_owner(void) {
+    return pthread_equal(pthread_self(), timing_thread);
+}
+
+// Find the record for name under parent, creating it on first use
+static int timing_find_phase(const char* name, int parent) {
+    for (int i = 0; i < timing_phase_count; i++) {
+        if (timing_phases[i].parent == parent && strcmp(timing_phases[i].name, name) == 0) {
+            return i;
+        }
+    }
+    
+    if (timing_phase_count >= timing_phase_capacity) {
+        int new_capacity = timing_phase_capacity ? timing_phase_capacity * 2 : 16;
+        TimingPhase* new_phases = realloc(timing_phases, new_capacity * sizeof(TimingPhase));
+        if (!new_phases) return -1;
+        
+        timing_phases = new_phases;
+        timing_phase_capacity = new_capacity;
+    }
+    
+    TimingPhase* phase = &timing_phases[timing_phase_count];
+    memset(phase, 0, sizeof(TimingPhase));
+    phase->name = name;
+    phase->parent = parent;
+    return timing_phase_count++;
+}
+
+// Open a phase; returns the mark to pass to timing_end
+int timing_begin(const char* name) {
+    if (!timing_on || !name) return timing_depth;
+    if (!timing_is_owner()) return 0;
+    
+    int mark = timing_depth;
+    if (timing_depth >= TIMING_MAX_DEPTH) return mark;
+    
+    int parent = timing_depth > 0 ? timing_stack[timing_depth - 1].phase : -1;
+    int phase = timing_find_phase(name, parent);
+    if (phase < 0) return mark;
+    
+    // Remember the parent's peak so far, then measure this phase on its own
+    AllocStats stats = alloc_stats_get();
+    if (timing_depth > 0) {
+        TimingFrame* outer = &timing_stack[timing_depth - 1];
+        outer->peak_seen = timing_max(outer->peak_seen, stats.peak_bytes);
+    }
+    alloc_stats_reset_peak();
+    
+    TimingFrame* frame = &timing_stack[timing_depth++];
+    frame->phase = phase;
+    frame->allocations_start = stats.allocations;
+    frame->bytes_start = stats.current_bytes;
+    frame->peak_seen = stats.current_bytes;
+    frame->cpu_start = timing_clock(CLOCK_PROCESS_CPUTIME_ID);
+    frame->wall_start = timing_clock(CLOCK_MONOTONIC);
+    
+    return mark;
+}
+
+// Close phases until the stack is back at mark
+void timing_end(int mark) {
+    if (timing_on && !timing_is_owner()) return;
+    
+    while (timing_depth > mark && timing_depth > 0) {
+        double wall_end = timing_clock(CLOCK_MONOTONIC);
+        double cpu_end = timing_clock(CLOCK_PROCESS_CPUTIME_ID);
+        AllocStats stats = alloc_stats_get();
+        
+        TimingFrame* frame = &timing_stack[--timing_depth];
+        TimingPhase* phase = &timing_phases[frame->phase];
+        size_t peak = timing_max(frame->peak_seen, stats.peak_bytes);
+        
+        phase->calls++;
+        phase->wall_seconds += wall_end - frame->wall_start;
+        phase->cpu_seconds += cpu_end - frame->cpu_start;
+        phase->allocations += stats.allocations - frame->allocations_start;
+        phase->peak_bytes = timing_max(phase->peak_bytes, peak);
+        phase->net_bytes += (long long)stats.current_bytes - (long long)frame->bytes_start;
+        
+        // The enclosing phase saw everything this one did
+        if (timing_depth > 0) {
+            TimingFrame* outer = &timing_stack[timing_depth - 1];
+            outer->peak_seen = timing_max(outer->peak_seen, peak);
+        }
+    }
+}
+
+static void timing_print_text(FILE* out, int parent, int depth) {
+    for (int i = 0; i < timing_phase_count; i++) {
+        TimingPhase* phase = &timing_phases[i];
+        if (phase->parent != parent) continue;
+        
+        int indent = depth * 2;
+        fprintf(out, "%*s%-*s %6d %10.3f %10.3f", indent, "", 28 - indent, phase->name,
+                phase->calls, phase->wall_seconds * 1000.0, phase->cpu_seconds * 1000.0);
+        if (alloc_stats_available()) {
+            fprintf(out, " %9zu %10.1f %10.1f", phase->allocations,
+                    phase->peak_bytes / 1024.0, phase->net_bytes / 1024.0);
+        }
+        fprintf(out, "\n");
+        
+        timing_print_text(out, i, depth + 1);
+    }
+}
+
+// Human-readable table
+void timing_report_text(FILE* out) {
+    if (!out) return;
+    
+    fprintf(out, "%-28s %6s %10s %10s", "Phase", "calls", "wall ms", "cpu ms");
+    if (alloc_stats_available()) {
+        fprintf(out, " %9s %10s %10s", "allocs", "peak KB", "net KB");
+    }
+    fprintf(out, "\n");
+    
+    timing_print_text(out, -1, 0);
+    
+    if (!alloc_stats_available()) {
+        fprintf(out, "(allocation tracking not compiled in)\n");
+    }
+}
+
+// Write s as a JSON string literal
+static void timing_json_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void timing_print_json(FILE* out, int parent, int depth) {
+    bool first = true;
+    for (int i = 0; i < timing_phase_count; i++) {
+        TimingPhase* phase = &timing_phases[i];
+        if (phase->parent != parent) continue;
+        
+        fprintf(out, "%s\n%*s{\"name\": ", first ? "" : ",", depth * 2 + 2, "");
+        timing_json_string(out, phase->name);
+        fprintf(out, ", \"calls\": %d, \"wall_ms\": %.3f, \"cpu_ms\": %.3f",
+                phase->calls, phase->wall_seconds * 1000.0, phase->cpu_seconds * 1000.0);
+        if (alloc_stats_available()) {
+            fprintf(out, ", \"allocations\": %zu, \"peak_bytes\": %zu, \"net_bytes\": %lld",
+                    phase->allocations, phase->peak_bytes, phase->net_bytes);
+        }
+        fprintf(out, ", \"children\": [");
+        timing_print_json(out, i, depth + 1);
+        fprintf(out, "]}");
+        first = false;
+    }
+}
+
+// Machine-readable report
+void timing_report_json(FILE* out, const char* compiler_version, const char* input_file) {
+    if (!out) return;
+    
+    fprintf(out, "{\"compiler_version\": ");
+    timing_json_string(out, compiler_version);
+    fprintf(out, ", \"input\": ");
+    timing_json_string(out, input_file);
+    fprintf(out, ", \"allocation_tracking\": %s, \"phases\": [",
+            alloc_stats_available() ? "true" : "false");
+    timing_print_json(out, -1, 0);
+    fprintf(out, "]}\n");
+}
+
+// Forget all measurements
+void timing_reset(void) {
+    free(timing_phases);
+    timing_phases = NULL;
+    timing_phase_count = 0;
+    timing_phase_capacity = 0;
+    timing_depth = 0;
+}
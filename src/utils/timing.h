@@ -0,0 +1,32 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Per-phase compile time and memory instrumentation (--time-report).
+// Phases nest; a phase begun again under the same parent accumulates into
+// the same record and counts calls. When timing is disabled begin/end only
+// test a flag.
+//
+//     int mark = timing_begin("semantic");
+//     ...
+//     timing_end(mark);  // also closes any phase left open inside
+//
+// Phases are recorded on the thread that called timing_enable(); begin/end
+// on any other thread are ignored, so work done by worker threads counts
+// toward the phase that is open on the main thread.
+
+void timing_enable(bool enabled);
+bool timing_is_enabled(void);
+
+int timing_begin(const char* name);
+void timing_end(int mark);
+
+// Reports (all open phases must have been ended)
+void timing_report_text(FILE* out);
+void timing_report_json(FILE* out, const char* compiler_version, const char* input_file);
+
+void timing_reset(void);
+
+#endif // TIMING_H
@@ -1,16 +1,30 @@
-#include "../src/lexer.h"
+#include "../src/lexer/lexer.h"
+#include "../src/lexer/lexer_scan.h"
+#include "../src/lexer/token_buffer.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
 // Test helper function
-void test_token(Token token, TokenType expected_type, const char* expected_value) {
+void test_token(Lexer* lexer, Token token, TokenType expected_type, const char* expected_value) {
     assert(token.type == expected_type);
+    char* text = token_text(lexer, &token);
+    assert(text != NULL);
     if (expected_value) {
-        assert(token.value != NULL);
-        assert(strcmp(token.value, expected_value) == 0);
+        assert(strcmp(text, expected_value) == 0);
     }
-    printf("✓ Token: %s (type: %d)\n", token.value ? token.value : "NULL", token.type);
+    printf("✓ Token: %s (type: %d)\n", token.type == TOKEN_EOF ? "NULL" : text, token.type);
+    free(text);
+}
+
+// Tokens of two lexers resolve to the same line and column
+static void assert_same_position(const Lexer* lexer, const Token* token,
+                                 const Lexer* other, const Token* other_token) {
+    int line, column, other_line, other_column;
+    token_position(lexer, token, &line, &column);
+    token_position(other, other_token, &other_line, &other_column);
+    assert(line == other_line && column == other_column);
 }
 
 // Test basic tokens
@@ -24,63 +38,51 @@ void test_basic_tokens() {
     
     // fn
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_KEYWORD, "fn");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_KEYWORD, "fn");
     
     // main
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_IDENTIFIER, "main");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_IDENTIFIER, "main");
     
     // (
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_DELIMITER, "(");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_DELIMITER, "(");
     
     // )
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_DELIMITER, ")");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_DELIMITER, ")");
     
     // ->
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_OPERATOR, "->");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_OPERATOR, "->");
     
     // i32
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_KEYWORD, "i32");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_KEYWORD, "i32");
     
     // {
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_DELIMITER, "{");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_DELIMITER, "{");
     
     // return
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_KEYWORD, "return");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_KEYWORD, "return");
     
     // 42
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_INTEGER, "42");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_INTEGER, "42");
     
     // ;
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_DELIMITER, ";");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_DELIMITER, ";");
     
     // }
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_DELIMITER, "}");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_DELIMITER, "}");
     
     // EOF
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_EOF, NULL);
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("✓ Basic tokens test passed!\n");
@@ -97,38 +99,31 @@ void test_numbers() {
     
     // 42
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_INTEGER, "42");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_INTEGER, "42");
     
     // 3.14
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_FLOAT, "3.14");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_FLOAT, "3.14");
     
     // 0xFF
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_INTEGER, "0xFF");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_INTEGER, "0xFF");
     
     // 0b1010
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_INTEGER, "0b1010");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_INTEGER, "0b1010");
     
     // 0o755
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_INTEGER, "0o755");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_INTEGER, "0o755");
     
     // 1.23e-4
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_FLOAT, "1.23e-4");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_FLOAT, "1.23e-4");
     
     // 3.14f
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_FLOAT, "3.14f");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_FLOAT, "3.14f");
     
     lexer_destroy(lexer);
     printf("✓ Numbers test passed!\n");
@@ -145,23 +140,19 @@ void test_strings() {
     
     // "Hello, World!"
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_STRING, "Hello, World!");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_STRING, "Hello, World!");
     
     // "Line\nBreak"
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_STRING, "Line\nBreak");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_STRING, "Line\nBreak");
     
     // 'c'
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_CHAR, "c");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_CHAR, "c");
     
     // '\n'
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_CHAR, "\\n");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_CHAR, "\\n");
     
     lexer_destroy(lexer);
     printf("✓ Strings test passed!\n");
@@ -181,8 +172,7 @@ void test_operators() {
     
     for (int i = 0; i < 16; i++) {
         Token token = lexer_next_token(lexer);
-        test_token(token, TOKEN_OPERATOR, expected_ops[i]);
-        token_destroy(&token);
+        test_token(lexer, token, TOKEN_OPERATOR, expected_ops[i]);
     }
     
     lexer_destroy(lexer);
@@ -200,18 +190,15 @@ void test_preprocessor() {
     
     // #include core::io
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_PREPROCESSOR, "#include core::io");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_PREPROCESSOR, "#include core::io");
     
     // #if __dbg__
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_PREPROCESSOR, "#if __dbg__");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_PREPROCESSOR, "#if __dbg__");
     
     // #define MAX(a,b) ((a)>(b)?(a):(b))
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_PREPROCESSOR, "#define MAX(a,b) ((a)>(b)?(a):(b))");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_PREPROCESSOR, "#define MAX(a,b) ((a)>(b)?(a):(b))");
     
     lexer_destroy(lexer);
     printf("✓ Preprocessor test passed!\n");
@@ -228,31 +215,364 @@ void test_comments() {
     
     // fn
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_KEYWORD, "fn");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_KEYWORD, "fn");
     
     // main
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_IDENTIFIER, "main");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_IDENTIFIER, "main");
     
     // Skip to i32 (comments should be ignored)
     token = lexer_next_token(lexer); // (
-    token_destroy(&token);
     token = lexer_next_token(lexer); // )
-    token_destroy(&token);
     token = lexer_next_token(lexer); // {
-    token_destroy(&token);
     
     // i32
     token = lexer_next_token(lexer);
-    test_token(token, TOKEN_KEYWORD, "i32");
-    token_destroy(&token);
+    test_token(lexer, token, TOKEN_KEYWORD, "i32");
     
     lexer_destroy(lexer);
     printf("✓ Comments test passed!\n");
 }
 
+// Test keyword IDs
+void test_keyword_ids() {
+    printf("\n=== Testing Keyword IDs ===\n");
+    
+    // Every keyword must resolve to its own ID and round-trip to its spelling
+    for (int kw = KW_NONE + 1; kw < KW_COUNT; kw++) {
+        const char* name = keyword_to_string((KeywordId)kw);
+        assert(name != NULL);
+        assert(keyword_lookup(name, strlen(name)) == (KeywordId)kw);
+        assert(is_keyword(name));
+    }
+    
+    // Near misses are plain identifiers
+    const char* non_keywords[] = { "f", "fnx", "i128", "Struct", "returns", "autos", "_if", "voi" };
+    for (int i = 0; i < 8; i++) {
+        assert(keyword_lookup(non_keywords[i], strlen(non_keywords[i])) == KW_NONE);
+    }
+    
+    const char* source = "while whilst i32 i33";
+    Lexer* lexer = lexer_create(source);
+    
+    Token token = lexer_next_token(lexer);
+    test_token(lexer, token, TOKEN_KEYWORD, "while");
+    assert(token.keyword == KW_WHILE);
+    
+    token = lexer_next_token(lexer);
+    test_token(lexer, token, TOKEN_IDENTIFIER, "whilst");
+    assert(token.keyword == KW_NONE);
+    
+    token = lexer_next_token(lexer);
+    test_token(lexer, token, TOKEN_KEYWORD, "i32");
+    assert(token.keyword == KW_I32 && keyword_is_type(token.keyword));
+    
+    token = lexer_next_token(lexer);
+    test_token(lexer, token, TOKEN_IDENTIFIER, "i33");
+    
+    lexer_destroy(lexer);
+    printf("✓ Keyword IDs test passed!\n");
+}
+
+// Test operator IDs
+void test_operator_ids() {
+    printf("\n=== Testing Operator IDs ===\n");
+    
+    // Every operator must resolve to its own ID and round-trip to its spelling
+    for (int op = OP_NONE + 1; op < OP_COUNT; op++) {
+        const char* name = operator_to_string((OperatorId)op);
+        assert(name != NULL);
+        assert(operator_lookup(name, strlen(name)) == (OperatorId)op);
+    }
+    assert(operator_lookup("=>", 2) == OP_NONE && operator_lookup("<<=", 3) == OP_NONE);
+    
+    // Longest match, falling back to one character
+    const char* source = "a<=b<c->d-e::f x";
+    Lexer* lexer = lexer_create(source);
+    OperatorId expected[] = { OP_LESS_EQUAL, OP_LESS, OP_ARROW, OP_MINUS, OP_SCOPE };
+    for (int i = 0; i < 5; i++) {
+        Token token = lexer_next_token(lexer);
+        assert(token.type == TOKEN_IDENTIFIER && token.op == OP_NONE);
+        
+        token = lexer_next_token(lexer);
+        assert(token.type == TOKEN_OPERATOR && token.op == expected[i]);
+        assert(token_equals(lexer, &token, operator_to_string(expected[i])));
+    }
+    
+    lexer_destroy(lexer);
+    printf("✓ Operator IDs test passed!\n");
+}
+
+// Test lexing a (pointer, length) view and a chunked stream
+void test_buffer_and_stream() {
+    printf("\n=== Testing Buffer and Stream Input ===\n");
+    
+    // A view ends at its length, not at a NUL
+    const char* text = "abc+def";
+    Lexer* lexer = lexer_create_buffer(text, 3);
+    Token token = lexer_next_token(lexer);
+    test_token(lexer, token, TOKEN_IDENTIFIER, "abc");
+    assert(lexer_next_token(lexer).type == TOKEN_EOF);
+    lexer_destroy(lexer);
+    
+    const char* source = "fn main() -> i32 {\n"
+                         "    /* a comment longer than a chunk */ string s = \"a\\tlong literal\";\n"
+                         "    return identifier_longer_than_chunks + 0x1F * 2.5e3; // done\n"
+                         "}\n";
+    FILE* file = tmpfile();
+    assert(file && fputs(source, file) >= 0);
+    
+    // Streamed tokens match in-memory ones for any chunk size, and the
+    // previous token stays readable while the next one is read
+    for (size_t chunk = 1; chunk <= 9; chunk += 4) {
+        rewind(file);
+        Lexer* memory = lexer_create(source);
+        Lexer* stream = lexer_create_stream(file, chunk);
+        Token previous = lexer_next_token(stream);
+        Token expected = lexer_next_token(memory);
+        char* previous_text = token_text(memory, &expected);
+        
+        while (previous.type != TOKEN_EOF) {
+            assert(previous.type == expected.type && previous.offset == expected.offset);
+            assert_same_position(stream, &previous, memory, &expected);
+            
+            Token next = lexer_next_token(stream);
+            char* text_after = token_text(stream, &previous);
+            assert(strcmp(text_after, previous_text) == 0);
+            free(text_after);
+            free(previous_text);
+            
+            previous = next;
+            expected = lexer_next_token(memory);
+            previous_text = token_text(memory, &expected);
+        }
+        assert(expected.type == TOKEN_EOF);
+        free(previous_text);
+        lexer_destroy(stream);
+        lexer_destroy(memory);
+    }
+    
+    fclose(file);
+    printf("✓ Buffer and stream input test passed!\n");
+}
+
+// Test the vector scanners against the scalar ones
+void test_scanners() {
+    printf("\n=== Testing Scanners (%s) ===\n",
+           scan_level() == SCAN_AVX2 ? "AVX2" : scan_level() == SCAN_SSE2 ? "SSE2" : "scalar");
+    
+    ScanLevel detected = scan_level();
+    char text[200];
+    const char alphabet[] = "  \t\n\r*/\"\\ab\0";
+    srand(7);
+    for (int round = 0; round < 2000; round++) {
+        // Sparse hits, so that long runs cross the 16- and 32-byte blocks
+        for (size_t i = 0; i < sizeof(text); i++) {
+            text[i] = rand() % 8 ? " \n"[rand() % 16 == 0] : alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        size_t start = (size_t)(rand() % 40);
+        size_t length = (size_t)(rand() % (int)(sizeof(text) - start));
+        
+        assert(scan_select(SCAN_SCALAR));
+        size_t space = scan_whitespace(text + start, length);
+        size_t until = scan_until(text + start, length, '"', '\\');
+        size_t newline = scan_until(text + start, length, '\n', '\n');
+        
+        for (int level = SCAN_SSE2; level <= SCAN_AVX2; level++) {
+            if (!scan_select((ScanLevel)level)) continue;
+            assert(scan_whitespace(text + start, length) == space);
+            assert(scan_until(text + start, length, '"', '\\') == until);
+            assert(scan_until(text + start, length, '\n', '\n') == newline);
+        }
+    }
+    
+    // Token positions do not depend on the scanner
+    const char* source = "fn f() {   \n\t/* one\n two */ x = \"a\\\"b\nc\"; // tail\n\n  y }";
+    Token expected[32];
+    int count = 0;
+    assert(scan_select(SCAN_SCALAR));
+    Lexer* scalar = lexer_create(source);
+    do {
+        expected[count] = lexer_next_token(scalar);
+    } while (expected[count++].type != TOKEN_EOF);
+    
+    for (int level = SCAN_SSE2; level <= SCAN_AVX2; level++) {
+        if (!scan_select((ScanLevel)level)) continue;
+        Lexer* lexer = lexer_create(source);
+        for (int i = 0; i < count; i++) {
+            Token token = lexer_next_token(lexer);
+            assert(token.type == expected[i].type && token.offset == expected[i].offset);
+            assert_same_position(lexer, &token, scalar, &expected[i]);
+        }
+        lexer_destroy(lexer);
+    }
+    lexer_destroy(scalar);
+    
+    assert(scan_select(detected));
+    printf("✓ Scanners test passed!\n");
+}
+
+// Test resolving token offsets to lines and columns
+void test_line_index() {
+    printf("\n=== Testing Line Index ===\n");
+    
+    // Newlines in whitespace, comments and string escapes all start lines;
+    // a string is positioned at its opening quote
+    const char* source = "fn f()\n"
+                         "\t{ /* one\n"
+                         "two */ x\r\n"
+                         "  \"a\\\nb\" y\n"
+                         "}";
+    const int expected[][2] = {
+        {1, 1}, {1, 4}, {1, 5}, {1, 6}, {2, 2}, {3, 8}, {4, 3}, {5, 4}, {6, 1}, {6, 2}
+    };
+    Lexer* lexer = lexer_create(source);
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        Token token = lexer_next_token(lexer);
+        int line, column;
+        token_position(lexer, &token, &line, &column);
+        assert(line == expected[i][0] && column == expected[i][1]);
+        assert(token.type != TOKEN_EOF || i == sizeof(expected) / sizeof(expected[0]) - 1);
+    }
+    assert(lexer->lines.count == 5);
+    lexer_destroy(lexer);
+    
+    // Columns are not limited by the width of a packed position
+    char wide[6002];
+    memset(wide, ' ', 6000);
+    strcpy(wide + 6000, "z");
+    lexer = lexer_create(wide);
+    Token token = lexer_next_token(lexer);
+    int line, column;
+    token_position(lexer, &token, &line, &column);
+    assert(line == 1 && column == 6001);
+    lexer_destroy(lexer);
+    
+    // Nodes without a position and lookups without an index resolve to 0:0
+    line_index_position(NULL, token_location(&token), &line, &column);
+    assert(line == 0 && column == 0);
+    LineIndex empty;
+    line_index_init(&empty);
+    line_index_position(&empty, SOURCE_LOCATION_NONE, &line, &column);
+    assert(line == 0 && column == 0);
+    
+    printf("✓ Line index test passed!\n");
+}
+
+static void assert_same_token(const Token* token, const Token* expected) {
+    assert(token->type == expected->type && token->offset == expected->offset);
+    assert(token->length == expected->length);
+    assert(token->keyword == expected->keyword && token->op == expected->op);
+    assert(token->error == expected->error);
+}
+
+// Test the pre-lexed token buffer: lexed on the reading thread, on a lexer
+// thread (stopped part way through), and from a stream
+void test_token_buffer() {
+    printf("\n=== Testing Token Buffer ===\n");
+    
+    // Several chunks' worth of tokens of every kind, errors included
+    size_t capacity = 4096 * 48;
+    char* source = malloc(capacity);
+    size_t length = 0;
+    for (int i = 0; i < 4096; i++) {
+        length += (size_t)sprintf(source + length, "fn f%d() -> i32 { return \"s\\n\" + %d.5; }%s\n",
+                                  i, i, i % 100 == 0 ? " @" : "");
+    }
+    assert(length < capacity);
+    
+    Lexer* reference = lexer_create_buffer(source, length);
+    size_t count = 0;
+    Token* expected = malloc(sizeof(Token) * length);
+    do {
+        expected[count] = lexer_next_token(reference);
+    } while (expected[count++].type != TOKEN_EOF);
+    assert(count > 4 * TOKEN_CHUNK_SIZE);
+    
+    FILE* file = tmpfile();
+    assert(file && fwrite(source, 1, length, file) == length);
+    
+    const int distances[] = { 1, 2, 100, TOKEN_LOOKAHEAD_MAX };
+    for (int mode = 0; mode < 3; mode++) {
+        rewind(file);
+        Lexer* lexer = mode == 2 ? lexer_create_stream(file, 7) : lexer_create_buffer(source, length);
+        TokenBuffer* tokens = token_buffer_create(lexer);
+        if (mode > 0) assert(token_buffer_start_thread(tokens) == (mode == 1));   // not for a stream
+        
+        Token token = token_buffer_peek(tokens, 0);
+        for (size_t i = 0; i < count; i++) {
+            assert_same_token(&token, &expected[i]);
+            for (size_t d = 0; d < sizeof(distances) / sizeof(distances[0]); d++) {
+                size_t ahead = i + (size_t)distances[d];
+                Token peeked = token_buffer_peek(tokens, distances[d]);
+                assert_same_token(&peeked, &expected[ahead < count ? ahead : count - 1]);
+            }
+            
+            // Lookahead keeps the current token's text readable from a stream
+            char* text = token_text(lexer, &token);
+            char* text_expected = token_text(reference, &expected[i]);
+            assert(strcmp(text, text_expected) == 0);
+            free(text);
+            free(text_expected);
+            
+            if (i == count / 2) token_buffer_join(tokens);
+            token_buffer_advance(tokens, &token);
+        }
+        
+        // The end stays on the EOF token
+        assert(token.type == TOKEN_EOF && !tokens->failed);
+        token_buffer_advance(tokens, &token);
+        assert_same_token(&token, &expected[count - 1]);
+        
+        token_buffer_destroy(tokens);
+        lexer_destroy(lexer);
+    }
+    
+    fclose(file);
+    free(expected);
+    lexer_destroy(reference);
+    free(source);
+    printf("✓ Token buffer test passed!\n");
+}
+
+// Test zero-copy token spans
+void test_token_spans() {
+    printf("\n=== Testing Token Spans ===\n");
+    
+    const char* source = "name \"a\\tb\" -> @";
+    Lexer* lexer = lexer_create(source);
+    
+    // Identifiers reference the source buffer directly
+    Token token = lexer_next_token(lexer);
+    assert(token.offset == 0 && token.length == 4);
+    assert(token_start(lexer, &token) == source);
+    assert(token_equals(lexer, &token, "name"));
+    assert(!token_equals(lexer, &token, "nam"));
+    
+    // String spans cover the raw contents, escapes are decoded on copy
+    token = lexer_next_token(lexer);
+    assert(token.type == TOKEN_STRING && token.length == 4);
+    char buffer[8];
+    assert(token_copy_text(lexer, &token, buffer, sizeof(buffer)) == 3);
+    assert(strcmp(buffer, "a\tb") == 0);
+    
+    // Truncated copies stay NUL-terminated and report the full length
+    assert(token_copy_text(lexer, &token, buffer, 2) == 3);
+    assert(strcmp(buffer, "a") == 0);
+    
+    token = lexer_next_token(lexer);
+    assert(token.type == TOKEN_OPERATOR && token_equals(lexer, &token, "->"));
+    
+    // Errors span the offending text, the reason is kept on the token
+    token = lexer_next_token(lexer);
+    assert(token.type == TOKEN_ERROR && token_equals(lexer, &token, "@"));
+    assert(token.error == LEX_ERROR_UNKNOWN_CHARACTER);
+    assert(strcmp(lex_error_message(token.error), "Unknown character") == 0);
+    
+    lexer_destroy(lexer);
+    printf("✓ Token spans test passed!\n");
+}
+
 // Test complete Echo program
 void test_echo_program() {
     printf("\n=== Testing Complete Echo Program ===\n");
@@ -274,11 +594,12 @@ void test_echo_program() {
     do {
         token = lexer_next_token(lexer);
         if (token.type != TOKEN_EOF) {
-            printf("Token %d: %s (type: %d, line: %d, col: %d)\n", 
-                   ++token_count, token.value ? token.value : "NULL", 
-                   token.type, token.line, token.column);
+            int line, column;
+            token_position(lexer, &token, &line, &column);
+            printf("Token %d: %.*s (type: %d, line: %d, col: %d)\n", 
+                   ++token_count, token.length, token_start(lexer, &token), 
+                   token.type, line, column);
         }
-        token_destroy(&token);
     } while (token.type != TOKEN_EOF);
     
     lexer_destroy(lexer);
@@ -296,6 +617,13 @@ int main() {
     test_operators();
     test_preprocessor();
     test_comments();
+    test_keyword_ids();
+    test_operator_ids();
+    test_buffer_and_stream();
+    test_scanners();
+    test_line_index();
+    test_token_buffer();
+    test_token_spans();
     test_echo_program();
     
     printf("\n🎉 All tests passed!\n");
@@ -25,7 +25,7 @@ void test_parse_success(const char* source, const char* test_name) {
     
     assert(ast != NULL);
     printf("AST:\n");
-    ast_print(ast, 0);
+    ast_print(ast, 0, &lexer->lines);
     
     ast_destroy(ast);
     parser_destroy(parser);
@@ -58,6 +58,52 @@ void test_expressions() {
     test_parse_success(source, "Expressions");
 }
 
+// First node of the given type, depth first
+static ASTNode* find_node(ASTNode* node, ASTNodeType type) {
+    if (!node || node->type == type) return node;
+    
+    for (int i = 0; i < node->child_count; i++) {
+        ASTNode* found = find_node(node->children[i], type);
+        if (found) return found;
+    }
+    return NULL;
+}
+
+// Test operator precedence and associativity
+void test_operator_precedence() {
+    printf("\n=== Testing Operator Precedence ===\n");
+    
+    const char* source = "fn main() -> i32 { x = 1 - 2 - 3 * 4 == 5 || !a && b; return 0; }";
+    Lexer* lexer = lexer_create(source);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    // x = (((1 - 2) - (3 * 4)) == 5) || ((!a) && b)
+    ASTNode* assignment = find_node(ast, AST_ASSIGNMENT);
+    assert(assignment && assignment->op == OP_ASSIGN && assignment->value == NULL);
+    
+    ASTNode* or = assignment->children[1];
+    assert(or->type == AST_BINARY_OP && or->op == OP_OR);
+    
+    ASTNode* equal = or->children[0];
+    assert(equal->op == OP_EQUAL);
+    
+    ASTNode* difference = equal->children[0];
+    assert(difference->op == OP_MINUS && difference->children[0]->op == OP_MINUS);
+    assert(difference->children[1]->op == OP_STAR);
+    
+    ASTNode* and = or->children[1];
+    assert(and->op == OP_AND);
+    assert(and->children[0]->type == AST_UNARY_OP && and->children[0]->op == OP_BANG);
+    
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    printf("✓ Operator precedence test passed!\n");
+}
+
 // Test alloc and delete
 void test_alloc_delete() {
     const char* source = "fn main() -> i32 { i32* ptr = alloc i32(42); delete ptr; return 0; }";
@@ -82,6 +128,29 @@ void test_for_loop() {
     test_parse_success(source, "For Loop");
 }
 
+// Test that errors at a bad token carry the lexer's reason
+void test_lexer_errors() {
+    printf("\n=== Testing Lexer Errors ===\n");
+    
+    const char* sources[] = { "@", "fn main() -> i32 { return 0; }\n\"abc" };
+    const char* reasons[] = { "'@': Unknown character", "'\"': Unterminated string literal" };
+    for (int i = 0; i < 2; i++) {
+        Lexer* lexer = lexer_create(sources[i]);
+        Parser* parser = parser_create(lexer);
+        ASTNode* ast = parser_parse(parser);
+        
+        assert(parser_get_error(parser) != NULL);
+        printf("Expected error caught: %s\n", parser_get_error(parser));
+        assert(strstr(parser_get_error(parser), reasons[i]) != NULL);
+        
+        if (ast) ast_destroy(ast);
+        parser_destroy(parser);
+        lexer_destroy(lexer);
+    }
+    
+    printf("✓ Lexer errors test passed!\n");
+}
+
 // Test error handling
 void test_error_handling() {
     printf("\n=== Testing Error Handling ===\n");
@@ -117,9 +186,11 @@ int main() {
     test_function_with_params();
     test_variable_declaration();
     test_expressions();
+    test_operator_precedence();
     test_alloc_delete();
     test_function_call();
     test_with_preprocessor();
+    test_lexer_errors();
     test_for_loop();
     test_error_handling();
     
@@ -2,7 +2,15 @@
 #include "../src/parser/parser.h"
 #include "../src/ast/ast.h"
 #include "../src/semantic/semantic.h"
+#include "../src/semantic/import_system.h"
+#include "../src/semantic/type_inference.h"
+#include "../src/semantic/types.h"
+#include "../src/semantic/struct_layout.h"
+#include "../src/semantic/module_interface.h"
+#include "../src/codegen/codegen.h"
+#include "../src/utils/string_intern.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
@@ -141,6 +149,18 @@ void test_scope_rules() {
         "Variable Shadowing", true
     ));
     
+    // Sibling scopes may reuse a name once the first one has exited
+    assert(test_semantic_analysis(
+        "fn main() -> i32 { { i32 y = 1; } { i32 y = 2; } return 0; }",
+        "Sibling Scope Redeclaration", true
+    ));
+    
+    // Inner declaration going out of scope must not hide the outer one
+    assert(test_semantic_analysis(
+        "fn main() -> i32 { i32 x = 1; { i32 x = 2; { i32 x = 3; } } return x; }",
+        "Nested Shadowing", true
+    ));
+    
     // Out of scope variable
     assert(test_semantic_analysis(
         "fn main() -> i32 { { i32 x = 1; } return x; }",
@@ -220,6 +240,504 @@ void test_uninitialized_variables() {
     ));
 }
 
+// Test runtime registration of native functions
+void test_import_registry() {
+    printf("\n🧪 Testing Import Registry\n");
+    printf("=========================\n");
+    
+    static const char* square_params[] = { "i32", NULL };
+    static const FunctionDefinition ext_functions[] = {
+        { "ext::math::square", "ext_square", "i32", square_params, 1 },
+        { "ext::math::cube", "ext_cube", "i32", square_params, 1 },
+        { "ext::io::flush", "ext_flush", "void", NULL, 0 }
+    };
+    static const FunctionDefinition override[] = {
+        { "core::io::print", "ext_print", "void", NULL, 0 }
+    };
+    
+    // Builtins are indexed without explicit registration
+    assert(import_find_function("core::io::print") != NULL);
+    assert(import_is_builtin_module("core::io"));
+    assert(import_is_builtin_module("core"));
+    assert(!import_is_builtin_module("core::i"));
+    
+    assert(import_register_functions(ext_functions, 3));
+    assert(import_find_function("ext::math::square") == &ext_functions[0]);
+    assert(import_function_exists_in_module("ext::math", "cube"));
+    assert(!import_function_exists_in_module("ext::io", "cube"));
+    
+    int count = 0;
+    const FunctionDefinition** functions = import_module_functions("ext::math", &count);
+    assert(functions && count == 2 && functions[0] == &ext_functions[0]);
+    import_module_functions("ext", &count);
+    assert(count == 3);
+    
+    // Re-registering a name replaces the previous definition everywhere
+    assert(import_register_functions(override, 1));
+    assert(import_find_function("core::io::print") == &override[0]);
+    functions = import_module_functions("core::io", &count);
+    assert(functions[0] == &override[0]);
+    
+    // Clearing drops runtime registrations and restores the builtins
+    import_registry_clear();
+    assert(import_find_function("ext::math::square") == NULL);
+    assert(import_find_function("core::io::print") == &BUILTIN_FUNCTIONS[0]);
+    
+    printf("✓ Import registry test passed!\n");
+}
+
+// Analyze source with the import system, as the driver does
+static bool analyze_with_imports(const char* source) {
+    Lexer* lexer = lexer_create(source);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    SemanticContext* semantic = semantic_create();
+    semantic_add_builtin_modules(semantic);
+    bool success = semantic_analyze(semantic, ast) && !semantic_has_errors(semantic);
+    
+    semantic_destroy(semantic);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    return success;
+}
+
+// Register a parsed module, then analyze a module that imports it
+void test_user_modules() {
+    printf("\n🧪 Testing User Modules\n");
+    printf("======================\n");
+    
+    const char* library =
+        "struct Point { i32 x; i32 y; }\n"
+        "fn area(i32 w, i32 h) -> i32 { return w * h; }\n"
+        "fn main() -> i32 { return 0; }\n";
+    
+    Lexer* lexer = lexer_create(library);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    // Non-generic functions except main are exported under the module path,
+    // with the path in their C name
+    assert(import_register_module("geo::shapes", ast));
+    assert(!import_register_module("geo::shapes", ast));
+    assert(import_is_user_module("geo::shapes") && !import_is_user_module("geo"));
+    const FunctionDefinition* area = import_find_function("geo::shapes::area");
+    assert(area && strcmp(area->c_function, "geo_shapes_area") == 0 && area->param_count == 2);
+    assert(strcmp(area->return_type, "i32") == 0 && strcmp(area->param_types[1], "i32") == 0);
+    assert(import_find_function("geo::shapes::main") == NULL);
+    
+    // Importing the module brings its functions and structs
+    assert(analyze_with_imports("#include geo::shapes\n"
+                                "fn main() -> i32 { auto p = Point {x: 2, y: 3}; return shapes::area(p.x, p.y); }"));
+    assert(analyze_with_imports("#include geo::shapes::area as surface\n"
+                                "fn main() -> i32 { return surface(2, 3); }"));
+    assert(!analyze_with_imports("#include geo::shapes\n"
+                                 "fn main() -> i32 { return shapes::volume(2, 3); }"));
+    
+    // Module paths map to files below the search directories
+    assert(import_resolve_module("geo::shapes", NULL, 0) == NULL);
+    const char* search_paths[] = { "/nonexistent", "." };
+    assert(import_resolve_module("../etc", search_paths, 2) == NULL);
+    assert(import_resolve_module("geo::", search_paths, 2) == NULL);
+    
+    // Dropping the user modules keeps native registrations
+    static const FunctionDefinition native[] = {
+        { "ext::io::flush", "ext_flush", "void", NULL, 0 }
+    };
+    assert(import_register_functions(native, 1));
+    import_registry_clear_user_modules();
+    assert(!import_is_user_module("geo::shapes"));
+    assert(import_find_function("geo::shapes::area") == NULL);
+    assert(import_find_function("ext::io::flush") == &native[0]);
+    assert(import_function_exists_in_module("ext::io", "flush"));
+    
+    import_registry_clear();
+    assert(import_find_function("ext::io::flush") == NULL);
+    
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    printf("✓ User modules test passed!\n");
+}
+
+// Modules exporting functions of the same name get distinct C names
+void test_module_c_names() {
+    printf("\n🧪 Testing Module C Names\n");
+    printf("========================\n");
+    
+    const char* paths[] = { "app::util", "app::other" };
+    const char* sources[] = {
+        "fn twice(i32 x) -> i32 { return x * 2; }\n"
+        "fn add(i32 a, i32 b) -> i32 { return twice(a) + b; }\n",
+        "fn add(i32 a, i32 b) -> i32 { return a + b; }\n"
+    };
+    Lexer* lexers[2];
+    Parser* parsers[2];
+    ASTNode* asts[2];
+    for (int i = 0; i < 2; i++) {
+        lexers[i] = lexer_create(sources[i]);
+        parsers[i] = parser_create(lexers[i]);
+        asts[i] = parser_parse(parsers[i]);
+        assert(asts[i] && !parser_has_error(parsers[i]));
+        assert(import_register_module(paths[i], asts[i]));
+    }
+    
+    assert(strcmp(import_module_c_name("app::util", "add"), "app_util_add") == 0);
+    assert(strcmp(import_find_function("app::util::add")->c_function, "app_util_add") == 0);
+    assert(strcmp(import_find_function("app::other::add")->c_function, "app_other_add") == 0);
+    assert(analyze_with_imports("#include app::util\n"
+                                "#include app::other::add as other_add\n"
+                                "fn add(i32 a, i32 b) -> i32 { return a - b; }\n"
+                                "fn main() -> i32 { return util::add(1, 2) + other_add(1, 2) + add(5, 1); }"));
+    
+    // The module's header section, definitions and calls use the same names;
+    // a root that is not imported keeps the plain ones
+    SemanticContext* semantic = semantic_create();
+    semantic_add_builtin_modules(semantic);
+    assert(semantic_analyze(semantic, asts[0]) && !semantic_has_errors(semantic));
+    
+    char* interface = codegen_render_module_interface(semantic->symbol_table, asts[0], "app::util", true);
+    assert(interface && strstr(interface, "int32_t app_util_add(int32_t a, int32_t b);"));
+    free(interface);
+    interface = codegen_render_module_interface(semantic->symbol_table, asts[0], "util", false);
+    assert(interface && strstr(interface, "int32_t add(int32_t a, int32_t b);"));
+    free(interface);
+    
+    CodeGenerator* gen = codegen_create(NULL, semantic->symbol_table);
+    gen->module_path = "app::util";
+    assert(codegen_generate_program(gen, asts[0]) == CODEGEN_SUCCESS && gen->buffer.data);
+    assert(strstr(gen->buffer.data, "int32_t app_util_twice(int32_t x) {"));
+    assert(strstr(gen->buffer.data, "return app_util_twice(a) + b;"));
+    codegen_destroy(gen);
+    
+    semantic_destroy(semantic);
+    import_registry_clear();
+    for (int i = 0; i < 2; i++) {
+        ast_destroy(asts[i]);
+        parser_destroy(parsers[i]);
+        lexer_destroy(lexers[i]);
+    }
+    
+    printf("✓ Module C names test passed!\n");
+}
+
+// Interface files round-trip a module's exports and register like its AST
+void test_module_interfaces() {
+    printf("\n🧪 Testing Module Interface Files\n");
+    printf("================================\n");
+    
+    const char* library =
+        "struct Point { i32 x; i32* y; }\n"
+        "fn area(i32 w, Point? p) -> i32 { return w; }\n"
+        "fn reset() { }\n"
+        "fn twice(auto v) -> auto { return v; }\n"
+        "fn main() -> i32 { return 0; }\n";
+    const char* path = "build/test_module_interface.ei";
+    
+    Lexer* lexer = lexer_create(library);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    assert(module_interface_write(path, ast, 42));
+    
+    // Only another source hash or a damaged file is rejected
+    assert(module_interface_read(path, 41) == NULL);
+    assert(module_interface_read("build/missing.ei", 42) == NULL);
+    ASTNode* program = module_interface_read(path, 42);
+    assert(program && program->child_count == 3);
+    
+    ASTNode* point = program->children[0];
+    assert(point->type == AST_STRUCT && strcmp(point->value, "Point") == 0 && point->child_count == 2);
+    assert(ast_has_flag(point->children[1]->children[0], AST_FLAG_POINTER));
+    
+    // Generic functions and main are not exported; bodies are dropped
+    ASTNode* area = program->children[1];
+    assert(area->type == AST_FUNCTION && strcmp(area->value, "area") == 0 && area->child_count == 2);
+    assert(area->children[0]->child_count == 2 && strcmp(area->children[1]->value, "i32") == 0);
+    assert(ast_has_flag(area->children[0]->children[1]->children[0], AST_FLAG_OPTIONAL));
+    assert(program->children[2]->child_count == 1);
+    
+    assert(import_register_module("geo::shapes", program));
+    const FunctionDefinition* reset = import_find_function("geo::shapes::reset");
+    assert(reset && strcmp(reset->return_type, "void") == 0 && reset->param_count == 0);
+    assert(analyze_with_imports("#include geo::shapes\n"
+                                "fn main() -> i32 { auto p = Point {x: 2, y: null}; return shapes::area(p.x, null); }"));
+    import_registry_clear();
+    
+    // A truncated file is rejected
+    char head[60];
+    FILE* file = fopen(path, "rb");
+    assert(file && fread(head, 1, sizeof(head), file) == sizeof(head));
+    fclose(file);
+    file = fopen(path, "wb");
+    assert(file && fwrite(head, 1, sizeof(head), file) == sizeof(head));
+    fclose(file);
+    assert(module_interface_read(path, 42) == NULL);
+    remove(path);
+    
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    printf("✓ Module interface files test passed!\n");
+}
+
+// Collect nodes of one type in source order
+static int collect_nodes(ASTNode* node, ASTNodeType type, ASTNode** nodes, int count, int max) {
+    if (!node) return count;
+    if (node->type == type && count < max) nodes[count++] = node;
+    for (int i = 0; i < node->child_count; i++) {
+        count = collect_nodes(node->children[i], type, nodes, count, max);
+    }
+    return count;
+}
+
+void test_generic_instantiation_cache() {
+    printf("\n🧪 Testing Generic Instantiation Cache\n");
+    printf("=====================================\n");
+    
+    const char* source =
+        "fn add(auto a, auto b) -> auto { return a + b; }\n"
+        "fn main() -> void {\n"
+        "    auto x = add(1, 2);\n"
+        "    auto y = add(3, 4);\n"
+        "    auto z = add(1.5, 2.5);\n"
+        "}\n";
+    
+    Lexer* lexer = lexer_create(source);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    SemanticContext* semantic = semantic_create();
+    assert(semantic_analyze(semantic, ast));
+    
+    // Equal type tuples share one instantiation, recorded on each call
+    TypeInferenceContext* inference = semantic->type_inference;
+    assert(inference->instantiation_count == 2);
+    
+    ASTNode* calls[8];
+    int count = collect_nodes(ast, AST_CALL, calls, 0, 8);
+    assert(count == 3);
+    assert(type_inference_call_target(calls[0]) != NULL);
+    assert(type_inference_call_target(calls[0]) == type_inference_call_target(calls[1]));
+    assert(type_inference_call_target(calls[0]) != type_inference_call_target(calls[2]));
+    
+    // The cache keeps finding every entry as it grows
+    ASTNode* generic = inference->instantiations->original_function;
+    const char* names[64];
+    char name[16];
+    for (int i = 0; i < 64; i++) {
+        snprintf(name, sizeof(name), "T%d", i);
+        names[i] = intern_string(name);
+        const char* args[2] = { names[i], names[i] };
+        assert(type_inference_instantiate_generic(inference, generic, args, 2) != NULL);
+    }
+    for (int i = 0; i < 64; i++) {
+        const char* args[2] = { names[i], names[i] };
+        GenericInstantiation* inst = type_inference_find_instantiation(inference, generic, args, 2);
+        assert(inst && inst->type_arguments[0] == names[i]);
+    }
+    const char* missing[2] = { names[0], names[1] };
+    assert(type_inference_find_instantiation(inference, generic, missing, 2) == NULL);
+    
+    semantic_destroy(semantic);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    printf("✓ Generic instantiation cache test passed!\n");
+}
+
+void test_expression_type_annotation() {
+    printf("\n🧪 Testing Expression Type Annotation\n");
+    printf("====================================\n");
+    
+    const char* source =
+        "fn main() -> void {\n"
+        "    auto a = (1.5 + 2.5) * (3.5 - 0.5);\n"
+        "    auto b = a;\n"
+        "}\n";
+    
+    Lexer* lexer = lexer_create(source);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    SemanticContext* semantic = semantic_create();
+    assert(semantic_analyze(semantic, ast));
+    
+    // Every operator node carries its type after analysis
+    const char* float_type = intern_string("float");
+    ASTNode* nodes[8];
+    int count = collect_nodes(ast, AST_BINARY_OP, nodes, 0, 8);
+    assert(count == 3);
+    for (int i = 0; i < count; i++) {
+        assert(ast_data_type(nodes[i]) == float_type);
+    }
+    
+    // Identifiers are typed in their own scope
+    count = collect_nodes(ast, AST_IDENTIFIER, nodes, 0, 8);
+    assert(count == 1 && ast_data_type(nodes[0]) == float_type);
+    
+    semantic_destroy(semantic);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    printf("✓ Expression type annotation test passed!\n");
+}
+
+void test_structured_types() {
+    printf("\n🧪 Testing Structured Types\n");
+    printf("==========================\n");
+    
+    // Constructors return one object per distinct type
+    const Type* i32 = type_primitive("i32");
+    assert(i32 && i32 == type_parse("i32"));
+    assert(type_pointer(i32) == type_pointer(type_parse("i32")));
+    assert(type_pointer(i32) != type_optional(i32));
+    assert(type_array(i32, 4) != type_array(i32, 8));
+    assert(type_parse("Node") == type_struct("Node"));
+    assert(type_primitive("Node") == NULL);
+    
+    // Spellings parse into the same structure regardless of whitespace
+    const Type* params[2] = { i32, type_pointer(type_struct("Node")) };
+    const Type* function = type_function(type_primitive("bool"), params, 2);
+    assert(type_parse("fn(i32, Node*) -> bool") == function);
+    assert(type_parse("fn( i32 ,Node * )->bool") == function);
+    assert(strcmp(function->name, "fn(i32, Node*) -> bool") == 0);
+    
+    const Type* nested = type_parse("unique<f64[4]>?");
+    assert(nested->kind == TYPE_OPTIONAL);
+    assert(nested->base->kind == TYPE_UNIQUE_PTR);
+    assert(nested->base->base == type_array(type_primitive("f64"), 4));
+    assert(type_parse("f64[]")->array_size == -1);
+    
+    // Traits, C spellings and instantiation families
+    assert(type_is_numeric(i32) && type_has_trait(i32, TYPE_TRAIT_KEYWORD));
+    assert(!type_has_trait(type_parse("integer"), TYPE_TRAIT_KEYWORD));
+    assert(strcmp(i32->c_name, "int32_t") == 0);
+    assert(strcmp(type_parse("i32*")->c_name, "int32_t*") == 0);
+    assert(strcmp(type_parse("bool?")->c_name, "echo_optional_bool") == 0);
+    assert(i32->family == type_parse("integer"));
+    assert(type_parse("f32")->family == type_parse("f64")->family);
+    
+    printf("✓ Structured types test passed!\n");
+}
+
+void test_struct_field_index() {
+    printf("\n🧪 Testing Struct Field Index\n");
+    printf("=============================\n");
+    
+    const char* source =
+        "struct Point {\n"
+        "    f64 x;\n"
+        "    f64 y;\n"
+        "}\n"
+        "struct Tagged {\n"
+        "    bool tag;\n"
+        "    Point origin;\n"
+        "    i32* next;\n"
+        "}\n";
+    
+    Lexer* lexer = lexer_create(source);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    SemanticContext* semantic = semantic_create();
+    assert(semantic_analyze(semantic, ast));
+    
+    // Fields are found by interned name, with C offsets
+    Symbol* tagged = symbol_table_lookup(semantic->symbol_table, "Tagged");
+    assert(tagged && tagged->layout && tagged->layout->field_count == 3);
+    const StructField* origin = struct_layout_find(tagged->layout, intern_string("origin"));
+    assert(origin && origin->ordinal == 1 && origin->offset == sizeof(double));
+    assert(origin->type == type_struct("Point"));
+    const StructField* next = struct_layout_find(tagged->layout, intern_string("next"));
+    assert(next && next->type == type_pointer(type_primitive("i32")));
+    assert(next->offset == sizeof(double) * 3);
+    assert(tagged->layout->size == sizeof(double) * 3 + sizeof(void*));
+    assert(struct_layout_find(tagged->layout, intern_string("missing")) == NULL);
+    
+    semantic_destroy(semantic);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    test_semantic_analysis("struct Point { f64 x; f64 x; }", "Duplicate Struct Field", false);
+    test_semantic_analysis("struct Point { f64 x; f64 y; }\n"
+                          "fn main() -> void { auto p = Point {x: 1.0, z: 2.0}; }",
+                          "Unknown Struct Literal Field", false);
+    test_semantic_analysis("struct Point { f64 x; f64 y; }\n"
+                          "fn main() -> void { auto p = Point {x: 1.0, y: 2.0}; auto d = p.x; }",
+                          "Struct Field Access", true);
+    
+    printf("✓ Struct field index test passed!\n");
+}
+
+// Analyze source on the given number of threads and describe the outcome:
+// diagnostics in list order, then instantiations in list order
+static void describe_analysis(const char* source, int jobs, char* out, size_t size) {
+    Lexer* lexer = lexer_create(source);
+    Parser* parser = parser_create(lexer);
+    ASTNode* ast = parser_parse(parser);
+    assert(ast && !parser_has_error(parser));
+    
+    SemanticContext* semantic = semantic_create();
+    semantic->jobs = jobs;
+    semantic->lines = &lexer->lines;
+    semantic_analyze(semantic, ast);
+    
+    int length = snprintf(out, size, "%d errors, %d warnings\n", semantic->error_count, semantic->warning_count);
+    for (SemanticError* error = semantic->errors; error && length < (int)size; error = error->next) {
+        length += snprintf(out + length, size - length, "%d:%d %s\n", error->line, error->column, error->message);
+    }
+    GenericInstantiation* inst = semantic->type_inference->instantiations;
+    for (; inst && length < (int)size; inst = inst->next) {
+        length += snprintf(out + length, size - length, "%s\n", inst->mangled_name);
+    }
+    
+    semantic_destroy(semantic);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+}
+
+void test_parallel_function_bodies() {
+    printf("\n🧪 Testing Parallel Function Body Analysis\n");
+    printf("=========================================\n");
+    
+    const char* source =
+        "fn id(auto x) -> auto { return x; }\n"
+        "fn pair(auto a, auto b) -> auto { return a; }\n"
+        "fn f1() -> i32 { auto a = id(1); auto b = missing_a; return 1; }\n"
+        "fn f2() -> i32 { auto a = id(2.5); auto b = pair(1, true); return 2; }\n"
+        "fn f3() -> i32 { auto x = 1; auto x = 2; return 3; }\n"
+        "fn f4() -> i32 { auto a = id(\"s\"); auto b = pair(2.5, 1); return 4; }\n"
+        "fn f5() -> i32 { auto a = missing_b; auto b = id(true); return 5; }\n"
+        "fn f6() -> i32 { auto a = pair(\"s\", \"t\"); auto b = id(1); }\n"
+        "fn f7(i32 p) -> i32 { auto a = p + 1; return a; }\n"
+        "fn main() -> void { auto a = f1(); auto b = id(false); }\n";
+    
+    char serial[4096];
+    char parallel[4096];
+    describe_analysis(source, 1, serial, sizeof(serial));
+    assert(strstr(serial, "missing_a") && strstr(serial, "pair_string_string"));
+    
+    // Same diagnostics and instantiations, in the same order, on any thread count
+    for (int jobs = 2; jobs <= 8; jobs *= 2) {
+        describe_analysis(source, jobs, parallel, sizeof(parallel));
+        assert(strcmp(serial, parallel) == 0);
+    }
+    
+    printf("✓ Parallel function body analysis test passed!\n");
+}
+
 // Main test runner
 int main() {
     printf("🚀 Running Echo Semantic Analysis Tests\n");
@@ -231,6 +749,15 @@ int main() {
     test_function_analysis();
     test_type_checking();
     test_uninitialized_variables();
+    test_import_registry();
+    test_user_modules();
+    test_module_c_names();
+    test_module_interfaces();
+    test_generic_instantiation_cache();
+    test_expression_type_annotation();
+    test_structured_types();
+    test_struct_field_index();
+    test_parallel_function_bodies();
     
     printf("\n🎉 All semantic analysis tests completed!\n");
     printf("Note: Some tests may show warnings - this is expected behavior.\n");